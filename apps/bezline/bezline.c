@@ -66,6 +66,8 @@ void BezLines(int frame)
     float py[4];
     float x[4];
     float y[4];
+    int curve[8];
+    int i;
 
     /* Initialize end points */
     px[0] = 10.0f;
@@ -81,6 +83,12 @@ void BezLines(int frame)
     px[2] = SCREEN_WIDTH / 8.0f * 7.0f;
     py[2] = SCREEN_HEIGHT / 8.0f * (7.0f + frame / 460.0f);
 
+    for (i = 0; i < 4; ++i)
+    {
+        curve[i * 2] = px[i];
+        curve[i * 2 + 1] = py[i];
+    }
+
     /* Clear the screen so we start with a fresh canvas (no smudgies). */
     SetColor(COLOR_BLACK);
     FillScreen();
@@ -127,6 +135,10 @@ void BezLines(int frame)
         DrawLine(u[0], v[0], u[1], v[1]);
     }
 
+    /* Draw the curve itself, which the lines should hug */
+    SetColor(COLOR_WHITE);
+    DrawBezier(curve);
+
     ShowGraphics();
 }
 
@@ -49,14 +49,42 @@ static void getVector(float *x, float *y, float index, float total)
     angleVector(x, y, angle + M_PI, radius);
 }
 
+/* Lines waiting to be drawn, all at once, by flushLines() */
+enum {
+    MAX_LINES = 1024
+};
+static struct LineSeg lines[MAX_LINES];
+static u8 hsv[MAX_LINES * 3];
+static u32 colors[MAX_LINES];
+static size_t numLines;
+
+static void flushLines(void)
+{
+    HSVToSurfaceColors(hsv, colors, numLines);
+    DrawLinesColors(lines, colors, numLines);
+    numLines = 0;
+}
+
 static void drawHueShiftLine(int x0, int y0, int x1, int y1, float t)
 {
     static float base = 0.0f;
+    struct LineSeg *line;
     float hue;
 
+    if (numLines == MAX_LINES)
+    {
+        flushLines();
+    }
+
     hue = wrapf(base + t * 256.0f, 256.0f);
-    SetColorHSV(hue, 255, 255);
-    DrawLine(x0, y0, x1, y1);
+    hsv[numLines * 3] = (u8)hue;
+    hsv[numLines * 3 + 1] = 255;
+    hsv[numLines * 3 + 2] = 255;
+    line = &lines[numLines++];
+    line->x1 = x0;
+    line->y1 = y0;
+    line->x2 = x1;
+    line->y2 = y1;
 
     base += 0.00001f;
     /* Keep base low magnitude so we don't end up not being able to increment.
@@ -195,6 +223,7 @@ void Cardioid(int frame)
         py[3] += SCREEN_HEIGHT / 2;
         drawBezier(px, py);
     }
+    flushLines();
 
     SetColor(COLOR_WHITE);
     DrawCircle(SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2, radius);
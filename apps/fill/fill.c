@@ -23,11 +23,25 @@ int main(void)
 
     printf("Hello world\n");
 
-    /* Display a blue screen for about 2 seconds. */
+    /* Draw some outlines on a blue screen, and fill them in. */
     SetColor(COLOR_BLUE);
+    FillScreen();
+    SetColor(COLOR_WHITE);
+    DrawCircle(200, 240, 120);
+    DrawCircle(200, 240, 60);
+    DrawRoundRect(360, 120, 24, 200, 240);
+    DrawLine(360, 120, 560, 360);
+
+    SetColor(COLOR_ORANGE);
+    FloodFill(200, 150);
+    SetColor(COLOR_YELLOW);
+    BoundaryFill(400, 300, COLOR_WHITE);
+    SetColor(COLOR_GREEN);
+    FloodFill(0, 0);
+
+    /* Display it for about 2 seconds. */
     for(i = 0; i < 60 * 2; ++i)
     {
-        FillScreen();
         ShowGraphics();
     }
     SaveScreenShot("fill.bmp");
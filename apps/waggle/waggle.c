@@ -10,6 +10,7 @@
 #include "guikit/prandom.h"
 #include "guikit/primrect.h"
 #include "guikit/panic.h"
+#include "guikit/shade.h"
 #include <stdio.h>
 
 #include <math.h>
@@ -38,12 +39,16 @@ static float wrapf(float a, float max)
     return a - floor(a / max) * max;
 }
 
-static int wagglesamp(int x, int y, int t)
+/* Fill in a row of hues, starting from (x0, y), at time t. Everything but the
+ * horizontal position depends only on the row, so is worked out just once per
+ * row. */
+static void waggleRow(unsigned char *hues, int x0, int y, int width, int t)
 {
     int tex;
 
     float u;
     float v;
+    double du;
 
     int palShift; /* Palette shift */
 
@@ -52,6 +57,8 @@ static int wagglesamp(int x, int y, int t)
     float p[2]; /* Phase */
     float s[2]; /* Linear Scroll */
 
+    int i;
+
     palShift = 3;
 
     f[0] = 1.0f / (5.0f * M_PI);
@@ -64,37 +71,42 @@ static int wagglesamp(int x, int y, int t)
     p[1] = 0.2f;
     s[1] = 2.0f;
 
-    u = x;
 #if DUAL_WAVE
     if (y % 2 == 0)
     {
-        u += a[0] * sin(f[0] * y + p[0] * t);
+        du = a[0] * sin(f[0] * y + p[0] * t);
     }
     else
     {
-        u -= a[0] * sin(f[0] * y + p[0] * t);
+        du = -a[0] * sin(f[0] * y + p[0] * t);
     }
 #else
-    u += a[0] * sin(f[0] * y + p[0] * t);
+    du = a[0] * sin(f[0] * y + p[0] * t);
 #endif
-    u -= s[0] * t;
-    u = wrapf(u, 256.0f);
 
     v = y;
     v += a[1] * sin(f[1] * y + p[1] * t);
     v -= s[1] * t;
     v = wrapf(v, 256.0f);
 
-    tex = tex256(u, v);
+    for (i = 0; i < width; ++i)
+    {
+        u = x0 + i;
+        u += du;
+        u -= s[0] * t;
+        u = wrapf(u, 256.0f);
 
-    /* Palette shift */
-    tex += t * palShift;
-    tex %= 256;
+        tex = tex256(u, v);
 
-    return tex;
+        /* Palette shift */
+        tex += t * palShift;
+        tex %= 256;
+
+        hues[i] = tex;
+    }
 }
 
-void RainbowWaggle(int frame)
+static void waggleHues(int x, int y, int width, void *out, void *ctx)
 {
     enum {
 #if CHONKY_LOOK
@@ -102,36 +114,38 @@ void RainbowWaggle(int frame)
         w = 2,
         h = 2
 #else
-        /* Use 1x1 pixels for a finer appearance, even though using rectangle
-         * drawing functions for 1x1 pixels is a bit silly. */
+        /* Use 1x1 pixels for a finer appearance. */
         w = 1,
         h = 1
 #endif
     };
-    unsigned int i;
-    unsigned int j;
-    struct Rect rect;
-    NormalizedRect(&rect, &rect);
+    const int *frame = ctx;
+    unsigned char *hues = out;
+    unsigned char row[SCREEN_WIDTH];
+    int i;
 
-    rect.top = 0;
-    rect.bottom = h;
+    if (w == 1)
+    {
+        waggleRow(hues, x, y / h, width, *frame);
+        return;
+    }
 
-    for (j = 0; j < SCREEN_HEIGHT; ++j)
+    /* Sample at the fat pixel size, then widen. */
+    waggleRow(row, x / w, y / h, width / w + 1, *frame);
+    for (i = 0; i < width; ++i)
     {
-        rect.left = 0;
-        rect.right = w;
-
-        for (i = 0; i < SCREEN_WIDTH; ++i)
-        {
-            SetColorHSV(wagglesamp(i, j, frame), 255, 255);
-            FillRect(&rect);
-            rect.left += w;
-            rect.right += w;
-            NormalizedRect(&rect, &rect);
-        }
-        rect.top += h;
-        rect.bottom += h;
+        hues[i] = row[(x + i) / w - x / w];
     }
+}
+
+void RainbowWaggle(int frame)
+{
+    struct Rect rect;
+
+    /* Rows are independent, so they can be worked out on every CPU at
+     * once. */
+    InitRect(&rect, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+    RenderPerRow(&rect, PIXEL_FORMAT_HSV8, waggleHues, &frame);
 
     ShowGraphics();
 }
@@ -147,6 +161,9 @@ int main(void)
         panic("Couldn't init graphics\n");
     }
 
+    /* Each pixel takes a while, so use every CPU. */
+    SetRenderThreads(0);
+
     printf("Waggling...\n");
     for (i = 0; i < 60 * 1; ++i)
     {
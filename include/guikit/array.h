@@ -41,7 +41,7 @@ static size_t array_cap(const void *a);
  */
 
 /* LCOV_EXCL_START */
-void arrayUnusedFunctionWarningEliminator(void)
+static void arrayUnusedFunctionWarningEliminator(void)
 {
     /* To avoid warnings like:
      *
@@ -50,7 +50,9 @@ void arrayUnusedFunctionWarningEliminator(void)
      *
      *  cast the functions to void in a dummy function. We don't know of a
      *  better portable way to do this, as how to selectively turn off warnings
-     *  is compiler-specific.
+     *  is compiler-specific. The dummy function is static, so that every file
+     *  including this can have one without clashing when linked together;
+     *  array_len() refers back to it, so that it isn't unused either.
      */
     (void)array_cap;
     (void)array_len;
@@ -75,6 +77,8 @@ struct array_header {
  * contains) */
 static size_t array_len(const void *a)
 {
+    (void)arrayUnusedFunctionWarningEliminator;
+
     if (a == NULL)
     {
         return 0;
@@ -0,0 +1,46 @@
+/**
+ *  @file damage.h
+ *  @brief Damage
+ *
+ *  Patater GUI Kit
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef DAMAGE_H
+#define DAMAGE_H
+
+#include <stddef.h>
+
+struct Rect;
+
+/* Every drawing operation records the area of the screen it touched. The
+ * areas are kept as a short list of non-overlapping rectangles, so that only
+ * what changed needs to be presented. When the list would grow past
+ * MAX_DAMAGE_RECTS, the two closest areas are merged into one bigger one. */
+enum {
+    MAX_DAMAGE_RECTS = 16
+};
+
+/* Set the area damage is clipped to (usually, the whole screen). This also
+ * clears any damage. */
+void SetDamageBounds(const struct Rect *bounds);
+
+/* Also clip damage to rect, which is within the bounds, until it's set again.
+ * Drawing can't reach outside the clip rect, so neither can damage. Damage
+ * already added is kept. */
+void SetDamageClip(const struct Rect *rect);
+
+void AddDamage(const struct Rect *rect);
+
+/* Damage all of the bounds, whatever the clip rect. */
+void AddDamageAll(void);
+
+/* Return the list of damaged rectangles since the last ClearDamage(), and
+ * store how many there are in num. */
+const struct Rect *GetDamage(size_t *num);
+
+/* ShowGraphics() consumes the damage when it presents. */
+void ClearDamage(void);
+
+#endif
@@ -0,0 +1,43 @@
+/**
+ *  @file dlist.h
+ *  @brief Display lists
+ *
+ *  Patater GUI Kit
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef DLIST_H
+#define DLIST_H
+
+#include <stddef.h>
+
+/* A display list is a recording of drawing calls (from graphics.h, and
+ * DrawString()) that can be played back again and again, such as for parts of
+ * the screen that look the same every frame. Each call is recorded along with
+ * the pen color it would have drawn with. Bitmaps, masks, patterns, and fonts
+ * are recorded by reference, so they must outlive the list. */
+struct DisplayList;
+
+struct DisplayList *NewDisplayList(void);
+void FreeDisplayList(struct DisplayList *list);
+
+/* Throw away whatever list had in it, and start recording into it. Until
+ * EndDisplayList(), drawing calls are only recorded, not drawn. Setting the
+ * pen color still takes effect. */
+void BeginDisplayList(struct DisplayList *list);
+
+/* Stop recording. Fills of the same color that line up are merged here, once,
+ * so every playback gets the benefit. */
+void EndDisplayList(void);
+
+/* Play back the list. The pen is left with the color of the last command.
+ * Executing a list while recording another records the list's commands into
+ * the other. */
+void ExecuteDisplayList(const struct DisplayList *list);
+
+/* Return how many commands are in the list. Runs of glyphs from the same font
+ * in the same color count as one. */
+size_t DisplayListLength(const struct DisplayList *list);
+
+#endif
@@ -10,9 +10,14 @@
 #ifndef GRAPHICS_H
 #define GRAPHICS_H
 
+#include "guikit/ptypes.h"
+#include <stddef.h>
+
 struct Rect;
 
-/* VGA resolution (in Mode 0x12) */
+/* VGA resolution (in Mode 0x12), used by InitGraphics() and
+ * InitGraphicsBGR555(). Other sizes can be had with InitGraphicsEx(); use
+ * GetScreenWidth() and GetScreenHeight() to find out what was picked. */
 enum {
     SCREEN_WIDTH = 640,
     SCREEN_HEIGHT = 480
@@ -39,6 +44,20 @@ enum {
     NUM_COLORS
 };
 
+/* Indexed screens have a palette of this many entries, the first NUM_COLORS
+ * of which start off as the COLOR_* colors. */
+enum {
+    PALETTE_SIZE = 256
+};
+
+/* A palette entry */
+struct RGB
+{
+    u8 r;
+    u8 g;
+    u8 b;
+};
+
 /* Drawing operations */
 enum {
     OP_NONE,
@@ -53,8 +72,55 @@ enum {
     NUM_OP
 };
 
+/* Pixel formats of the framebuffer */
+enum {
+    PIXEL_FORMAT_INDEX8,
+    PIXEL_FORMAT_BGR555,
+    PIXEL_FORMAT_XRGB8888, /* 32-bit, with blue in the least significant byte */
+    NUM_PIXEL_FORMATS,
+
+    /* Only for DrawPixelArray() sources: a byte of hue per pixel, drawn as
+     * with SetColorHSV(hue, 255, 255) */
+    PIXEL_FORMAT_HSV8 = NUM_PIXEL_FORMATS
+};
+
+/* Rules for FillPolygon() */
+enum {
+    FILL_EVEN_ODD, /* Inside where crossing an odd number of edges */
+    FILL_NONZERO /* Inside where edges wind around other than zero times */
+};
+
+/* Flags for struct GraphicsMode */
+enum {
+    GRAPHICS_FULLSCREEN = 1 << 0,
+    GRAPHICS_NO_VSYNC = 1 << 1, /* As with PRESENT_NO_VSYNC */
+    GRAPHICS_NO_PRESENT = 1 << 2, /* As with PRESENT_NEVER */
+
+    /* Draw into one framebuffer while another is presented on a separate
+     * thread, so ShowGraphics() only has to swap them. Not every platform
+     * lets rendering happen off the main thread, so this is opt in. */
+    GRAPHICS_ASYNC_PRESENT = 1 << 3
+};
+
+struct GraphicsMode
+{
+    int width;
+    int height;
+    int format; /* One of PIXEL_FORMAT_* */
+    const char *title; /* Window title, or NULL for the default */
+    int flags; /* Any of GRAPHICS_* */
+};
+
 int InitGraphics(void);
 int InitGraphicsBGR555(const char *name);
+
+/* Initialize graphics with the given size and pixel format. The presentation
+ * flags override any policy from present.h; without them, that policy is left
+ * alone. Returns non-zero if the backend can't provide the mode. */
+int InitGraphicsEx(const struct GraphicsMode *mode);
+
+int GetScreenWidth(void);
+int GetScreenHeight(void);
 void FreeGraphics(void);
 
 /* Some graphics implementations render to a buffer and then copy to the screen
@@ -63,6 +129,20 @@ void FreeGraphics(void);
  * function may not do too much. */
 void ShowGraphics(void);
 
+/* Return the framebuffer that is being drawn into, along with its pitch (in
+ * bytes) and pixel format (one of the PIXEL_FORMAT_* values). Returns NULL if
+ * the backend doesn't render to memory we can get at. With
+ * GRAPHICS_ASYNC_PRESENT, this changes with every ShowGraphics(). */
+void *GetFrameBuffer(int *pitch, int *format);
+
+/* Choose how many threads drawing may use (1 by default), or 0 for one per
+ * CPU. ExecuteDisplayList() cuts the screen into tiles, each drawn by
+ * whichever thread gets to it first with the list's commands in order;
+ * commands that can't be split up that way (such as bitmaps) are drawn in
+ * between by the calling thread. RenderPerPixel() shares out rows. The result
+ * is the same either way, pixel for pixel. */
+void SetRenderThreads(int threads);
+
 void SetColor(int color);
 void SetColorRGB(unsigned char r, unsigned char g, unsigned char b);
 void SetColorHSV(unsigned char h, unsigned char s, unsigned char v);
@@ -70,8 +150,38 @@ void SetBGColor(int color);
 void SetBGColorRGB(unsigned char r, unsigned char g, unsigned char b);
 void SetBGColorHSV(unsigned char h, unsigned char s, unsigned char v);
 
+/* Change count palette entries of an indexed screen, starting from first.
+ * Pixels already on screen change color with their entries at the next
+ * ShowGraphics(), without being drawn again, which makes for cheap color
+ * cycling. Returns non-zero if the screen isn't indexed or the entries don't
+ * fit in the palette. */
+int SetPaletteEntries(int first, int count, const struct RGB *colors);
+
+/* Read count palette entries of an indexed screen, starting from first.
+ * Returns non-zero if the screen isn't indexed or the entries don't fit in
+ * the palette. */
+int GetPaletteEntries(int first, int count, struct RGB *colors);
+
+/* Rotate count palette entries, starting from first, step places towards the
+ * end (or back towards first, for negative steps). Entries going off one end
+ * come back in at the other. */
+int RotatePalette(int first, int count, int step);
+
+/* Convert n colors, stored as 3 bytes each (hue, saturation, value), to the
+ * pixel values SetColorHSV() would draw them with in GetFrameBuffer()'s
+ * format. Much quicker than setting each color in turn. */
+void HSVToSurfaceColors(const u8 *hsv, u32 *out, size_t n);
+
 int SaveScreenShot(const char *path);
 
+/* Only draw within rect, and within any clip rects already pushed, until the
+ * matching PopClipRect(). Drawing that falls entirely outside is skipped
+ * before any pixels are touched, so widgets scrolled out of view cost little.
+ * Up to MAX_CLIP_DEPTH - 1 (from primrect.h) clip rects can be pushed at
+ * once. */
+void PushClipRect(const struct Rect *rect);
+void PopClipRect(void);
+
 void FillScreen(void);
 
 void DrawRect(const struct Rect *rect);
@@ -83,6 +193,61 @@ void DrawHorizLine(int x1, int y1, int len);
 void DrawDiagLine(int x1, int y1, int x2, int len);
 void DrawLine(int x1, int y1, int x2, int y2);
 
+/* A line from (x1, y1) to (x2, y2), for DrawLines() */
+struct LineSeg
+{
+    int x1;
+    int y1;
+    int x2;
+    int y2;
+};
+
+/* Draw n shapes with the pen, as with calling FillRect() or DrawLine() for
+ * each, but with clipping and damage worked out once for the whole batch. */
+void FillRects(const struct Rect *rects, size_t n);
+void DrawLines(const struct LineSeg *lines, size_t n);
+
+/* Draw lines joining up n points, stored as x, y pairs in xy. */
+void DrawPolyline(const int *xy, size_t n);
+
+/* Draw a cubic Bezier curve from the first of 4 points, stored as x, y pairs
+ * in xy, to the last, pulled towards the middle two. The curve is split into
+ * lines no more than a quarter of a pixel from it, the fewer the flatter it
+ * is, and drawn with DrawPolyline(). */
+void DrawBezier(const int *xy);
+
+/* Draw n cubic Bezier curves, each starting where the one before ended. xy
+ * holds 3 * n + 1 points: the start, then two control points and an end for
+ * each curve. Coordinates can be off the screen, but must be within a few
+ * million of it. */
+void DrawBezierPath(const int *xy, size_t n);
+
+/* As FillRects() and DrawLines(), but with a color for each shape instead of
+ * the pen. Colors are pixel values in GetFrameBuffer()'s format, such as
+ * HSVToSurfaceColors() makes. Display lists keep rects or lines and colors,
+ * not copies of them. */
+void FillRectsColors(const struct Rect *rects, const u32 *colors, size_t n);
+void DrawLinesColors(const struct LineSeg *lines, const u32 *colors,
+                     size_t n);
+
+/* Fill the polygon joining up n points, stored as x, y pairs in xy, with the
+ * last joined back to the first. Pixels are filled where their centers are
+ * inside by rule (one of FILL_*), so a polygon around a rect's corners fills
+ * the same pixels as FillRect(). Edges may cross, and coordinates can be off
+ * the screen, but must be within a few million of it. Display lists keep xy,
+ * not a copy of it. */
+void FillPolygon(const int *xy, size_t n, int rule);
+
+/* Fill the area around (x, y) with the pen: every pixel that can be reached
+ * from it going up, down, left, and right, through pixels the color it was.
+ * BoundaryFill() goes through any pixels that aren't borderColor (one of
+ * COLOR_*) or the pen's color instead. Only pixels within the clip rect are
+ * filled. These work from what's already in the framebuffer, so display lists
+ * draw them in order on the calling thread. Returns non-zero if the backend
+ * can't read back its framebuffer. */
+int FloodFill(int x, int y);
+int BoundaryFill(int x, int y, int borderColor);
+
 void DrawCircle(int x0, int y0, int radius);
 void FillCircle(int x0, int y0, int radius);
 
@@ -101,4 +266,12 @@ int BlitOp(const unsigned char *img, int op, const struct Rect *dst0,
 int BlitWithMask(const unsigned char *img, const unsigned char *mask,
                  const struct Rect *dst, const struct Rect *src, int span);
 
+/* Copy a caller's buffer of pixels into dst, converting from srcFormat (one
+ * of the PIXEL_FORMAT_* values) to the framebuffer's format. src is the pixel
+ * for the top left of dst, and srcPitch the bytes from one row to the next.
+ * INDEX8 pixels are COLOR_* values. Returns non-zero if the backend can't
+ * convert from srcFormat. Display lists keep src, not a copy of it. */
+int DrawPixelArray(const struct Rect *dst, const void *src, int srcPitch,
+                   int srcFormat);
+
 #endif
@@ -0,0 +1,39 @@
+/**
+ *  @file present.h
+ *  @brief Present
+ *
+ *  Patater GUI Kit
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef PRESENT_H
+#define PRESENT_H
+
+/* How ShowGraphics() gets what was drawn onto the display */
+enum {
+    PRESENT_VSYNC, /* Wait for vertical sync (the default) */
+    PRESENT_NO_VSYNC, /* Don't wait; useful for measuring throughput */
+    PRESENT_NEVER, /* Only render, never show anything */
+    NUM_PRESENT_POLICIES
+};
+
+/* Choose a presentation policy, and to only present every interval frames.
+ * Call before InitGraphics(); vsync can't change after the renderer is made.
+ * If this isn't called, the GUIKIT_PRESENT environment variable is used (as
+ * for ParsePresentPolicy()), and failing that, vsync every frame. */
+void SetPresentPolicy(int policy, int interval);
+
+/* Set the presentation policy from a string, such as from the command line.
+ * The string is one of "vsync", "novsync", or "never", optionally followed by
+ * ":N" to present only every Nth frame (e.g. "novsync:10"). Returns 0 on
+ * success, or non-zero if the string isn't understood. */
+int ParsePresentPolicy(const char *s);
+
+/* Return the presentation policy, and store the interval in interval. */
+int GetPresentPolicy(int *interval);
+
+/* Count a frame, and return non-zero if it should be presented. */
+int ShouldPresent(void);
+
+#endif
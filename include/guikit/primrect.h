@@ -40,6 +40,9 @@ void ConvertRect(const struct Rect *rect, int *x, int *y, int *w, int *h);
 
 int RectUnion(const struct Rect *a, const struct Rect *b,
               struct Rect *u);
+/* Grow rect to take in r too. Unlike RectUnion(), rects only one pixel wide
+ * or tall count. */
+void GrowRect(struct Rect *rect, const struct Rect *r);
 int RectIntersect(const struct Rect *a, const struct Rect *b,
                   struct Rect *i);
 
@@ -49,4 +52,28 @@ int ClipRect(struct Rect *rect, const struct Rect *clip);
 int ClipRectAdjust(struct Rect *dst, struct Rect *src,
                    const struct Rect *clip);
 
+/* Clip stacks */
+
+enum {
+    MAX_CLIP_DEPTH = 32
+};
+
+/* A stack of clip rects, each one within all of those below it */
+struct ClipStack {
+    struct Rect rects[MAX_CLIP_DEPTH];
+    int depth; /* How many rects are on the stack */
+};
+
+/* Start the stack off with just bounds on it. */
+void InitClipStack(struct ClipStack *stack, const struct Rect *bounds);
+
+/* Push rect, clipped to the top of the stack, and return the new top. If rect
+ * doesn't overlap the top, the new top is inside out, which ClipRect()
+ * rejects everything against. Returns NULL if the stack is full. */
+const struct Rect *PushClip(struct ClipStack *stack, const struct Rect *rect);
+
+/* Pop the top rect, and return the one under it. Returns NULL if there's only
+ * the bounds left to pop. */
+const struct Rect *PopClip(struct ClipStack *stack);
+
 #endif
@@ -0,0 +1,34 @@
+/**
+ *  @file shade.h
+ *  @brief Per-pixel shading
+ *
+ *  Patater GUI Kit
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef SHADE_H
+#define SHADE_H
+
+struct Rect;
+
+/* Return the color of screen pixel (x, y), in the pixel format given to
+ * RenderPerPixel(). */
+typedef unsigned long (*color_fn)(int x, int y, void *ctx);
+
+/* Write the colors of width screen pixels, starting from (x, y) and going
+ * right, to out in the pixel format given to RenderPerRow(). */
+typedef void (*row_fn)(int x, int y, int width, void *out, void *ctx);
+
+/* Fill area by calling fn for each of its pixels on screen, converting what
+ * it returns from format (one of the PIXEL_FORMAT_* values) as with
+ * DrawPixelArray(). Rows are shared out between the threads chosen with
+ * SetRenderThreads(), so fn may be called from several threads at once, in
+ * any order. Returns non-zero if the backend can't convert from format. */
+int RenderPerPixel(const struct Rect *area, int format, color_fn fn,
+                   void *ctx);
+
+/* Like RenderPerPixel(), but fn fills in a whole row of pixels at a time. */
+int RenderPerRow(const struct Rect *area, int format, row_fn fn, void *ctx);
+
+#endif
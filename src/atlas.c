@@ -0,0 +1,321 @@
+/*
+ *  atlas.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "atlas.h"
+
+#include "raster.h"
+#include "guikit/damage.h"
+#include "guikit/graphics.h"
+#include "guikit/pmemory.h"
+#include "guikit/primrect.h"
+#include "guikit/ptypes.h"
+#include <stddef.h>
+
+#define ATLAS_BUDGET (1024UL * 1024UL) /* Bytes of atlas pixels to keep */
+
+enum {
+    MAX_ATLASES = 32
+};
+
+struct Atlas
+{
+    const unsigned char *img; /* NULL when this slot is unused */
+    int span;
+    int height;
+    int format;
+    u32 color;
+    u32 key; /* Pixels of this value are transparent */
+    unsigned long lastUsed;
+    size_t size;
+    int pitch;
+    u8 *pixels;
+};
+
+static struct Atlas atlases[MAX_ATLASES];
+static size_t atlasBytes;
+static unsigned long useCount;
+
+/* Atlases used since this aren't evicted, or 0 if none are held. */
+static unsigned long heldSince;
+
+static void freeAtlas(struct Atlas *a)
+{
+    pfree(a->pixels);
+    atlasBytes -= a->size;
+    a->img = NULL;
+    a->pixels = NULL;
+}
+
+/* Make room for size more bytes, evicting the least recently used atlases.
+ * Returns a free slot, or NULL if every slot is held. */
+static struct Atlas *makeRoom(size_t size)
+{
+    struct Atlas *slot;
+    int i;
+
+    for (;;)
+    {
+        struct Atlas *oldest;
+
+        slot = NULL;
+        oldest = NULL;
+        for (i = 0; i < MAX_ATLASES; ++i)
+        {
+            struct Atlas *a = &atlases[i];
+
+            if (!a->img)
+            {
+                slot = a;
+            }
+            else if ((!heldSince || a->lastUsed < heldSince) &&
+                     (!oldest || a->lastUsed < oldest->lastUsed))
+            {
+                oldest = a;
+            }
+        }
+
+        /* Go over budget rather than evict a held atlas. */
+        if (slot && (atlasBytes + size <= ATLAS_BUDGET || !oldest))
+        {
+            return slot;
+        }
+        if (!oldest)
+        {
+            return NULL;
+        }
+
+        freeAtlas(oldest);
+    }
+}
+
+static void expand(struct Atlas *a)
+{
+    const struct SpanWriter *spans;
+    struct Raster r;
+    int spanBytes;
+    int x;
+    int y;
+
+    spanBytes = (a->span + 7) / 8; /* Convert to bytes */
+
+    r.pixels = a->pixels;
+    r.pitch = a->pitch;
+    r.format = a->format;
+    spans = spanWriter(a->format);
+
+    /* OP_SRC_INV draws wherever the bitmap is clear, so write runs of clear
+     * bits with the pen color and runs of set bits with the key. */
+    for (y = 0; y < a->height; ++y)
+    {
+        const unsigned char *row = &a->img[y * spanBytes];
+
+        x = 0;
+        while (x < a->span)
+        {
+            int set = row[x / 8] & (0x80 >> (x % 8));
+            int start = x;
+
+            do
+            {
+                ++x;
+            } while (x < a->span &&
+                     !(row[x / 8] & (0x80 >> (x % 8))) == !set);
+
+            r.color = set ? a->key : a->color;
+            spans->hline(&r, start, y, x - start);
+        }
+    }
+}
+
+const struct Atlas *atlasGet(const unsigned char *img, int span, int height)
+{
+    struct Atlas *a;
+    int bpp;
+    size_t size;
+    int i;
+
+    for (i = 0; i < MAX_ATLASES; ++i)
+    {
+        a = &atlases[i];
+        if (a->img == img && a->span == span && a->height == height &&
+            a->format == screenRaster.format &&
+            a->color == screenRaster.color)
+        {
+            a->lastUsed = ++useCount;
+            return a;
+        }
+    }
+
+    bpp = bytesPerPixel(screenRaster.format);
+    size = (size_t)span * height * bpp;
+    if (size > ATLAS_BUDGET)
+    {
+        return NULL;
+    }
+
+    a = makeRoom(size);
+    if (!a)
+    {
+        return NULL;
+    }
+    a->pixels = pmalloc(size);
+    a->img = img;
+    a->span = span;
+    a->height = height;
+    a->format = screenRaster.format;
+    a->color = screenRaster.color;
+    a->key = screenRaster.color ^ 1;
+    a->lastUsed = ++useCount;
+    a->size = size;
+    a->pitch = span * bpp;
+    atlasBytes += size;
+
+    expand(a);
+
+    return a;
+}
+
+void atlasDraw(const struct Raster *base, const struct Atlas *a,
+               const struct Rect *dst0, const struct Rect *src0)
+{
+    struct Rect dst;
+    struct Rect src;
+    int width;
+    int x;
+    int y;
+
+    dst = *dst0;
+    src = *src0;
+    if (ClipRectAdjust(&dst, &src, &base->clip) == CLIP_REJECTED)
+    {
+        return;
+    }
+
+    width = dst.right - dst.left + 1;
+    for (y = 0; y <= dst.bottom - dst.top; ++y)
+    {
+        const u8 *s = &a->pixels[(src.top + y) * a->pitch];
+        u8 *d = &base->pixels[(dst.top + y) * base->pitch];
+
+        if (a->format == PIXEL_FORMAT_INDEX8)
+        {
+            const u8 *sp = s + src.left;
+            u8 *dp = d + dst.left;
+            u8 key = (u8)a->key;
+
+            for (x = 0; x < width; ++x)
+            {
+                if (sp[x] != key)
+                {
+                    dp[x] = sp[x];
+                }
+            }
+        }
+        else if (a->format == PIXEL_FORMAT_XRGB8888)
+        {
+            const u32 *sp = (const u32 *)s + src.left;
+            u32 *dp = (u32 *)d + dst.left;
+
+            for (x = 0; x < width; ++x)
+            {
+                if (sp[x] != a->key)
+                {
+                    dp[x] = sp[x];
+                }
+            }
+        }
+        else
+        {
+            const u16 *sp = (const u16 *)s + src.left;
+            u16 *dp = (u16 *)d + dst.left;
+            u16 key = (u16)a->key;
+
+            for (x = 0; x < width; ++x)
+            {
+                if (sp[x] != key)
+                {
+                    dp[x] = sp[x];
+                }
+            }
+        }
+    }
+}
+
+int atlasBlit(const unsigned char *img, int span, int height,
+              const struct Rect *dst, const struct Rect *src)
+{
+    const struct Atlas *a;
+
+    a = atlasGet(img, span, height);
+    if (!a)
+    {
+        return -1;
+    }
+
+    AddDamage(dst);
+    atlasDraw(&screenRaster, a, dst, src);
+
+    return 0;
+}
+
+int atlasBlitRun(const unsigned char *img, int span, int height,
+                 const struct Rect *rects, size_t num)
+{
+    const struct Atlas *a;
+    size_t i;
+
+    a = atlasGet(img, span, height);
+    if (!a)
+    {
+        return -1;
+    }
+
+    for (i = 0; i < num; ++i)
+    {
+        AddDamage(&rects[i * 2]);
+        atlasDraw(&screenRaster, a, &rects[i * 2], &rects[i * 2 + 1]);
+    }
+
+    return 0;
+}
+
+void atlasForget(const unsigned char *img)
+{
+    int i;
+
+    for (i = 0; i < MAX_ATLASES; ++i)
+    {
+        if (img && atlases[i].img == img)
+        {
+            freeAtlas(&atlases[i]);
+        }
+    }
+}
+
+void atlasHold(void)
+{
+    heldSince = useCount + 1;
+}
+
+void atlasRelease(void)
+{
+    heldSince = 0;
+}
+
+void atlasFlush(void)
+{
+    int i;
+
+    for (i = 0; i < MAX_ATLASES; ++i)
+    {
+        if (atlases[i].img)
+        {
+            freeAtlas(&atlases[i]);
+        }
+    }
+}
@@ -0,0 +1,55 @@
+/*
+ *  atlas.h
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef ATLAS_H
+#define ATLAS_H
+
+#include <stddef.h>
+
+struct Atlas;
+struct Raster;
+struct Rect;
+
+/* Glyph atlases are copies of a font's 1bpp bitmap, already colored in with
+ * the pen color in the screen's pixel format. Drawing a glyph is then a
+ * straight copy out of the atlas. Atlases are kept around, least recently used
+ * first out, within a memory budget. */
+
+/* Draw part of img (a span pixel wide and height pixel tall 1bpp bitmap) like
+ * BlitOp() with OP_SRC_INV would. Returns 0 on success, or non-zero if the
+ * backend doesn't keep atlases, in which case use BlitOp() instead. */
+int atlasBlit(const unsigned char *img, int span, int height,
+              const struct Rect *dst, const struct Rect *src);
+
+/* Like atlasBlit(), for num glyphs from the same img. rects holds a dst and
+ * src rect for each glyph, one after the other. */
+int atlasBlitRun(const unsigned char *img, int span, int height,
+                 const struct Rect *rects, size_t num);
+
+/* Get the atlas for img in the current pen color, making it if need be.
+ * Returns NULL if the backend doesn't keep atlases or there's no room. */
+const struct Atlas *atlasGet(const unsigned char *img, int span, int height);
+
+/* Draw part of an atlas into base, clipped to base's clip rect, without
+ * adding damage. Only reads the atlas, so can be called from many threads at
+ * once. */
+void atlasDraw(const struct Raster *base, const struct Atlas *a,
+               const struct Rect *dst, const struct Rect *src);
+
+/* Between these, atlases that get used aren't evicted, so pointers from
+ * atlasGet() stay good. */
+void atlasHold(void);
+void atlasRelease(void);
+
+/* Throw away any atlases made from img, as it's about to go away. */
+void atlasForget(const unsigned char *img);
+
+/* Throw away all atlases. */
+void atlasFlush(void);
+
+#endif
@@ -0,0 +1,207 @@
+/*
+ *  bezier.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "guikit/graphics.h"
+
+#include <stddef.h>
+
+enum {
+    /* Curves are split up in fixed point, with this many fractional bits,
+     * which leaves room for coordinates in the millions. */
+    FRAC_BITS = 4,
+    ONE = 1 << FRAC_BITS,
+
+    /* How far a line may stray from the curve it stands in for, in fixed
+     * point: a quarter of a pixel */
+    TOLERANCE = ONE / 4,
+
+    /* Halving a curve this many times gives 65536 lines, which is plenty
+     * for any curve that fits in a coordinate. */
+    MAX_DEPTH = 16,
+
+    /* Points are drawn a batch at a time, from the stack. */
+    MAX_POINTS = 256
+};
+
+/* A cubic Bezier curve's 4 points, as x, y pairs in fixed point */
+struct Curve
+{
+    int p[8];
+    int depth; /* How many times it's been halved */
+};
+
+struct Points
+{
+    int xy[MAX_POINTS * 2];
+    size_t n;
+};
+
+static int magnitude(int a)
+{
+    return a < 0 ? -a : a;
+}
+
+static int max(int a, int b)
+{
+    return a > b ? a : b;
+}
+
+/* Round a fixed point coordinate to the nearest pixel. Shifting negative
+ * numbers right isn't portable, so they're rounded as positive ones. */
+static int toPixel(int v)
+{
+    v += ONE / 2;
+
+    return v >= 0 ? v >> FRAC_BITS : -((-v + ONE - 1) >> FRAC_BITS);
+}
+
+/* Return non-zero if the line from the curve's start to its end is within
+ * TOLERANCE of the curve everywhere. The curve strays from the line by at
+ * most a quarter of how far the control points pull it away, which needs no
+ * square roots to check. */
+static int isFlat(const int *p)
+{
+    int ux = magnitude(3 * p[2] - 2 * p[0] - p[6]);
+    int uy = magnitude(3 * p[3] - 2 * p[1] - p[7]);
+    int vx = magnitude(3 * p[4] - p[0] - 2 * p[6]);
+    int vy = magnitude(3 * p[5] - p[1] - 2 * p[7]);
+
+    return max(ux, vx) + max(uy, vy) <= 4 * TOLERANCE;
+}
+
+/* Split c in half with de Casteljau's construction, leaving the first half
+ * in c and the second in d. */
+static void halve(struct Curve *c, struct Curve *d)
+{
+    int *p = c->p;
+    int *q = d->p;
+    int i;
+
+    for (i = 0; i < 2; ++i)
+    {
+        int ab = (p[i] + p[i + 2]) / 2;
+        int bc = (p[i + 2] + p[i + 4]) / 2;
+        int cd = (p[i + 4] + p[i + 6]) / 2;
+        int abc = (ab + bc) / 2;
+        int bcd = (bc + cd) / 2;
+        int mid = (abc + bcd) / 2;
+
+        q[i + 6] = p[i + 6];
+        q[i + 4] = cd;
+        q[i + 2] = bcd;
+        q[i] = mid;
+        p[i + 2] = ab;
+        p[i + 4] = abc;
+        p[i + 6] = mid;
+    }
+
+    d->depth = ++c->depth;
+}
+
+static void flush(struct Points *points)
+{
+    if (points->n < 2)
+    {
+        return;
+    }
+
+    DrawPolyline(points->xy, points->n);
+
+    /* Carry on from the last point. */
+    points->xy[0] = points->xy[points->n * 2 - 2];
+    points->xy[1] = points->xy[points->n * 2 - 1];
+    points->n = 1;
+}
+
+static void addPoint(struct Points *points, int x, int y)
+{
+    x = toPixel(x);
+    y = toPixel(y);
+
+    /* Lines shorter than a pixel needn't be drawn. */
+    if (points->n && points->xy[points->n * 2 - 2] == x &&
+        points->xy[points->n * 2 - 1] == y)
+    {
+        return;
+    }
+
+    if (points->n == MAX_POINTS)
+    {
+        flush(points);
+    }
+    points->xy[points->n * 2] = x;
+    points->xy[points->n * 2 + 1] = y;
+    ++points->n;
+}
+
+/* Add the end of each line a curve flattens into. */
+static void flatten(struct Points *points, const int *xy)
+{
+    struct Curve stack[MAX_DEPTH + 1];
+    int top;
+    int i;
+
+    for (i = 0; i < 8; ++i)
+    {
+        stack[0].p[i] = xy[i] * ONE;
+    }
+    stack[0].depth = 0;
+    top = 0;
+
+    /* Take the first half of each curve that isn't flat yet, and come back
+     * to the second half later. */
+    while (top >= 0)
+    {
+        struct Curve *c = &stack[top];
+
+        if (c->depth < MAX_DEPTH && !isFlat(c->p))
+        {
+            /* Swap the halves over so that the first is on top. */
+            stack[top + 1] = *c;
+            halve(&stack[top + 1], c);
+            ++top;
+            continue;
+        }
+
+        addPoint(points, c->p[6], c->p[7]);
+        --top;
+    }
+}
+
+void DrawBezierPath(const int *xy, size_t n)
+{
+    struct Points points;
+    size_t i;
+
+    points.n = 0;
+    if (!n)
+    {
+        return;
+    }
+
+    addPoint(&points, xy[0] * ONE, xy[1] * ONE);
+    for (i = 0; i < n; ++i)
+    {
+        flatten(&points, &xy[i * 6]);
+    }
+
+    /* A curve that doesn't go anywhere is still a dot. */
+    if (points.n == 1)
+    {
+        points.xy[2] = points.xy[0];
+        points.xy[3] = points.xy[1];
+        points.n = 2;
+    }
+
+    flush(&points);
+}
+
+void DrawBezier(const int *xy)
+{
+    DrawBezierPath(xy, 1);
+}
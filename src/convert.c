@@ -0,0 +1,199 @@
+/*
+ *  convert.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "convert.h"
+
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define CONVERT_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CONVERT_NEON 1
+#endif
+
+void convertLookup(u8 *dst, int bpp, const u8 *src, size_t count,
+                   const u32 *lut)
+{
+    size_t i;
+
+    /* Lookups don't vectorize without gathers, but keeping the pixel size
+     * out of the inner loop still helps. */
+    switch (bpp)
+    {
+    case 1:
+        for (i = 0; i < count; ++i)
+        {
+            dst[i] = (u8)lut[src[i]];
+        }
+        break;
+    case 2:
+        for (i = 0; i < count; ++i)
+        {
+            u16 p = (u16)lut[src[i]];
+
+            memcpy(&dst[i * 2], &p, sizeof(p));
+        }
+        break;
+    case 4:
+    default:
+        for (i = 0; i < count; ++i)
+        {
+            memcpy(&dst[i * 4], &lut[src[i]], sizeof(*lut));
+        }
+        break;
+    }
+}
+
+static u32 widen5(u32 c)
+{
+    return (c << 3) | (c >> 2);
+}
+
+void convertBGR555ToXRGB8888(u8 *dst, const u8 *src, size_t count)
+{
+#if CONVERT_SSE2
+    {
+        const __m128i five = _mm_set1_epi32(0x1F);
+        const __m128i zero = _mm_setzero_si128();
+
+        /* 8 pixels at a time */
+        for (; count >= 8; count -= 8, src += 16, dst += 32)
+        {
+            __m128i p = _mm_loadu_si128((const __m128i *)src);
+            __m128i half[2];
+            int i;
+
+            half[0] = _mm_unpacklo_epi16(p, zero);
+            half[1] = _mm_unpackhi_epi16(p, zero);
+            for (i = 0; i < 2; ++i)
+            {
+                __m128i r = _mm_and_si128(half[i], five);
+                __m128i g = _mm_and_si128(_mm_srli_epi32(half[i], 5), five);
+                __m128i b = _mm_and_si128(_mm_srli_epi32(half[i], 10), five);
+
+                r = _mm_or_si128(_mm_slli_epi32(r, 3), _mm_srli_epi32(r, 2));
+                g = _mm_or_si128(_mm_slli_epi32(g, 3), _mm_srli_epi32(g, 2));
+                b = _mm_or_si128(_mm_slli_epi32(b, 3), _mm_srli_epi32(b, 2));
+                p = _mm_or_si128(_mm_slli_epi32(r, 16),
+                                 _mm_or_si128(_mm_slli_epi32(g, 8), b));
+                _mm_storeu_si128((__m128i *)&dst[i * 16], p);
+            }
+        }
+    }
+#elif CONVERT_NEON
+    {
+        const uint32x4_t five = vdupq_n_u32(0x1F);
+
+        /* 8 pixels at a time */
+        for (; count >= 8; count -= 8, src += 16, dst += 32)
+        {
+            uint16x8_t p = vreinterpretq_u16_u8(vld1q_u8(src));
+            uint32x4_t half[2];
+            int i;
+
+            half[0] = vmovl_u16(vget_low_u16(p));
+            half[1] = vmovl_u16(vget_high_u16(p));
+            for (i = 0; i < 2; ++i)
+            {
+                uint32x4_t r = vandq_u32(half[i], five);
+                uint32x4_t g = vandq_u32(vshrq_n_u32(half[i], 5), five);
+                uint32x4_t b = vandq_u32(vshrq_n_u32(half[i], 10), five);
+                uint32x4_t q;
+
+                r = vorrq_u32(vshlq_n_u32(r, 3), vshrq_n_u32(r, 2));
+                g = vorrq_u32(vshlq_n_u32(g, 3), vshrq_n_u32(g, 2));
+                b = vorrq_u32(vshlq_n_u32(b, 3), vshrq_n_u32(b, 2));
+                q = vorrq_u32(vshlq_n_u32(r, 16),
+                              vorrq_u32(vshlq_n_u32(g, 8), b));
+                vst1q_u8(&dst[i * 16], vreinterpretq_u8_u32(q));
+            }
+        }
+    }
+#endif
+
+    for (; count > 0; --count, src += 2, dst += 4)
+    {
+        u16 p;
+        u32 q;
+
+        memcpy(&p, src, sizeof(p));
+        q = widen5(p & 0x1F) << 16 | widen5((p >> 5) & 0x1F) << 8 |
+            widen5((p >> 10) & 0x1F);
+        memcpy(dst, &q, sizeof(q));
+    }
+}
+
+void convertXRGB8888ToBGR555(u8 *dst, const u8 *src, size_t count)
+{
+#if CONVERT_SSE2
+    {
+        const __m128i five = _mm_set1_epi32(0x1F);
+
+        /* 8 pixels at a time */
+        for (; count >= 8; count -= 8, src += 32, dst += 16)
+        {
+            __m128i half[2];
+            int i;
+
+            for (i = 0; i < 2; ++i)
+            {
+                __m128i p = _mm_loadu_si128((const __m128i *)&src[i * 16]);
+                __m128i r = _mm_and_si128(_mm_srli_epi32(p, 19), five);
+                __m128i g = _mm_and_si128(_mm_srli_epi32(p, 11), five);
+                __m128i b = _mm_and_si128(_mm_srli_epi32(p, 3), five);
+
+                half[i] = _mm_or_si128(r, _mm_or_si128(_mm_slli_epi32(g, 5),
+                                                       _mm_slli_epi32(b, 10)));
+            }
+
+            /* Everything fits in 15 bits, so saturating is harmless. */
+            _mm_storeu_si128((__m128i *)dst,
+                             _mm_packs_epi32(half[0], half[1]));
+        }
+    }
+#elif CONVERT_NEON
+    {
+        const uint32x4_t five = vdupq_n_u32(0x1F);
+
+        /* 8 pixels at a time */
+        for (; count >= 8; count -= 8, src += 32, dst += 16)
+        {
+            uint16x4_t half[2];
+            int i;
+
+            for (i = 0; i < 2; ++i)
+            {
+                uint32x4_t p = vreinterpretq_u32_u8(vld1q_u8(&src[i * 16]));
+                uint32x4_t r = vandq_u32(vshrq_n_u32(p, 19), five);
+                uint32x4_t g = vandq_u32(vshrq_n_u32(p, 11), five);
+                uint32x4_t b = vandq_u32(vshrq_n_u32(p, 3), five);
+
+                half[i] = vmovn_u32(vorrq_u32(r,
+                                              vorrq_u32(vshlq_n_u32(g, 5),
+                                                        vshlq_n_u32(b, 10))));
+            }
+
+            vst1q_u8(dst, vreinterpretq_u8_u16(vcombine_u16(half[0],
+                                                            half[1])));
+        }
+    }
+#endif
+
+    for (; count > 0; --count, src += 4, dst += 2)
+    {
+        u32 p;
+        u16 q;
+
+        memcpy(&p, src, sizeof(p));
+        q = (u16)(((p >> 19) & 0x1F) | ((p >> 11) & 0x1F) << 5 |
+                  ((p >> 3) & 0x1F) << 10);
+        memcpy(dst, &q, sizeof(q));
+    }
+}
@@ -0,0 +1,28 @@
+/*
+ *  convert.h
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef CONVERT_H
+#define CONVERT_H
+
+#include "guikit/ptypes.h"
+#include <stddef.h>
+
+/* Look each of count 8bpp pixels up in lut, writing bpp (1, 2, or 4) bytes of
+ * each result to dst. */
+void convertLookup(u8 *dst, int bpp, const u8 *src, size_t count,
+                   const u32 *lut);
+
+/* Convert count BGR555 pixels to XRGB8888, widening each channel to 8 bits by
+ * repeating its top bits below it. */
+void convertBGR555ToXRGB8888(u8 *dst, const u8 *src, size_t count);
+
+/* Convert count XRGB8888 pixels to BGR555, dropping the low 3 bits of each
+ * channel. */
+void convertXRGB8888ToBGR555(u8 *dst, const u8 *src, size_t count);
+
+#endif
@@ -0,0 +1,137 @@
+/*
+ *  damage.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "guikit/damage.h"
+#include "guikit/primrect.h"
+
+static struct Rect bounds;
+static struct Rect clip; /* Within bounds */
+static struct Rect damage[MAX_DAMAGE_RECTS];
+static size_t numDamage;
+
+static long area(const struct Rect *r)
+{
+    return (long)(r->right - r->left + 1) * (r->bottom - r->top + 1);
+}
+
+/* Return non-zero if a and b overlap or share an edge, such that their union
+ * covers no pixels outside of a or b along the shared edge. */
+static int touches(const struct Rect *a, const struct Rect *b)
+{
+    return a->left <= b->right + 1 && b->left <= a->right + 1 &&
+           a->top <= b->bottom + 1 && b->top <= a->bottom + 1;
+}
+
+static void removeDamage(size_t i)
+{
+    damage[i] = damage[--numDamage];
+}
+
+void SetDamageBounds(const struct Rect *rect)
+{
+    bounds = *rect;
+    clip = *rect;
+    numDamage = 0;
+}
+
+void SetDamageClip(const struct Rect *rect)
+{
+    clip = *rect;
+}
+
+/* Add r, which is already known to be within bounds. */
+static void addDamage(struct Rect r)
+{
+    size_t i;
+    size_t best;
+    long bestCost;
+
+    for (;;)
+    {
+        /* Absorb every rect we overlap, until r doesn't touch any of the
+         * others. This keeps the list free of overlaps. */
+        i = 0;
+        while (i < numDamage)
+        {
+            if (touches(&damage[i], &r))
+            {
+                GrowRect(&r, &damage[i]);
+                removeDamage(i);
+                i = 0;
+                continue;
+            }
+            ++i;
+        }
+
+        if (numDamage < MAX_DAMAGE_RECTS)
+        {
+            damage[numDamage++] = r;
+            return;
+        }
+
+        /* The list is full. Merge with whichever rect adds the least
+         * undamaged area, then try again with the bigger rect. */
+        best = 0;
+        bestCost = -1;
+        for (i = 0; i < numDamage; ++i)
+        {
+            struct Rect u;
+            long cost;
+
+            u = r;
+            GrowRect(&u, &damage[i]);
+            cost = area(&u) - area(&r) - area(&damage[i]);
+            if (bestCost < 0 || cost < bestCost)
+            {
+                best = i;
+                bestCost = cost;
+            }
+        }
+
+        GrowRect(&r, &damage[best]);
+        removeDamage(best);
+    }
+}
+
+void AddDamage(const struct Rect *rect)
+{
+    struct Rect r;
+
+    r = *rect;
+
+    /* Ignore degenerate rects, like those from zero-length lines. */
+    if (r.right < r.left || r.bottom < r.top)
+    {
+        return;
+    }
+
+    if (ClipRect(&r, &bounds) == CLIP_REJECTED ||
+        ClipRect(&r, &clip) == CLIP_REJECTED)
+    {
+        return;
+    }
+
+    addDamage(r);
+}
+
+void AddDamageAll(void)
+{
+    numDamage = 0;
+    addDamage(bounds);
+}
+
+const struct Rect *GetDamage(size_t *num)
+{
+    *num = numDamage;
+    return damage;
+}
+
+void ClearDamage(void)
+{
+    numDamage = 0;
+}
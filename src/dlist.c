@@ -0,0 +1,478 @@
+/*
+ *  dlist.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "guikit/dlist.h"
+
+#include "atlas.h"
+#include "record.h"
+#include "tiles.h"
+#include "workers.h"
+#include "guikit/graphics.h"
+#include "guikit/panic.h"
+#include "guikit/pmemory.h"
+#include "guikit/primrect.h"
+#include "guikit/ptypes.h"
+#include "guikit/shade.h"
+#include <stddef.h>
+
+struct DisplayList
+{
+    struct Command *cmds;
+    size_t len;
+    size_t cap;
+};
+
+struct DisplayList *recording;
+
+int renderThreads = 1;
+
+/* The pen as of the last time it was set */
+static struct Pen pen = {COLOR_BLACK, 0, 0, 0};
+
+struct DisplayList *NewDisplayList(void)
+{
+    return pcalloc(1, sizeof(struct DisplayList));
+}
+
+static void clear(struct DisplayList *list)
+{
+    size_t i;
+
+    for (i = 0; i < list->len; ++i)
+    {
+        pfree(list->cmds[i].glyphs);
+    }
+    list->len = 0;
+}
+
+void FreeDisplayList(struct DisplayList *list)
+{
+    if (!list)
+    {
+        return;
+    }
+
+    if (recording == list)
+    {
+        recording = NULL;
+    }
+
+    clear(list);
+    pfree(list->cmds);
+    pfree(list);
+}
+
+void BeginDisplayList(struct DisplayList *list)
+{
+    if (recording)
+    {
+        panic("Already recording a display list.");
+    }
+
+    clear(list);
+    recording = list;
+}
+
+int samePen(const struct Pen *a, const struct Pen *b)
+{
+    if (a->color != b->color)
+    {
+        return 0;
+    }
+
+    return a->color >= 0 || (a->r == b->r && a->g == b->g && a->b == b->b);
+}
+
+/* Merge b into a if together they make up a rectangle. Returns non-zero if
+ * merged. */
+static int mergeRects(struct Rect *a, const struct Rect *b)
+{
+    if (a->right < a->left || a->bottom < a->top ||
+        b->right < b->left || b->bottom < b->top)
+    {
+        return 0;
+    }
+
+    /* One above the other */
+    if (a->left == b->left && a->right == b->right &&
+        b->top <= a->bottom + 1 && a->top <= b->bottom + 1)
+    {
+        a->top = a->top < b->top ? a->top : b->top;
+        a->bottom = a->bottom > b->bottom ? a->bottom : b->bottom;
+        return 1;
+    }
+
+    /* Side by side */
+    if (a->top == b->top && a->bottom == b->bottom &&
+        b->left <= a->right + 1 && a->left <= b->right + 1)
+    {
+        a->left = a->left < b->left ? a->left : b->left;
+        a->right = a->right > b->right ? a->right : b->right;
+        return 1;
+    }
+
+    return 0;
+}
+
+void EndDisplayList(void)
+{
+    struct DisplayList *list;
+    size_t kept;
+    size_t i;
+
+    list = recording;
+    recording = NULL;
+    if (!list)
+    {
+        return;
+    }
+
+    /* Merge fills that come one after another with the same pen. Fills don't
+     * care what's below them, so order within a merged run doesn't matter. */
+    kept = 0;
+    for (i = 0; i < list->len; ++i)
+    {
+        struct Command *c = &list->cmds[i];
+        struct Command *prev = kept ? &list->cmds[kept - 1] : NULL;
+
+        if (prev && c->type == CMD_FILL_RECT && prev->type == CMD_FILL_RECT &&
+            samePen(&c->pen, &prev->pen) && mergeRects(&prev->dst, &c->dst))
+        {
+            continue;
+        }
+
+        list->cmds[kept++] = *c;
+    }
+    list->len = kept;
+}
+
+size_t DisplayListLength(const struct DisplayList *list)
+{
+    return list->len;
+}
+
+static struct Command *addCommand(int type)
+{
+    struct DisplayList *list;
+    struct Command *c;
+
+    list = recording;
+    if (list->len == list->cap)
+    {
+        list->cap = list->cap ? list->cap * 2 : 64;
+        list->cmds = prealloc(list->cmds, list->cap * sizeof(*list->cmds));
+    }
+
+    c = &list->cmds[list->len++];
+    c->type = type;
+    c->pen = pen;
+    c->img = NULL;
+    c->mask = NULL;
+    c->glyphs = NULL;
+    c->numGlyphs = 0;
+    c->capGlyphs = 0;
+    c->colorFn = NULL;
+    c->rowFn = NULL;
+    c->ctx = NULL;
+    c->items = NULL;
+    c->colors = NULL;
+    c->numItems = 0;
+
+    return c;
+}
+
+void recordInts(int type, int a, int b, int c, int d, int e)
+{
+    struct Command *cmd;
+
+    cmd = addCommand(type);
+    cmd->a[0] = a;
+    cmd->a[1] = b;
+    cmd->a[2] = c;
+    cmd->a[3] = d;
+    cmd->a[4] = e;
+}
+
+void recordRect(int type, const struct Rect *rect)
+{
+    addCommand(type)->dst = *rect;
+}
+
+void recordFillRectOp(const unsigned char *pattern, int op,
+                      const struct Rect *rect)
+{
+    struct Command *c;
+
+    c = addCommand(CMD_FILL_RECT_OP);
+    c->mask = pattern;
+    c->a[0] = op;
+    c->dst = *rect;
+}
+
+void recordBlit(int type, const unsigned char *img, const unsigned char *mask,
+                int op, const struct Rect *dst, const struct Rect *src,
+                int span)
+{
+    struct Command *c;
+
+    c = addCommand(type);
+    c->img = img;
+    c->mask = mask;
+    c->a[0] = op;
+    c->a[1] = span;
+    c->dst = *dst;
+    if (src)
+    {
+        c->src = *src;
+    }
+}
+
+void recordShade(const struct Rect *area, int format, color_fn colorFn,
+                 row_fn rowFn, void *ctx)
+{
+    struct Command *c;
+
+    c = addCommand(colorFn ? CMD_RENDER_PER_PIXEL : CMD_RENDER_PER_ROW);
+    c->a[0] = format;
+    c->dst = *area;
+    c->colorFn = colorFn;
+    c->rowFn = rowFn;
+    c->ctx = ctx;
+}
+
+void recordBatch(int type, const void *items, const u32 *colors, size_t n)
+{
+    struct Command *c;
+
+    c = addCommand(type);
+    c->items = items;
+    c->colors = colors;
+    c->numItems = n;
+}
+
+void recordPolygon(const int *xy, size_t n, int rule)
+{
+    struct Command *c;
+
+    c = addCommand(CMD_FILL_POLYGON);
+    c->a[0] = rule;
+    c->items = xy;
+    c->numItems = n;
+}
+
+void recordGlyph(const unsigned char *img, int span, int height,
+                 const struct Rect *dst, const struct Rect *src)
+{
+    struct Command *c;
+
+    c = recording->len ? &recording->cmds[recording->len - 1] : NULL;
+    if (!c || c->type != CMD_GLYPHS || c->img != img || c->a[1] != span ||
+        c->a[2] != height || !samePen(&c->pen, &pen))
+    {
+        c = addCommand(CMD_GLYPHS);
+        c->img = img;
+        c->a[1] = span;
+        c->a[2] = height;
+    }
+
+    if (c->numGlyphs == c->capGlyphs)
+    {
+        c->capGlyphs = c->capGlyphs ? c->capGlyphs * 2 : 16;
+        c->glyphs = prealloc(c->glyphs, c->capGlyphs * 2 * sizeof(*c->glyphs));
+    }
+
+    c->glyphs[c->numGlyphs * 2] = *dst;
+    c->glyphs[c->numGlyphs * 2 + 1] = *src;
+    ++c->numGlyphs;
+}
+
+void notePenColor(int color)
+{
+    pen.color = color;
+}
+
+void notePenRGB(u8 r, u8 g, u8 b)
+{
+    pen.color = -1;
+    pen.r = r;
+    pen.g = g;
+    pen.b = b;
+}
+
+void setPen(const struct Pen *p)
+{
+    if (p->color >= 0)
+    {
+        SetColor(p->color);
+    }
+    else
+    {
+        SetColorRGB(p->r, p->g, p->b);
+    }
+}
+
+static void drawGlyphs(const struct Command *c)
+{
+    size_t i;
+
+    /* One atlas lookup for the whole run, if we can. */
+    if (!recording &&
+        !atlasBlitRun(c->img, c->a[1], c->a[2], c->glyphs, c->numGlyphs))
+    {
+        return;
+    }
+
+    for (i = 0; i < c->numGlyphs; ++i)
+    {
+        const struct Rect *dst = &c->glyphs[i * 2];
+        const struct Rect *src = &c->glyphs[i * 2 + 1];
+
+        if (recording)
+        {
+            recordGlyph(c->img, c->a[1], c->a[2], dst, src);
+        }
+        else
+        {
+            BlitOp(c->img, OP_SRC_INV, dst, src, c->a[1]);
+        }
+    }
+}
+
+void executeCommand(const struct Command *c)
+{
+    const int *a = c->a;
+
+    switch (c->type)
+    {
+    case CMD_FILL_SCREEN:
+        FillScreen();
+        break;
+    case CMD_DRAW_RECT:
+        DrawRect(&c->dst);
+        break;
+    case CMD_FILL_RECT:
+        FillRect(&c->dst);
+        break;
+    case CMD_FILL_RECT_OP:
+        FillRectOp(c->mask, a[0], &c->dst);
+        break;
+    case CMD_VERT_LINE:
+        DrawVertLine(a[0], a[1], a[2]);
+        break;
+    case CMD_HORIZ_LINE:
+        DrawHorizLine(a[0], a[1], a[2]);
+        break;
+    case CMD_DIAG_LINE:
+        DrawDiagLine(a[0], a[1], a[2], a[3]);
+        break;
+    case CMD_LINE:
+        DrawLine(a[0], a[1], a[2], a[3]);
+        break;
+    case CMD_DRAW_CIRCLE:
+        DrawCircle(a[0], a[1], a[2]);
+        break;
+    case CMD_FILL_CIRCLE:
+        FillCircle(a[0], a[1], a[2]);
+        break;
+    case CMD_DRAW_ROUND_RECT:
+        DrawRoundRect(a[0], a[1], a[2], a[3], a[4]);
+        break;
+    case CMD_FILL_ROUND_RECT:
+        FillRoundRect(a[0], a[1], a[2], a[3], a[4]);
+        break;
+    case CMD_DRAW_BITMAP:
+        DrawBitmap(&c->dst, a[1], c->img, c->mask);
+        break;
+    case CMD_DRAW_COLOR_BITMAP:
+        DrawColorBitmap(&c->dst, a[1], c->img, c->mask);
+        break;
+    case CMD_BLIT_OP:
+        BlitOp(c->img, a[0], &c->dst, &c->src, a[1]);
+        break;
+    case CMD_BLIT_WITH_MASK:
+        BlitWithMask(c->img, c->mask, &c->dst, &c->src, a[1]);
+        break;
+    case CMD_GLYPHS:
+        drawGlyphs(c);
+        break;
+    case CMD_DRAW_PIXEL_ARRAY:
+        DrawPixelArray(&c->dst, c->img, a[1], a[0]);
+        break;
+    case CMD_RENDER_PER_PIXEL:
+        RenderPerPixel(&c->dst, a[0], c->colorFn, c->ctx);
+        break;
+    case CMD_RENDER_PER_ROW:
+        RenderPerRow(&c->dst, a[0], c->rowFn, c->ctx);
+        break;
+    case CMD_FILL_RECTS_COLORS:
+        FillRectsColors(c->items, c->colors, c->numItems);
+        break;
+    case CMD_LINES_COLORS:
+        DrawLinesColors(c->items, c->colors, c->numItems);
+        break;
+    case CMD_PUSH_CLIP:
+        PushClipRect(&c->dst);
+        break;
+    case CMD_POP_CLIP:
+        PopClipRect();
+        break;
+    case CMD_FILL_POLYGON:
+        FillPolygon(c->items, c->numItems, a[0]);
+        break;
+    case CMD_FLOOD_FILL:
+        FloodFill(a[0], a[1]);
+        break;
+    case CMD_BOUNDARY_FILL:
+        BoundaryFill(a[0], a[1], a[2]);
+        break;
+    default:
+        panic("Unknown display list command: %d", c->type);
+    }
+}
+
+void ExecuteDisplayList(const struct DisplayList *list)
+{
+    const struct Pen *current;
+    size_t i;
+
+    if (list == recording)
+    {
+        panic("Can't execute a display list while recording it.");
+    }
+
+    if (renderThreads > 1 && !recording &&
+        executeTiled(list->cmds, list->len, renderThreads) == 0)
+    {
+        return;
+    }
+
+    /* Only change the pen when it changes. */
+    current = NULL;
+    for (i = 0; i < list->len; ++i)
+    {
+        const struct Command *c = &list->cmds[i];
+
+        if (!current || !samePen(current, &c->pen))
+        {
+            setPen(&c->pen);
+            current = &c->pen;
+        }
+
+        executeCommand(c);
+    }
+}
+
+void SetRenderThreads(int threads)
+{
+    if (threads == 0)
+    {
+        threads = countCPUs();
+    }
+
+    renderThreads = threads > 1 ? threads : 1;
+}
@@ -7,8 +7,17 @@
  */
 
 #include "guikit/graphics.h"
+#include "atlas.h"
+#include "lineclip.h"
+#include "polygon.h"
+#include "seedfill.h"
+#include "tiles.h"
+#include "workers.h"
+#include "guikit/shade.h"
+#include "guikit/panic.h"
 #include "guikit/primrect.h"
 #include <limits.h>
+#include <stddef.h>
 
 #include "guikit/ansidos.h"
 #include <pc.h>
@@ -86,6 +95,9 @@ static struct Rect clip = {
     SCREEN_HEIGHT - 1
 };
 
+/* Pushed clip rects, with the whole screen at the bottom and clip on top */
+static struct ClipStack clips;
+
 /* An 8x8 1-bit bitmap, packed 1bpp */
 static const unsigned char *currentPattern;
 
@@ -93,6 +105,9 @@ const unsigned char blackPattern[] = {0, 0, 0, 0, 0, 0, 0, 0};
 
 static int currentMode = -1;
 
+/* The color last given to SetColor() */
+static int penColor;
+
 static unsigned long linear_ptr(unsigned long segment, unsigned long offset)
 {
     return segment * 16 + offset;
@@ -412,6 +427,7 @@ static void setMode3Color(int color)
 void SetColor(int color)
 {
     /* Assume we are in Mode 3 for now. */
+    penColor = color;
     setMode3Color(color);
 }
 
@@ -424,6 +440,9 @@ int InitGraphics()
 
     currentPattern = blackPattern;
 
+    InitRect(&clip, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+    InitClipStack(&clips, &clip);
+
     /* Reset the data rotate and bit mask registers. */
     /* XXX Maybe not needed after mode set. */
     set_gc(GC_DATA_ROTATE, 0);
@@ -435,11 +454,87 @@ int InitGraphics()
     return 0;
 }
 
+int InitGraphicsEx(const struct GraphicsMode *mode)
+{
+    /* Mode 0x12 is all we've got. */
+    if (mode->width != SCREEN_WIDTH || mode->height != SCREEN_HEIGHT ||
+        mode->format != PIXEL_FORMAT_INDEX8)
+    {
+        return -1;
+    }
+
+    return InitGraphics();
+}
+
+int GetScreenWidth(void)
+{
+    return SCREEN_WIDTH;
+}
+
+int GetScreenHeight(void)
+{
+    return SCREEN_HEIGHT;
+}
+
 void ShowGraphics()
 {
     return;
 }
 
+void *GetFrameBuffer(int *pitch, int *format)
+{
+    /* VGA memory is planar and not something callers can write into as a
+     * linear framebuffer. */
+    (void)pitch;
+    (void)format;
+
+    return NULL;
+}
+
+int atlasBlit(const unsigned char *img, int span, int height,
+              const struct Rect *dst, const struct Rect *src)
+{
+    /* Glyphs go straight to VGA memory with BlitOp() instead. */
+    (void)img;
+    (void)span;
+    (void)height;
+    (void)dst;
+    (void)src;
+
+    return -1;
+}
+
+int atlasBlitRun(const unsigned char *img, int span, int height,
+                 const struct Rect *rects, size_t num)
+{
+    (void)img;
+    (void)span;
+    (void)height;
+    (void)rects;
+    (void)num;
+
+    return -1;
+}
+
+int executeTiled(const struct Command *cmds, size_t num, int threads)
+{
+    (void)cmds;
+    (void)num;
+    (void)threads;
+
+    /* Only one CPU to draw with */
+    return -1;
+}
+
+void atlasForget(const unsigned char *img)
+{
+    (void)img;
+}
+
+void atlasFlush(void)
+{
+}
+
 void FillScreen(int color)
 {
     unsigned long dest;
@@ -477,6 +572,8 @@ void FreeGraphics(void)
 
     /* Return to text mode. */
     set_gfx_mode(0x03);
+
+    polygonFree();
 }
 
 void DrawRect(int color, const struct Rect *rect)
@@ -577,6 +674,9 @@ void DrawLine(int color, int x1, int y1, int x2, int y2)
     int final_run_len;
     int run_len; /* aka step */
     int errorAdj;
+    int first; /* The first and last runs that can be seen */
+    int last;
+    int i;
 
     setMode3Color(color);
 
@@ -651,6 +751,15 @@ void DrawLine(int color, int x1, int y1, int x2, int y2)
         return;
     }
 
+    /* Only bother with the runs that reach into the clip rect. Skipped runs
+     * still move the error term along, so the rest land where they would
+     * have anyway. */
+    if (!clipLineRuns(&clip, x1, y1, XAdvance, XDelta, YDelta, &first,
+                      &last))
+    {
+        return;
+    }
+
     /* Determine whether the line is X or Y major, and handle accordingly. */
     if (XDelta > YDelta)
     {
@@ -697,34 +806,40 @@ void DrawLine(int color, int x1, int y1, int x2, int y2)
 
         /* X-Major adjustments done now */
 
-        /* Draw the first partial run of pixels. */
-        /* XXX TODO extract out the x2 x1 choice to the outside of the loop. */
-        /* Option: make an x variable we set when we choose XAdvance, and then
-         * always use XAdvance as "1" when doing x-major
-         * Another choice is to have a horizontal line drawing function that
-         * takes Xadvance as a param, to pick to go left or right */
-        if (XAdvance < 0)
+        if (first > 0)
         {
-            /* Right to left */
-            DrawHorizLine(x1-run_len+1, y1++, run_len);
-            x1 -= run_len;
+            /* Skip straight past the runs before the clip rect. */
+            x1 += XAdvance * (run_len + skipLineRuns(first - 1, min_run_len,
+                                                     AdjUp, AdjDown,
+                                                     &errorAdj));
+            y1 += first;
         }
         else
         {
-            /* Left to right */
-            DrawHorizLine(x1, y1++, run_len);
-            x1 += run_len;
+            /* Draw the first partial run of pixels. */
+            /* XXX TODO extract out the x2 x1 choice to the outside of the
+             * loop. */
+            /* Option: make an x variable we set when we choose XAdvance, and
+             * then always use XAdvance as "1" when doing x-major
+             * Another choice is to have a horizontal line drawing function
+             * that takes Xadvance as a param, to pick to go left or right */
+            if (XAdvance < 0)
+            {
+                /* Right to left */
+                DrawHorizLine(x1-run_len+1, y1++, run_len);
+                x1 -= run_len;
+            }
+            else
+            {
+                /* Left to right */
+                DrawHorizLine(x1, y1++, run_len);
+                x1 += run_len;
+            }
         }
 
-        /* Draw all full runs */
-        /* Are there more than 2 scans? so there are some full runs? */
-        if (YDelta < 2)
+        /* Draw all full runs, up to the last one that can be seen */
+        for (i = first > 1 ? first : 1; i < YDelta && i <= last; ++i)
         {
-            /* No, no full runs */
-            goto xmajor_final;
-        }
-
-        while (YDelta-- > 1) {
             run_len = min_run_len; /* Run is at least this long */
             /* Advance the error term and add an extra pixel if the error term
              * so indicates. */
@@ -749,7 +864,11 @@ void DrawLine(int color, int x1, int y1, int x2, int y2)
                 x1 += run_len;
             }
         }
-xmajor_final:
+
+        if (last < YDelta)
+        {
+            return;
+        }
         if (XAdvance < 0)
         {
             /* Right to left */
@@ -806,21 +925,25 @@ xmajor_final:
 
         /* Y-Major adjustments done now */
 
-        /* Draw the first partial run of pixels. */
-        /*printf("x1,y1,len: (%d,%d,%d)\r", x1, y1, run_len);*/
-        drawVertLine(x1, y1, run_len);
-        y1 += run_len;
-        x1 += XAdvance;
-
-        /* Draw all full runs */
-        /* Are there more than 2 scans? so there are some full runs? */
-        if (XDelta < 2)
+        if (first > 0)
+        {
+            /* Skip straight past the runs before the clip rect. */
+            y1 += run_len + skipLineRuns(first - 1, min_run_len, AdjUp,
+                                         AdjDown, &errorAdj);
+            x1 += XAdvance * first;
+        }
+        else
         {
-            /* No, no full runs */
-            goto ymajor_final;
+            /* Draw the first partial run of pixels. */
+            /*printf("x1,y1,len: (%d,%d,%d)\r", x1, y1, run_len);*/
+            drawVertLine(x1, y1, run_len);
+            y1 += run_len;
+            x1 += XAdvance;
         }
 
-        while (XDelta-- > 1) {
+        /* Draw all full runs, up to the last one that can be seen */
+        for (i = first > 1 ? first : 1; i < XDelta && i <= last; ++i)
+        {
             run_len = min_run_len; /* Run is at least this long */
             /* Advance the error term and add an extra pixel if the error term
              * so indicates. */
@@ -837,7 +960,11 @@ xmajor_final:
             y1 += run_len;
             x1 += XAdvance;
         }
-ymajor_final:
+
+        if (last < XDelta)
+        {
+            return;
+        }
         /*printf("x1,y1,len: (%d,%d,%d)\r", x1, y1, run_len);*/
         drawVertLine(x1, y1, final_run_len);
         return;
@@ -1503,3 +1630,325 @@ int SaveScreenShot(const char *path)
     (void)path;
     return 0;
 }
+
+int DrawPixelArray(const struct Rect *dst, const void *src, int srcPitch,
+                   int srcFormat)
+{
+    (void)dst;
+    (void)src;
+    (void)srcPitch;
+    (void)srcFormat;
+
+    /* Planar VGA memory would need every pixel split across 4 planes. */
+    return -1;
+}
+
+int RenderPerPixel(const struct Rect *area, int format, color_fn fn,
+                   void *ctx)
+{
+    (void)area;
+    (void)format;
+    (void)fn;
+    (void)ctx;
+
+    return -1;
+}
+
+int RenderPerRow(const struct Rect *area, int format, row_fn fn, void *ctx)
+{
+    (void)area;
+    (void)format;
+    (void)fn;
+    (void)ctx;
+
+    return -1;
+}
+
+void FillRects(const struct Rect *rects, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < n; ++i)
+    {
+        FillRect(penColor, &rects[i]);
+    }
+}
+
+void DrawLines(const struct LineSeg *lines, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < n; ++i)
+    {
+        DrawLine(penColor, lines[i].x1, lines[i].y1, lines[i].x2,
+                 lines[i].y2);
+    }
+}
+
+void DrawPolyline(const int *xy, size_t n)
+{
+    size_t i;
+
+    for (i = 1; i < n; ++i)
+    {
+        DrawLine(penColor, xy[i * 2 - 2], xy[i * 2 - 1], xy[i * 2],
+                 xy[i * 2 + 1]);
+    }
+}
+
+static void polygonSpan(int x, int y, int width, const void *ctx)
+{
+    (void)ctx;
+    drawHorizLine(x, y, width);
+}
+
+void FillPolygon(const int *xy, size_t n, int rule)
+{
+    setMode3Color(penColor);
+    scanPolygon(xy, n, rule, &clip, polygonSpan, NULL);
+}
+
+/* What FloodFill() and BoundaryFill() are filling, and the 4 planes of the
+ * byte of VGA memory last read */
+struct PlanarFill
+{
+    int old; /* The color being filled over, for FloodFill() */
+    int border; /* The color to stop at, for BoundaryFill() */
+    int boundary;
+    long cached; /* Where the planes were read from, or -1 */
+    unsigned char planes[4];
+};
+
+/* Each plane holds one bit of the color of 8 pixels a byte, and reads get
+ * whichever plane the read map select picks. Runs mostly read along a row,
+ * so the 4 planes of a byte are kept for its other 7 pixels. */
+static int readPlanarPixel(struct PlanarFill *f, int x, int y)
+{
+    long offset = (long)y * 80 + x / 8;
+    unsigned char bit = 0x80U >> (x % 8);
+    int color;
+    int plane;
+
+    if (offset != f->cached)
+    {
+        for (plane = 0; plane < 4; ++plane)
+        {
+            set_gc(GC_READ_MAP_SELECT, plane);
+            f->planes[plane] =
+                _farpeekb(_dos_ds, linear_ptr(VGA_VIDEO_SEGMENT, offset));
+        }
+        f->cached = offset;
+    }
+
+    color = 0;
+    for (plane = 0; plane < 4; ++plane)
+    {
+        if (f->planes[plane] & bit)
+        {
+            color |= 1 << plane;
+        }
+    }
+
+    return color;
+}
+
+static int planarInside(int x, int y, void *ctx)
+{
+    struct PlanarFill *f = ctx;
+    int color = readPlanarPixel(f, x, y);
+
+    return f->boundary ? color != f->border && color != (penColor & 0xF)
+                       : color == f->old;
+}
+
+static void planarSpan(int x, int y, int width, void *ctx)
+{
+    struct PlanarFill *f = ctx;
+
+    drawHorizLine(x, y, width);
+
+    /* The byte read last may have just been drawn over. */
+    f->cached = -1;
+}
+
+static void planarFill(int x, int y, int boundary, int borderColor)
+{
+    struct PlanarFill f;
+
+    if (x < clip.left || x > clip.right || y < clip.top || y > clip.bottom)
+    {
+        return;
+    }
+
+    f.cached = -1;
+    f.boundary = boundary;
+    f.border = borderColor & 0xF;
+    f.old = readPlanarPixel(&f, x, y);
+
+    /* Filling over the pen's own color would never run out of pixels. */
+    if (!planarInside(x, y, &f) ||
+        (!boundary && f.old == (penColor & 0xF)))
+    {
+        return;
+    }
+
+    setMode3Color(penColor);
+    seedFill(x, y, &clip, planarInside, planarSpan, &f);
+}
+
+int FloodFill(int x, int y)
+{
+    planarFill(x, y, 0, 0);
+
+    return 0;
+}
+
+int BoundaryFill(int x, int y, int borderColor)
+{
+    planarFill(x, y, 1, borderColor);
+
+    return 0;
+}
+
+/* Pixel values here are just the COLOR_* colors. */
+void FillRectsColors(const struct Rect *rects, const u32 *colors, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < n; ++i)
+    {
+        FillRect((int)colors[i], &rects[i]);
+    }
+    SetColor(penColor);
+}
+
+void DrawLinesColors(const struct LineSeg *lines, const u32 *colors,
+                     size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < n; ++i)
+    {
+        DrawLine((int)colors[i], lines[i].x1, lines[i].y1, lines[i].x2,
+                 lines[i].y2);
+    }
+    SetColor(penColor);
+}
+
+int countCPUs(void)
+{
+    return 1;
+}
+
+static int checkPalette(int first, int count)
+{
+    /* 16 color planar mode only has 16 DAC entries wired up. */
+    if (first < 0 || count < 0 || first + count > NUM_COLORS)
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+int SetPaletteEntries(int first, int count, const struct RGB *colors)
+{
+    int i;
+
+    if (checkPalette(first, count))
+    {
+        return -1;
+    }
+
+    /* The DAC takes 6 bits per channel, and changes what's on screen right
+     * away. */
+    outportb(DAC_WRITE_ADDR, first);
+    for (i = 0; i < count; ++i)
+    {
+        outportb(DAC_DATA, colors[i].r >> 2);
+        outportb(DAC_DATA, colors[i].g >> 2);
+        outportb(DAC_DATA, colors[i].b >> 2);
+    }
+
+    return 0;
+}
+
+int GetPaletteEntries(int first, int count, struct RGB *colors)
+{
+    int i;
+
+    if (checkPalette(first, count))
+    {
+        return -1;
+    }
+
+    outportb(DAC_READ_ADDR, first);
+    for (i = 0; i < count; ++i)
+    {
+        unsigned char r = inportb(DAC_DATA);
+        unsigned char g = inportb(DAC_DATA);
+        unsigned char b = inportb(DAC_DATA);
+
+        colors[i].r = (u8)(r << 2 | r >> 4);
+        colors[i].g = (u8)(g << 2 | g >> 4);
+        colors[i].b = (u8)(b << 2 | b >> 4);
+    }
+
+    return 0;
+}
+
+int RotatePalette(int first, int count, int step)
+{
+    struct RGB colors[NUM_COLORS];
+    struct RGB rotated[NUM_COLORS];
+    int i;
+
+    if (GetPaletteEntries(first, count, colors))
+    {
+        return -1;
+    }
+
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    step %= count;
+    if (step < 0)
+    {
+        step += count;
+    }
+
+    for (i = 0; i < count; ++i)
+    {
+        rotated[(i + step) % count] = colors[i];
+    }
+
+    return SetPaletteEntries(first, count, rotated);
+}
+
+void PushClipRect(const struct Rect *rect)
+{
+    const struct Rect *top;
+
+    top = PushClip(&clips, rect);
+    if (!top)
+    {
+        panic("Clip rects pushed too deep.");
+    }
+
+    clip = *top;
+}
+
+void PopClipRect(void)
+{
+    const struct Rect *top;
+
+    top = PopClip(&clips);
+    if (!top)
+    {
+        panic("Popped a clip rect that wasn't pushed.");
+    }
+
+    clip = *top;
+}
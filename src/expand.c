@@ -0,0 +1,203 @@
+/*
+ *  expand.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "expand.h"
+
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define EXPAND_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define EXPAND_NEON 1
+#endif
+
+/* For each byte, which of its 8 pixels are set (0xFF) and clear (0x00). */
+#define BIT(b, n) (((b) & (0x80 >> (n))) ? 0xFF : 0x00)
+#define ROW(b) \
+    {BIT(b, 0), BIT(b, 1), BIT(b, 2), BIT(b, 3), \
+     BIT(b, 4), BIT(b, 5), BIT(b, 6), BIT(b, 7)}
+#define ROWS4(b) ROW(b), ROW((b) + 1), ROW((b) + 2), ROW((b) + 3)
+#define ROWS16(b) \
+    ROWS4(b), ROWS4((b) + 4), ROWS4((b) + 8), ROWS4((b) + 12)
+#define ROWS64(b) \
+    ROWS16(b), ROWS16((b) + 16), ROWS16((b) + 32), ROWS16((b) + 48)
+
+static const u8 lut[256][8] = {
+    ROWS64(0), ROWS64(64), ROWS64(128), ROWS64(192)
+};
+
+static u32 splat(u8 c)
+{
+    return c * 0x01010101UL;
+}
+
+/* Expand one byte, 4 pixels at a time. The table is in pixel order, so this
+ * works regardless of endianness. */
+static void expandByte(u8 *dst, u8 b, u32 on, u32 off)
+{
+    u32 m;
+    u32 p;
+
+    memcpy(&m, &lut[b][0], sizeof(m));
+    p = (m & on) | (~m & off);
+    memcpy(&dst[0], &p, sizeof(p));
+
+    memcpy(&m, &lut[b][4], sizeof(m));
+    p = (m & on) | (~m & off);
+    memcpy(&dst[4], &p, sizeof(p));
+}
+
+static void expandByteMasked(u8 *dst, u8 b, u8 mask, u32 on, u32 off,
+                             u32 transparent)
+{
+    u32 m;
+    u32 v;
+    u32 p;
+
+    memcpy(&m, &lut[b][0], sizeof(m));
+    memcpy(&v, &lut[mask][0], sizeof(v));
+    p = (((m & on) | (~m & off)) & v) | (~v & transparent);
+    memcpy(&dst[0], &p, sizeof(p));
+
+    memcpy(&m, &lut[b][4], sizeof(m));
+    memcpy(&v, &lut[mask][4], sizeof(v));
+    p = (((m & on) | (~m & off)) & v) | (~v & transparent);
+    memcpy(&dst[4], &p, sizeof(p));
+}
+
+#if EXPAND_SSE2
+/* Which of 16 pixels from 2 bytes are set, as 0xFF or 0x00 */
+static __m128i select16(const u8 *bits)
+{
+    const __m128i bitMask = _mm_set_epi8(0x01, 0x02, 0x04, 0x08,
+                                         0x10, 0x20, 0x40, -0x80,
+                                         0x01, 0x02, 0x04, 0x08,
+                                         0x10, 0x20, 0x40, -0x80);
+    __m128i v;
+
+    /* Spread each byte across 8 lanes. */
+    v = _mm_cvtsi32_si128(bits[0] | (bits[1] << 8));
+    v = _mm_unpacklo_epi8(v, v);
+    v = _mm_unpacklo_epi16(v, v);
+    v = _mm_unpacklo_epi32(v, v);
+
+    return _mm_cmpeq_epi8(_mm_and_si128(v, bitMask), bitMask);
+}
+
+static __m128i blend16(__m128i sel, __m128i on, __m128i off)
+{
+    return _mm_or_si128(_mm_and_si128(sel, on), _mm_andnot_si128(sel, off));
+}
+#endif
+
+#if EXPAND_NEON
+/* Which of 16 pixels from 2 bytes are set, as 0xFF or 0x00 */
+static uint8x16_t select16(const u8 *bits)
+{
+    static const u8 bitMask[16] = {
+        0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01,
+        0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01
+    };
+    uint8x16_t v;
+
+    v = vcombine_u8(vdup_n_u8(bits[0]), vdup_n_u8(bits[1]));
+
+    return vtstq_u8(v, vld1q_u8(bitMask));
+}
+#endif
+
+void expandBits(u8 *dst, const u8 *bits, size_t count, u8 on, u8 off)
+{
+    u32 on4;
+    u32 off4;
+
+#if EXPAND_SSE2
+    {
+        const __m128i onv = _mm_set1_epi8((char)on);
+        const __m128i offv = _mm_set1_epi8((char)off);
+
+        /* 32 pixels at a time */
+        for (; count >= 4; count -= 4, bits += 4, dst += 32)
+        {
+            __m128i a = blend16(select16(&bits[0]), onv, offv);
+            __m128i b = blend16(select16(&bits[2]), onv, offv);
+
+            _mm_storeu_si128((__m128i *)&dst[0], a);
+            _mm_storeu_si128((__m128i *)&dst[16], b);
+        }
+    }
+#elif EXPAND_NEON
+    {
+        const uint8x16_t onv = vdupq_n_u8(on);
+        const uint8x16_t offv = vdupq_n_u8(off);
+
+        /* 32 pixels at a time */
+        for (; count >= 4; count -= 4, bits += 4, dst += 32)
+        {
+            vst1q_u8(&dst[0], vbslq_u8(select16(&bits[0]), onv, offv));
+            vst1q_u8(&dst[16], vbslq_u8(select16(&bits[2]), onv, offv));
+        }
+    }
+#endif
+
+    on4 = splat(on);
+    off4 = splat(off);
+    for (; count > 0; --count, ++bits, dst += 8)
+    {
+        expandByte(dst, *bits, on4, off4);
+    }
+}
+
+void expandBitsMasked(u8 *dst, const u8 *bits, const u8 *mask, size_t count,
+                      u8 on, u8 off, u8 transparent)
+{
+    u32 on4;
+    u32 off4;
+    u32 transparent4;
+
+#if EXPAND_SSE2
+    {
+        const __m128i onv = _mm_set1_epi8((char)on);
+        const __m128i offv = _mm_set1_epi8((char)off);
+        const __m128i tv = _mm_set1_epi8((char)transparent);
+
+        /* 16 pixels at a time */
+        for (; count >= 2; count -= 2, bits += 2, mask += 2, dst += 16)
+        {
+            __m128i p = blend16(select16(bits), onv, offv);
+
+            p = blend16(select16(mask), p, tv);
+            _mm_storeu_si128((__m128i *)dst, p);
+        }
+    }
+#elif EXPAND_NEON
+    {
+        const uint8x16_t onv = vdupq_n_u8(on);
+        const uint8x16_t offv = vdupq_n_u8(off);
+        const uint8x16_t tv = vdupq_n_u8(transparent);
+
+        /* 16 pixels at a time */
+        for (; count >= 2; count -= 2, bits += 2, mask += 2, dst += 16)
+        {
+            uint8x16_t p = vbslq_u8(select16(bits), onv, offv);
+
+            vst1q_u8(dst, vbslq_u8(select16(mask), p, tv));
+        }
+    }
+#endif
+
+    on4 = splat(on);
+    off4 = splat(off);
+    transparent4 = splat(transparent);
+    for (; count > 0; --count, ++bits, ++mask, dst += 8)
+    {
+        expandByteMasked(dst, *bits, *mask, on4, off4, transparent4);
+    }
+}
@@ -0,0 +1,24 @@
+/*
+ *  expand.h
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef EXPAND_H
+#define EXPAND_H
+
+#include "guikit/ptypes.h"
+#include <stddef.h>
+
+/* Expand count bytes of packed 1bpp bits (most significant bit leftmost) into
+ * 8 pixels of 8bpp each. Set bits become on and clear bits become off. */
+void expandBits(u8 *dst, const u8 *bits, size_t count, u8 on, u8 off);
+
+/* Like expandBits(), but pixels with a clear bit in mask become transparent
+ * instead. */
+void expandBitsMasked(u8 *dst, const u8 *bits, const u8 *mask, size_t count,
+                      u8 on, u8 off, u8 transparent);
+
+#endif
@@ -0,0 +1,130 @@
+/*
+ *  floodfill.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "raster.h"
+#include "record.h"
+#include "seedfill.h"
+#include "span.h"
+#include "guikit/damage.h"
+#include "guikit/graphics.h"
+#include "guikit/primrect.h"
+#include "guikit/ptypes.h"
+#include <stddef.h>
+
+struct Fill
+{
+    const struct Raster *r;
+    u32 mask; /* The bits of a pixel that make up its color */
+    u32 pen;
+    u32 old; /* The color being filled over, for FloodFill() */
+    u32 border; /* The color to stop at, for BoundaryFill() */
+    int boundary;
+    struct Rect damage;
+    int filled;
+};
+
+static u32 readPixel(const struct Raster *r, int x, int y)
+{
+    const u8 *row = r->pixels + y * r->pitch;
+
+    switch (r->format)
+    {
+    case PIXEL_FORMAT_INDEX8:
+        return row[x];
+    case PIXEL_FORMAT_BGR555:
+        return ((const u16 *)row)[x];
+    case PIXEL_FORMAT_XRGB8888:
+    default:
+        return ((const u32 *)row)[x];
+    }
+}
+
+static int isInside(int x, int y, void *ctx)
+{
+    const struct Fill *f = ctx;
+    u32 p = readPixel(f->r, x, y) & f->mask;
+
+    return f->boundary ? p != f->border && p != f->pen : p == f->old;
+}
+
+static void fillRun(int left, int y, int width, void *ctx)
+{
+    struct Fill *f = ctx;
+    int right = left + width - 1;
+    struct Rect run;
+
+    spanWriter(f->r->format)->hline(f->r, left, y, width);
+
+    InitRect(&run, left, y, width, 1);
+    if (!f->filled)
+    {
+        f->damage = run;
+        f->filled = 1;
+        return;
+    }
+    f->damage.left = left < f->damage.left ? left : f->damage.left;
+    f->damage.right = right > f->damage.right ? right : f->damage.right;
+    f->damage.top = y < f->damage.top ? y : f->damage.top;
+    f->damage.bottom = y > f->damage.bottom ? y : f->damage.bottom;
+}
+
+static void fill(int x, int y, int boundary, int borderColor)
+{
+    struct Fill f;
+    const struct Rect *clip = &screenRaster.clip;
+
+    if (x < clip->left || x > clip->right || y < clip->top ||
+        y > clip->bottom)
+    {
+        return;
+    }
+
+    f.r = &screenRaster;
+    f.mask = screenRaster.format == PIXEL_FORMAT_XRGB8888 ? 0xFFFFFFU :
+             screenRaster.format == PIXEL_FORMAT_BGR555 ? 0x7FFFU : 0xFFU;
+    f.pen = screenRaster.color & f.mask;
+    f.old = readPixel(&screenRaster, x, y) & f.mask;
+    f.border = boundary ? rasterColor(borderColor) & f.mask : 0;
+    f.boundary = boundary;
+    f.filled = 0;
+
+    /* Filling over the pen's own color would never run out of pixels. */
+    if (!isInside(x, y, &f) || (!boundary && f.old == f.pen))
+    {
+        return;
+    }
+
+    seedFill(x, y, clip, isInside, fillRun, &f);
+    AddDamage(&f.damage);
+}
+
+int FloodFill(int x, int y)
+{
+    if (recording)
+    {
+        recordInts(CMD_FLOOD_FILL, x, y, 0, 0, 0);
+        return 0;
+    }
+
+    fill(x, y, 0, 0);
+
+    return 0;
+}
+
+int BoundaryFill(int x, int y, int borderColor)
+{
+    if (recording)
+    {
+        recordInts(CMD_BOUNDARY_FILL, x, y, borderColor, 0, 0);
+        return 0;
+    }
+
+    fill(x, y, 1, borderColor);
+
+    return 0;
+}
@@ -8,6 +8,8 @@
 
 #include "guikit/font.h"
 
+#include "atlas.h"
+#include "record.h"
 #include "guikit/bmp.h"
 #include "guikit/debug.h"
 #include "guikit/graphics.h"
@@ -550,6 +552,7 @@ void FreeFont(struct Font *font)
     /* Free the font's memory */
     if (font)
     {
+        atlasForget(font->img);
         free(font->g);
     }
 
@@ -623,7 +626,14 @@ int DrawString(const struct Font *font, const char *s, int x, int y)
         dst.right = dst.left + src.right - src.left;
         dst.left += g->offset;
         dst.right += g->offset;
-        BlitOp(font->img, OP_SRC_INV, &dst, &src, ss);
+        if (recording)
+        {
+            recordGlyph(font->img, ss, font->height, &dst, &src);
+        }
+        else if (atlasBlit(font->img, ss, font->height, &dst, &src))
+        {
+            BlitOp(font->img, OP_SRC_INV, &dst, &src, ss);
+        }
         dst.left += g->width - g->offset;
         dst.right += g->width - g->offset;
     }
@@ -0,0 +1,737 @@
+/*
+ *  graphics.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+/* A graphics backend that renders into plain memory. There is no window,
+ * renderer, or vsync, so it's useful for running on machines without a
+ * display and for measuring how long rendering takes by itself. */
+
+#include "guikit/graphics.h"
+#include "guikit/damage.h"
+#include "guikit/panic.h"
+#include "guikit/pmemory.h"
+#include "guikit/primrect.h"
+#include "guikit/ptypes.h"
+#include "atlas.h"
+#include "expand.h"
+#include "polygon.h"
+#include "raster.h"
+#include "record.h"
+#include "workers.h"
+#include <stdio.h>
+
+static const struct RGB mac_pal[] = {
+    {0x00, 0x00, 0x00}, /* Black */
+    {0x20, 0x20, 0x20}, /* Dark Gray */
+    {0x80, 0x80, 0x80}, /* Gray */
+    {0xC0, 0xC0, 0xC0}, /* Light Gray */
+    {0x90, 0x71, 0x3A}, /* Light Brown */
+    {0x56, 0x2C, 0x05}, /* Brown */
+    {0x00, 0x64, 0x11}, /* Dark Green */
+    {0x1F, 0xB7, 0x14}, /* Green */
+    {0x02, 0xAB, 0xEA}, /* Light Blue */
+    {0x00, 0x00, 0xD4}, /* Blue */
+    {0x46, 0x00, 0xA5}, /* Purple */
+    {0xF2, 0x08, 0x84}, /* Pink */
+    {0xDD, 0x08, 0x06}, /* Red */
+    {0xFF, 0x64, 0x02}, /* Orange */
+    {0xFC, 0xF3, 0x05}, /* Yellow */
+    {0xFF, 0xFF, 0xFF}  /* White */
+};
+
+const unsigned char blackPattern[] = {0, 0, 0, 0, 0, 0, 0, 0};
+
+static u8 *pixels;
+static int pitch;
+static int format;
+static u32 penColor;
+static struct Rect screen;
+
+/* What each pixel of an indexed screen stands for. Entries past the COLOR_*
+ * colors repeat them, as indices used to wrap around. */
+static struct RGB palette[PALETTE_SIZE];
+
+/* An 8x8 1-bit bitmap, packed 1bpp */
+static const unsigned char *currentPattern;
+
+static u32 packBGR555(u8 r, u8 g, u8 b)
+{
+    return (r >> 3) | ((g >> 3) << 5) | ((b >> 3) << 10);
+}
+
+static u32 packXRGB8888(u8 r, u8 g, u8 b)
+{
+    return (u32)r << 16 | (u32)g << 8 | b;
+}
+
+static u32 nearestColor(u8 r, u8 g, u8 b)
+{
+    int i;
+    int best;
+    long bestDist;
+
+    best = 0;
+    bestDist = -1;
+    for (i = 0; i < NUM_COLORS; ++i)
+    {
+        long dr = (long)palette[i].r - r;
+        long dg = (long)palette[i].g - g;
+        long db = (long)palette[i].b - b;
+        long dist = dr * dr + dg * dg + db * db;
+
+        if (bestDist < 0 || dist < bestDist)
+        {
+            best = i;
+            bestDist = dist;
+        }
+    }
+
+    return best;
+}
+
+/* Convert an RGB color to the framebuffer's pixel format */
+static u32 packColor(u8 r, u8 g, u8 b)
+{
+    switch (format)
+    {
+    case PIXEL_FORMAT_INDEX8:
+        return nearestColor(r, g, b);
+    case PIXEL_FORMAT_XRGB8888:
+        return packXRGB8888(r, g, b);
+    case PIXEL_FORMAT_BGR555:
+    default:
+        return packBGR555(r, g, b);
+    }
+}
+
+static u32 nativeColor(int color)
+{
+    const struct RGB *c;
+
+    if (format == PIXEL_FORMAT_INDEX8)
+    {
+        return color;
+    }
+
+    c = &mac_pal[color & 0xF];
+    return packColor(c->r, c->g, c->b);
+}
+
+u32 rasterColor(int color)
+{
+    return nativeColor(color);
+}
+
+u32 rasterRGB(u8 r, u8 g, u8 b)
+{
+    return packColor(r, g, b);
+}
+
+static void putPixel(int x, int y, u32 color)
+{
+    switch (format)
+    {
+    case PIXEL_FORMAT_INDEX8:
+        pixels[y * pitch + x] = (u8)color;
+        break;
+    case PIXEL_FORMAT_XRGB8888:
+        ((u32 *)(pixels + y * pitch))[x] = color;
+        break;
+    case PIXEL_FORMAT_BGR555:
+    default:
+        ((u16 *)(pixels + y * pitch))[x] = (u16)color;
+        break;
+    }
+}
+
+static void getRGB(int x, int y, u8 *r, u8 *g, u8 *b)
+{
+    if (format == PIXEL_FORMAT_INDEX8)
+    {
+        const struct RGB *c = &palette[pixels[y * pitch + x]];
+
+        *r = c->r;
+        *g = c->g;
+        *b = c->b;
+    }
+    else if (format == PIXEL_FORMAT_XRGB8888)
+    {
+        u32 p = ((const u32 *)(pixels + y * pitch))[x];
+
+        *r = (u8)(p >> 16);
+        *g = (u8)(p >> 8);
+        *b = (u8)p;
+    }
+    else
+    {
+        u16 p = ((const u16 *)(pixels + y * pitch))[x];
+
+        *r = (u8)(((p >> 0) & 0x1F) << 3);
+        *g = (u8)(((p >> 5) & 0x1F) << 3);
+        *b = (u8)(((p >> 10) & 0x1F) << 3);
+    }
+}
+
+int InitGraphicsEx(const struct GraphicsMode *mode)
+{
+    int i;
+
+    if (mode->width <= 0 || mode->height <= 0 || mode->format < 0 ||
+        mode->format >= NUM_PIXEL_FORMATS)
+    {
+        return -1;
+    }
+
+    /* There is no window to put the title on, nor anything to present to, so
+     * the rest of the mode doesn't matter. */
+
+    currentPattern = blackPattern;
+
+    for (i = 0; i < PALETTE_SIZE; ++i)
+    {
+        palette[i] = mac_pal[i % NUM_COLORS];
+    }
+
+    format = mode->format;
+    pitch = mode->width * bytesPerPixel(format);
+    pixels = pcalloc(mode->height, pitch);
+    rasterInit(pixels, pitch, format, mode->width, mode->height);
+
+    InitRect(&screen, 0, 0, mode->width, mode->height);
+    SetDamageBounds(&screen);
+
+    SetColor(COLOR_WHITE);
+    FillScreen();
+    SetColor(COLOR_BLACK);
+
+    ShowGraphics();
+
+    return 0;
+}
+
+static int init(int pixelFormat)
+{
+    struct GraphicsMode mode;
+
+    mode.width = SCREEN_WIDTH;
+    mode.height = SCREEN_HEIGHT;
+    mode.format = pixelFormat;
+    mode.title = NULL;
+    mode.flags = 0;
+
+    return InitGraphicsEx(&mode);
+}
+
+int InitGraphicsBGR555(const char *name)
+{
+    (void)name; /* There is no window to put the name on. */
+
+    return init(PIXEL_FORMAT_BGR555);
+}
+
+int InitGraphics(void)
+{
+    return init(PIXEL_FORMAT_INDEX8);
+}
+
+void FreeGraphics(void)
+{
+    stopWorkers();
+    atlasFlush();
+    polygonFree();
+    pfree(pixels);
+    pixels = NULL;
+}
+
+void ShowGraphics(void)
+{
+    /* Nothing to copy anywhere; the framebuffer is the screen. */
+    ClearDamage();
+}
+
+void rasterClipChanged(void)
+{
+    /* All drawing goes through screenRaster, which already clips to it. */
+}
+
+static int checkPalette(int first, int count)
+{
+    if (format != PIXEL_FORMAT_INDEX8 || first < 0 || count < 0 ||
+        first + count > PALETTE_SIZE)
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+int SetPaletteEntries(int first, int count, const struct RGB *colors)
+{
+    int i;
+
+    if (checkPalette(first, count))
+    {
+        return -1;
+    }
+
+    for (i = 0; i < count; ++i)
+    {
+        palette[first + i] = colors[i];
+    }
+    rasterPaletteChanged();
+
+    /* The pixels are the screen, so the change is seen straight away. */
+    return 0;
+}
+
+int GetPaletteEntries(int first, int count, struct RGB *colors)
+{
+    int i;
+
+    if (checkPalette(first, count))
+    {
+        return -1;
+    }
+
+    for (i = 0; i < count; ++i)
+    {
+        colors[i] = palette[first + i];
+    }
+
+    return 0;
+}
+
+int GetScreenWidth(void)
+{
+    return screen.right + 1;
+}
+
+int GetScreenHeight(void)
+{
+    return screen.bottom + 1;
+}
+
+void *GetFrameBuffer(int *pitchOut, int *formatOut)
+{
+    *pitchOut = pitch;
+    *formatOut = format;
+
+    return pixels;
+}
+
+static void putLE(FILE *f, u32 value, int bytes)
+{
+    int i;
+
+    for (i = 0; i < bytes; ++i)
+    {
+        fputc((value >> (8 * i)) & 0xFF, f);
+    }
+}
+
+int SaveScreenShot(const char *path)
+{
+    enum {
+        HEADER_SIZE = 14,
+        DIB_SIZE = 40
+    };
+    FILE *f;
+    int width;
+    int height;
+    long rowSize;
+    int x;
+    int y;
+    int ret;
+
+    width = GetScreenWidth();
+    height = GetScreenHeight();
+    rowSize = ((long)width * 3 + 3) & ~3L; /* Rows are padded to 4 bytes */
+
+    f = fopen(path, "wb");
+    if (!f)
+    {
+        printf("Couldn't open %s for writing\n", path);
+        return -1;
+    }
+
+    /* Write a 24-bit uncompressed Windows BMP. */
+    fputc('B', f);
+    fputc('M', f);
+    putLE(f, HEADER_SIZE + DIB_SIZE + rowSize * height, 4);
+    putLE(f, 0, 4); /* Reserved */
+    putLE(f, HEADER_SIZE + DIB_SIZE, 4); /* Pixels offset */
+
+    putLE(f, DIB_SIZE, 4);
+    putLE(f, width, 4);
+    putLE(f, height, 4);
+    putLE(f, 1, 2); /* Planes */
+    putLE(f, 24, 2); /* Bits per pixel */
+    putLE(f, 0, 4); /* No compression */
+    putLE(f, rowSize * height, 4);
+    putLE(f, 0, 4); /* Horizontal resolution */
+    putLE(f, 0, 4); /* Vertical resolution */
+    putLE(f, 0, 4); /* Colors in palette */
+    putLE(f, 0, 4); /* Important colors */
+
+    /* BMP rows go from bottom to top. */
+    for (y = height - 1; y >= 0; --y)
+    {
+        for (x = 0; x < width; ++x)
+        {
+            u8 r;
+            u8 g;
+            u8 b;
+
+            getRGB(x, y, &r, &g, &b);
+            fputc(b, f);
+            fputc(g, f);
+            fputc(r, f);
+        }
+        for (x = width * 3; x < rowSize; ++x)
+        {
+            fputc(0, f);
+        }
+    }
+
+    ret = ferror(f) ? -1 : 0;
+    if (fclose(f))
+    {
+        ret = -1;
+    }
+
+    return ret;
+}
+
+void SetColor(int color)
+{
+    notePenColor(color);
+    penColor = nativeColor(color);
+    screenRaster.color = penColor;
+}
+
+void rasterSetPenRGB(u8 r, u8 g, u8 b, u32 color)
+{
+    notePenRGB(r, g, b);
+    penColor = color;
+    screenRaster.color = penColor;
+}
+
+void SetColorRGB(unsigned char r, unsigned char g, unsigned char b)
+{
+    rasterSetPenRGB(r, g, b, packColor(r, g, b));
+}
+
+void FillScreen(void)
+{
+    if (recording)
+    {
+        recordInts(CMD_FILL_SCREEN, 0, 0, 0, 0, 0);
+        return;
+    }
+
+    rasterFillRect(&screenRaster, &screen);
+    AddDamage(&screen);
+}
+
+static int bit(const unsigned char *img, int spanBytes, int x, int y)
+{
+    return img[y * spanBytes + x / 8] & (0x80 >> (x % 8));
+}
+
+static void checkBlitSize(const struct Rect *dst, const struct Rect *src)
+{
+    if (src->right - src->left != dst->right - dst->left)
+    {
+        panic("Blit width mismatch. Not supported.");
+    }
+    if (src->bottom - src->top != dst->bottom - dst->top)
+    {
+        panic("Blit height mismatch. Not supported.");
+    }
+}
+
+/* Which of a blit's colors each pixel of an expanded row gets */
+enum {
+    BLIT_CLEAR, /* Left as it is */
+    BLIT_OFF,
+    BLIT_ON,
+    BLIT_CHUNK = 64 /* Source bytes expanded at a time */
+};
+
+/* Draw width pixels of 1bpp source from (x, y), starting colInByte pixels into
+ * the first byte of img. Rows are expanded a chunk of bytes at a time, with op
+ * applied to each source byte on the way. Pixels with a clear bit in mask, if
+ * given, are left alone, and the rest get colors[BLIT_ON] where img is set and
+ * colors[off] where it isn't. */
+static void blitRow(int x, int y, const u8 *img, const u8 *mask,
+                    int colInByte, int width, int op, size_t row, u8 off,
+                    const u32 *colors)
+{
+    const struct SpanWriter *spans = spanWriter(format);
+    struct Raster r;
+    u8 ops[BLIT_CHUNK];
+    u8 codes[BLIT_CHUNK * 8];
+    const u8 *bits;
+    int bytes;
+    int count;
+    int n;
+    int i;
+
+    r.pixels = pixels;
+    r.pitch = pitch;
+    r.format = format;
+
+    bytes = (colInByte + width + 7) / 8;
+    while (bytes > 0)
+    {
+        n = bytes < BLIT_CHUNK ? bytes : BLIT_CHUNK;
+
+        bits = img;
+        if (op != OP_NONE)
+        {
+            for (i = 0; i < n; ++i)
+            {
+                ops[i] = rasterOp(op, img[i], currentPattern, row);
+            }
+            bits = ops;
+        }
+
+        if (mask)
+        {
+            expandBitsMasked(codes, bits, mask, n, BLIT_ON, off, BLIT_CLEAR);
+            mask += n;
+        }
+        else
+        {
+            expandBits(codes, bits, n, BLIT_ON, off);
+        }
+
+        /* Write each run of one code straight into the row. */
+        count = n * 8 - colInByte < width ? n * 8 - colInByte : width;
+        i = 0;
+        while (i < count)
+        {
+            u8 code = codes[colInByte + i];
+            int start = i;
+
+            do
+            {
+                ++i;
+            } while (i < count && codes[colInByte + i] == code);
+
+            if (code != BLIT_CLEAR)
+            {
+                r.color = colors[code];
+                spans->hline(&r, x + start, y, i - start);
+            }
+        }
+
+        x += count;
+        width -= count;
+        img += n;
+        bytes -= n;
+        colInByte = 0;
+    }
+}
+
+/* Draw the src part of a 1bpp bitmap at dst, both already clipped. */
+static void blitRows(const struct Rect *dst, const struct Rect *src,
+                     const u8 *img, const u8 *mask, int spanBytes, int op,
+                     int patternTop, u8 off, const u32 *colors)
+{
+    int width = dst->right - dst->left + 1;
+    int y;
+
+    for (y = 0; y <= dst->bottom - dst->top; ++y)
+    {
+        size_t offset = (size_t)(src->top + y) * spanBytes + src->left / 8;
+
+        blitRow(dst->left, dst->top + y, img + offset,
+                mask ? mask + offset : NULL, src->left % 8, width, op,
+                src->top + y - patternTop, off, colors);
+    }
+}
+
+int BlitWithMask(const unsigned char *img, const unsigned char *mask,
+                 const struct Rect *dst0, const struct Rect *src0, int span)
+{
+    struct Rect dst;
+    struct Rect src;
+    int spanBytes;
+    u32 colors[3];
+
+    if (recording)
+    {
+        recordBlit(CMD_BLIT_WITH_MASK, img, mask, OP_NONE, dst0, src0, span);
+        return 0;
+    }
+
+    spanBytes = (span + 7) / 8; /* Convert to bytes */
+
+    checkBlitSize(dst0, src0);
+
+    AddDamage(dst0);
+
+    dst = *dst0;
+    src = *src0;
+    if (ClipRectAdjust(&dst, &src, &screenRaster.clip) == CLIP_REJECTED)
+    {
+        return 0;
+    }
+
+    /* Like a stencil. Wherever both the image and mask are set gets the
+     * color. */
+    colors[BLIT_CLEAR] = 0;
+    colors[BLIT_OFF] = 0;
+    colors[BLIT_ON] = penColor;
+    blitRows(&dst, &src, img, mask, spanBytes, OP_NONE, src.top, BLIT_CLEAR,
+             colors);
+
+    return 0;
+}
+
+int Blit(const unsigned char *img, const struct Rect *dst0,
+         const struct Rect *src0, int span)
+{
+    return BlitOp(img, OP_NONE, dst0, src0, span);
+}
+
+int BlitOp(const unsigned char *img, int op, const struct Rect *dst0,
+           const struct Rect *src0, int span)
+{
+    struct Rect dst;
+    struct Rect src;
+    int spanBytes;
+    u32 colors[3];
+
+    if (recording)
+    {
+        recordBlit(CMD_BLIT_OP, img, NULL, op, dst0, src0, span);
+        return 0;
+    }
+
+    spanBytes = (span + 7) / 8; /* Convert to bytes */
+
+    checkBlitSize(dst0, src0);
+
+    AddDamage(dst0);
+
+    dst = *dst0;
+    src = *src0;
+    if (ClipRectAdjust(&dst, &src, &screenRaster.clip) == CLIP_REJECTED)
+    {
+        return 0;
+    }
+
+    /* Like a stencil. Wherever is set goes through to the color. Patterns
+     * start at the unclipped top. */
+    colors[BLIT_CLEAR] = 0;
+    colors[BLIT_OFF] = 0;
+    colors[BLIT_ON] = penColor;
+    blitRows(&dst, &src, img, NULL, spanBytes, op, src0->top, BLIT_CLEAR,
+             colors);
+
+    return 0;
+}
+
+int DrawBitmap(const struct Rect *dst0, int span, const unsigned char *img,
+               const unsigned char *mask)
+{
+    struct Rect dst;
+    struct Rect src;
+    int spanBytes;
+    u32 colors[3];
+
+    if (recording)
+    {
+        recordBlit(CMD_DRAW_BITMAP, img, mask, OP_NONE, dst0, NULL, span);
+        return 0;
+    }
+
+    spanBytes = (span + 7) / 8; /* Convert to bytes */
+
+    AddDamage(dst0);
+
+    /* The bitmap is never wider than its span. */
+    dst = *dst0;
+    if (dst.right - dst.left + 1 > span)
+    {
+        dst.right = dst.left + span - 1;
+    }
+    InitRect(&src, 0, 0, dst.right - dst.left + 1, dst.bottom - dst.top + 1);
+    if (ClipRectAdjust(&dst, &src, &screenRaster.clip) == CLIP_REJECTED)
+    {
+        return 0;
+    }
+
+    colors[BLIT_CLEAR] = 0;
+    colors[BLIT_OFF] = penColor;
+    colors[BLIT_ON] = nativeColor(COLOR_WHITE);
+    blitRows(&dst, &src, img, mask, spanBytes, OP_NONE, 0, BLIT_OFF, colors);
+
+    return 0;
+}
+
+int DrawColorBitmap(const struct Rect *dst0, int span, const unsigned char *img,
+                    const unsigned char *mask)
+{
+    struct Rect dst;
+    struct Rect src;
+    int x;
+    int y;
+    int spanBytes;
+    size_t planeSize;
+
+    if (recording)
+    {
+        recordBlit(CMD_DRAW_COLOR_BITMAP, img, mask, OP_NONE, dst0, NULL,
+                   span);
+        return 0;
+    }
+
+    spanBytes = (span + 7) / 8; /* Convert to bytes */
+    planeSize = (size_t)spanBytes * (dst0->bottom - dst0->top + 1);
+
+    AddDamage(dst0);
+
+    /* The bitmap is never wider than its span. */
+    dst = *dst0;
+    if (dst.right - dst.left + 1 > span)
+    {
+        dst.right = dst.left + span - 1;
+    }
+    InitRect(&src, 0, 0, dst.right - dst.left + 1, dst.bottom - dst.top + 1);
+    if (ClipRectAdjust(&dst, &src, &screenRaster.clip) == CLIP_REJECTED)
+    {
+        return 0;
+    }
+
+    /* The image is made of 4 planes, one for each bit of the color. */
+    for (y = 0; y <= dst.bottom - dst.top; ++y)
+    {
+        for (x = 0; x <= dst.right - dst.left; ++x)
+        {
+            int sx = src.left + x;
+            int sy = src.top + y;
+            int color;
+
+            if (!bit(mask, spanBytes, sx, sy))
+            {
+                continue;
+            }
+
+            color = (bit(img + 0 * planeSize, spanBytes, sx, sy) ? 1 : 0) |
+                    (bit(img + 1 * planeSize, spanBytes, sx, sy) ? 2 : 0) |
+                    (bit(img + 2 * planeSize, spanBytes, sx, sy) ? 4 : 0) |
+                    (bit(img + 3 * planeSize, spanBytes, sx, sy) ? 8 : 0);
+
+            putPixel(dst.left + x, dst.top + y, nativeColor(color));
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,227 @@
+/*
+ *  threads.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#if defined(GUIKIT_PTHREADS)
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "threads.h"
+
+#include <stddef.h>
+
+#if defined(GUIKIT_PTHREADS)
+
+#include "guikit/panic.h"
+#include "guikit/pmemory.h"
+#include <pthread.h>
+#include <unistd.h>
+
+struct Thread
+{
+    pthread_t thread;
+    void (*fn)(void);
+};
+
+struct Mutex
+{
+    pthread_mutex_t mutex;
+};
+
+struct Cond
+{
+    pthread_cond_t cond;
+};
+
+int cpuCount(void)
+{
+#if defined(_SC_NPROCESSORS_ONLN)
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (n > 1)
+    {
+        return (int)n;
+    }
+#endif
+
+    return 1;
+}
+
+static void *threadMain(void *arg)
+{
+    struct Thread *thread = arg;
+
+    thread->fn();
+
+    return NULL;
+}
+
+struct Thread *startThread(void (*fn)(void))
+{
+    struct Thread *thread;
+
+    thread = pmalloc(sizeof(*thread));
+    thread->fn = fn;
+    if (pthread_create(&thread->thread, NULL, threadMain, thread) != 0)
+    {
+        panic("Couldn't start a render thread.");
+    }
+
+    return thread;
+}
+
+void joinThread(struct Thread *thread)
+{
+    pthread_join(thread->thread, NULL);
+    pfree(thread);
+}
+
+struct Mutex *newMutex(void)
+{
+    struct Mutex *mutex;
+
+    mutex = pmalloc(sizeof(*mutex));
+    if (pthread_mutex_init(&mutex->mutex, NULL) != 0)
+    {
+        panic("Couldn't make a mutex.");
+    }
+
+    return mutex;
+}
+
+void freeMutex(struct Mutex *mutex)
+{
+    pthread_mutex_destroy(&mutex->mutex);
+    pfree(mutex);
+}
+
+void lockMutex(struct Mutex *mutex)
+{
+    pthread_mutex_lock(&mutex->mutex);
+}
+
+void unlockMutex(struct Mutex *mutex)
+{
+    pthread_mutex_unlock(&mutex->mutex);
+}
+
+struct Cond *newCond(void)
+{
+    struct Cond *cond;
+
+    cond = pmalloc(sizeof(*cond));
+    if (pthread_cond_init(&cond->cond, NULL) != 0)
+    {
+        panic("Couldn't make a condition variable.");
+    }
+
+    return cond;
+}
+
+void freeCond(struct Cond *cond)
+{
+    pthread_cond_destroy(&cond->cond);
+    pfree(cond);
+}
+
+void waitCond(struct Cond *cond, struct Mutex *mutex)
+{
+    pthread_cond_wait(&cond->cond, &mutex->mutex);
+}
+
+void signalCond(struct Cond *cond)
+{
+    pthread_cond_signal(&cond->cond);
+}
+
+void broadcastCond(struct Cond *cond)
+{
+    pthread_cond_broadcast(&cond->cond);
+}
+
+#else
+
+/* Without threads, everything happens on the calling thread. No thread ever
+ * starts, so nothing ever waits, and locking has nothing to keep out. */
+
+struct Mutex
+{
+    int unused;
+};
+
+struct Cond
+{
+    int unused;
+};
+
+static struct Mutex noMutex;
+static struct Cond noCond;
+
+int cpuCount(void)
+{
+    return 1;
+}
+
+struct Thread *startThread(void (*fn)(void))
+{
+    (void)fn;
+
+    return NULL;
+}
+
+void joinThread(struct Thread *thread)
+{
+    (void)thread;
+}
+
+struct Mutex *newMutex(void)
+{
+    return &noMutex;
+}
+
+void freeMutex(struct Mutex *mutex)
+{
+    (void)mutex;
+}
+
+void lockMutex(struct Mutex *mutex)
+{
+    (void)mutex;
+}
+
+void unlockMutex(struct Mutex *mutex)
+{
+    (void)mutex;
+}
+
+struct Cond *newCond(void)
+{
+    return &noCond;
+}
+
+void freeCond(struct Cond *cond)
+{
+    (void)cond;
+}
+
+void waitCond(struct Cond *cond, struct Mutex *mutex)
+{
+    (void)cond;
+    (void)mutex;
+}
+
+void signalCond(struct Cond *cond)
+{
+    (void)cond;
+}
+
+void broadcastCond(struct Cond *cond)
+{
+    (void)cond;
+}
+
+#endif
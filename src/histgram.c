@@ -21,6 +21,7 @@ struct Histogram
     int minValue; /* Least a value can be (x max). Smallest value displayed. */
     size_t numBuckets; /* How many different buckets */
     int *buckets;
+    struct Rect *bars; /* One per bucket, for drawing */
 };
 
 struct Histogram *HistogramAlloc(size_t numBuckets)
@@ -40,6 +41,7 @@ struct Histogram *HistogramAlloc(size_t numBuckets)
     h->maxValue = 200;
     h->minValue = 0;
     h->buckets = NULL;
+    h->bars = pmalloc(numBuckets * sizeof(*h->bars));
 
     array_grow(h->buckets, h->numBuckets);
     for (i = 0; i < h->numBuckets; ++i)
@@ -55,6 +57,7 @@ void HistogramFree(struct Histogram *h)
     if (h)
     {
         array_free(h->buckets);
+        pfree(h->bars);
     }
 
     pfree(h);
@@ -136,10 +139,9 @@ int HistogramGet(const struct Histogram *h, size_t which)
     return h->buckets[which];
 }
 
-static void drawBucket(int bval, int bwidth, int maxSize, int color, int x,
-                       int y, int height)
+static void makeBar(struct Rect *bar, int bval, int bwidth, int maxSize,
+                    int x, int y, int height)
 {
-    struct Rect bar;
     int bheight;
 
     if (maxSize == 0)
@@ -152,17 +154,14 @@ static void drawBucket(int bval, int bwidth, int maxSize, int color, int x,
     printf("bheight %d (%d * %d / %d)\n", bheight, height, bval, maxSize);
 #endif
 
-    bar.left = x;
-    bar.right = bar.left + bwidth - 1;
-    bar.bottom = y;
-    bar.top = y - bheight + 1;
+    bar->left = x;
+    bar->right = bar->left + bwidth - 1;
+    bar->bottom = y;
+    bar->top = y - bheight + 1;
 #if 0
-    printf("l %d  r %d  b %d  t %d\n", bar.left, bar.right, bar.bottom,
-           bar.top);
+    printf("l %d  r %d  b %d  t %d\n", bar->left, bar->right, bar->bottom,
+           bar->top);
 #endif
-
-    SetColor(color);
-    FillRect(&bar);
 }
 
 static void drawBuckets(const struct Histogram *h, int color,
@@ -193,9 +192,12 @@ static void drawBuckets(const struct Histogram *h, int color,
         {
             panic("Too big bucket. Max func broken\n");
         }
-        drawBucket(h->buckets[i], bwidth, maxSize, color, x, y, height);
+        makeBar(&h->bars[i], h->buckets[i], bwidth, maxSize, x, y, height);
         x += bwidth;
     }
+
+    SetColor(color);
+    FillRects(h->bars, h->numBuckets);
 }
 
 void DrawHistogram(const struct Histogram *h, int color,
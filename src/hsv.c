@@ -0,0 +1,165 @@
+/*
+ *  hsv.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "hsv.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define HSV_SSE2 1
+#endif
+
+/* The color wheel is split into 6 sectors of 43 hues each (the last one is
+ * a bit short). Divisions are done with multiplies and shifts, which give
+ * exactly the same results as dividing for every value that can come up:
+ * x / 43 for x up to 255, and x / 255 for x up to 255 * 255. */
+static unsigned int div43(unsigned int x)
+{
+    return (x * 191) >> 13;
+}
+
+static unsigned int div255(unsigned int x)
+{
+    return (x + 1 + (x >> 8)) >> 8;
+}
+
+void hsvToRGB(u8 h, u8 s, u8 v, u8 *r, u8 *g, u8 *b)
+{
+    const unsigned int hi = div43(h);
+    const unsigned int hj = (h - hi * 43) * 6;
+    const unsigned int p = div255(v * (255 - s));
+    const unsigned int q = div255(v * (255 - div255(s * hj)));
+    const unsigned int t = div255(v * (255 - div255(s * (255 - hj))));
+
+    switch (hi)
+    {
+        case 0:
+            *r = v;
+            *g = t;
+            *b = p;
+            break;
+        case 1:
+            *r = q;
+            *g = v;
+            *b = p;
+            break;
+        case 2:
+            *r = p;
+            *g = v;
+            *b = t;
+            break;
+        case 3:
+            *r = p;
+            *g = q;
+            *b = v;
+            break;
+        case 4:
+            *r = t;
+            *g = p;
+            *b = v;
+            break;
+        case 5:
+        default:
+            *r = v;
+            *g = p;
+            *b = q;
+            break;
+    }
+}
+
+#if HSV_SSE2
+/* x / 255, for 8 values of x up to 255 * 255 */
+static __m128i div255x8(__m128i x)
+{
+    const __m128i one = _mm_set1_epi16(1);
+
+    x = _mm_add_epi16(_mm_add_epi16(x, one), _mm_srli_epi16(x, 8));
+    return _mm_srli_epi16(x, 8);
+}
+
+/* Pick a from lanes where mask is set, or leave sum as is. */
+static __m128i pick(__m128i sum, __m128i mask, __m128i a)
+{
+    return _mm_or_si128(sum, _mm_and_si128(mask, a));
+}
+#endif
+
+void hsvToXRGB8888(u32 *dst, const u8 *hsv, size_t count)
+{
+#if HSV_SSE2
+    {
+        const __m128i max = _mm_set1_epi16(255);
+        const __m128i six = _mm_set1_epi16(6);
+        const __m128i k43 = _mm_set1_epi16(43);
+        const __m128i k191 = _mm_set1_epi16(191);
+
+        /* 8 colors at a time, each channel in 16 bit lanes */
+        for (; count >= 8; count -= 8, hsv += 24, dst += 8)
+        {
+            __m128i h, s, v;
+            __m128i hi, hj, p, q, t;
+            __m128i r, g, b;
+            __m128i sector[6];
+            int i;
+
+            /* SSE2 has no byte shuffles to split up the channels with. */
+            h = _mm_setr_epi16(hsv[0], hsv[3], hsv[6], hsv[9], hsv[12],
+                               hsv[15], hsv[18], hsv[21]);
+            s = _mm_setr_epi16(hsv[1], hsv[4], hsv[7], hsv[10], hsv[13],
+                               hsv[16], hsv[19], hsv[22]);
+            v = _mm_setr_epi16(hsv[2], hsv[5], hsv[8], hsv[11], hsv[14],
+                               hsv[17], hsv[20], hsv[23]);
+
+            hi = _mm_srli_epi16(_mm_mullo_epi16(h, k191), 13);
+            hj = _mm_mullo_epi16(_mm_sub_epi16(h, _mm_mullo_epi16(hi, k43)),
+                                 six);
+            p = div255x8(_mm_mullo_epi16(v, _mm_sub_epi16(max, s)));
+            q = div255x8(_mm_mullo_epi16(
+                    v, _mm_sub_epi16(max, div255x8(_mm_mullo_epi16(s, hj)))));
+            t = div255x8(_mm_mullo_epi16(
+                    v, _mm_sub_epi16(max, div255x8(_mm_mullo_epi16(
+                                             s, _mm_sub_epi16(max, hj))))));
+
+            for (i = 0; i < 6; ++i)
+            {
+                sector[i] = _mm_cmpeq_epi16(hi, _mm_set1_epi16(i));
+            }
+
+            r = _mm_and_si128(_mm_or_si128(sector[0], sector[5]), v);
+            r = pick(r, sector[1], q);
+            r = pick(r, _mm_or_si128(sector[2], sector[3]), p);
+            r = pick(r, sector[4], t);
+
+            g = _mm_and_si128(sector[0], t);
+            g = pick(g, _mm_or_si128(sector[1], sector[2]), v);
+            g = pick(g, sector[3], q);
+            g = pick(g, _mm_or_si128(sector[4], sector[5]), p);
+
+            b = _mm_and_si128(_mm_or_si128(sector[0], sector[1]), p);
+            b = pick(b, sector[2], t);
+            b = pick(b, _mm_or_si128(sector[3], sector[4]), v);
+            b = pick(b, sector[5], q);
+
+            /* Green and blue make the low half of each pixel, red the
+             * high. */
+            g = _mm_or_si128(_mm_slli_epi16(g, 8), b);
+            _mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi16(g, r));
+            _mm_storeu_si128((__m128i *)&dst[4], _mm_unpackhi_epi16(g, r));
+        }
+    }
+#endif
+
+    for (; count > 0; --count, hsv += 3, ++dst)
+    {
+        u8 r;
+        u8 g;
+        u8 b;
+
+        hsvToRGB(hsv[0], hsv[1], hsv[2], &r, &g, &b);
+        *dst = (u32)r << 16 | (u32)g << 8 | b;
+    }
+}
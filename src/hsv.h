@@ -0,0 +1,23 @@
+/*
+ *  hsv.h
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef HSV_H
+#define HSV_H
+
+#include "guikit/ptypes.h"
+#include <stddef.h>
+
+/* Convert a color from hue, saturation, and value to red, green, and blue,
+ * each from 0 to 255. Hue goes once around the color wheel from 0 to 255. */
+void hsvToRGB(u8 h, u8 s, u8 v, u8 *r, u8 *g, u8 *b);
+
+/* Convert count colors, stored as 3 bytes each (h, s, v), to XRGB8888. The
+ * result is the same as from hsvToRGB(). */
+void hsvToXRGB8888(u32 *dst, const u8 *hsv, size_t count);
+
+#endif
@@ -0,0 +1,158 @@
+/*
+ *  lineclip.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "lineclip.h"
+
+#include "guikit/primrect.h"
+#include "guikit/ptypes.h"
+
+u32 mulDiv(u32 a, u32 b, u32 c, u32 *rem)
+{
+    u32 q = 0;
+    u32 r = 0;
+    u32 bit;
+
+    for (bit = 0x80000000U; bit; bit >>= 1)
+    {
+        q <<= 1;
+        r <<= 1;
+        if (r >= c)
+        {
+            r -= c;
+            ++q;
+        }
+        if (a & bit)
+        {
+            r += b;
+            if (r >= c)
+            {
+                r -= c;
+                ++q;
+            }
+        }
+    }
+
+    *rem = r;
+    return q;
+}
+
+/* Narrow [*first, *last], a range of runs, to those that could reach into
+ * lo to hi along the major axis, measured from the start of the line in the
+ * direction it's drawn. There are delta + 1 runs spread over majorDelta. */
+static void clipMajor(int lo, int hi, int delta, int majorDelta,
+                      int *first, int *last)
+{
+    u32 q;
+    u32 rem;
+
+    /* Run i's pixels are within half a run of i * majorDelta / delta along
+     * the major axis, give or take a pixel for rounding. Rounding the run
+     * numbers outwards covers the half run, and a margin covers the rest. */
+    lo -= 2;
+    hi += 2;
+
+    if (lo > majorDelta || hi < 0)
+    {
+        *first = 1;
+        *last = 0;
+        return;
+    }
+
+    if (lo > 0)
+    {
+        q = mulDiv((u32)lo, (u32)delta, (u32)majorDelta, &rem);
+        if ((int)q > *first)
+        {
+            *first = (int)q;
+        }
+    }
+    if (hi < majorDelta)
+    {
+        q = mulDiv((u32)hi, (u32)delta, (u32)majorDelta, &rem);
+        q += rem != 0;
+        if ((int)q < *last)
+        {
+            *last = (int)q;
+        }
+    }
+}
+
+int clipLineRuns(const struct Rect *clip, int x1, int y1, int xAdvance,
+                 int xDelta, int yDelta, int *first, int *last)
+{
+    int left;
+    int right;
+
+    /* How far into the clip rect its edges are, going along x the way the
+     * line does */
+    if (xAdvance < 0)
+    {
+        left = x1 - clip->right;
+        right = x1 - clip->left;
+    }
+    else
+    {
+        left = clip->left - x1;
+        right = clip->right - x1;
+    }
+
+    /* There's a run for each step along the minor axis, so the clip rect's
+     * extent that way picks out runs exactly. Along the major axis, work it
+     * out from the slope. */
+    if (xDelta > yDelta)
+    {
+        *first = clip->top - y1;
+        *last = clip->bottom - y1;
+        if (*first < 0)
+        {
+            *first = 0;
+        }
+        if (*last > yDelta)
+        {
+            *last = yDelta;
+        }
+        clipMajor(left, right, yDelta, xDelta, first, last);
+    }
+    else
+    {
+        *first = left < 0 ? 0 : left;
+        *last = right > xDelta ? xDelta : right;
+        clipMajor(clip->top - y1, clip->bottom - y1, xDelta, yDelta, first,
+                  last);
+    }
+
+    return *first <= *last;
+}
+
+int skipLineRuns(int count, int minRunLen, int adjUp, int adjDown,
+                 int *errorAdj)
+{
+    u32 extra;
+    u32 rem;
+    int e;
+
+    if (count <= 0)
+    {
+        return 0;
+    }
+
+    /* Each run adds adjUp to the error term, and takes an extra pixel (and
+     * adjDown back off) whenever that takes the error term above 0. The
+     * error term starts at no more than 0, and above -adjDown unless adjUp is
+     * 0, so the extra pixels can be counted with a divide. */
+    extra = mulDiv((u32)count, (u32)adjUp, (u32)adjDown, &rem);
+    e = *errorAdj + (int)rem;
+    if (e > 0)
+    {
+        ++extra;
+        e -= adjDown;
+    }
+    *errorAdj = e;
+
+    return count * minRunLen + (int)extra;
+}
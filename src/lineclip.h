@@ -0,0 +1,38 @@
+/*
+ *  lineclip.h
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef LINECLIP_H
+#define LINECLIP_H
+
+#include "guikit/ptypes.h"
+
+struct Rect;
+
+/* Run-sliced lines draw one run of pixels per step along their minor axis.
+ * These let a line skip the runs that can't be seen, without moving any of
+ * the pixels drawing the whole line would have. */
+
+/* Find the first and last runs that could reach into clip, for a line drawn
+ * top to bottom from (x1, y1), going xDelta pixels left or right (xAdvance is
+ * -1 or 1) and yDelta down. The deltas must be positive and differ. The line
+ * has one more run than the smaller delta. Returns 0 if no run could. */
+int clipLineRuns(const struct Rect *clip, int x1, int y1, int xAdvance,
+                 int xDelta, int yDelta, int *first, int *last);
+
+/* Step a run-sliced line's error term over count full runs at once, as its
+ * run loop would one at a time. minRunLen, adjUp, and adjDown are the loop's.
+ * Returns how many pixels along the major axis the runs take up. */
+int skipLineRuns(int count, int minRunLen, int adjUp, int adjDown,
+                 int *errorAdj);
+
+/* Work out a * b / c, rounded down, and its remainder, for a and b no more
+ * than c, and c less than 2^31. Done a bit at a time, as a * b needn't fit in
+ * 32 bits. */
+u32 mulDiv(u32 a, u32 b, u32 c, u32 *rem);
+
+#endif
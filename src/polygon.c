@@ -0,0 +1,315 @@
+/*
+ *  polygon.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "polygon.h"
+
+#include "lineclip.h"
+#include "guikit/graphics.h"
+#include "guikit/panic.h"
+#include "guikit/pmemory.h"
+#include "guikit/primrect.h"
+#include "guikit/ptypes.h"
+#include <stddef.h>
+
+/* A pixel is inside a polygon if its center is. Edges go through the corners
+ * of pixels, so a polygon around a rect's corners covers the same pixels as
+ * the rect, and polygons sharing an edge don't overlap along it. */
+
+/* An edge crossing the rows being filled, stepped a row at a time like a
+ * Bresenham line. x is the first pixel with its center on or right of the
+ * edge; error is how far the edge is short of that, in 1/denom pixels. */
+struct Edge
+{
+    int x;
+    int error; /* From -denom (exclusive) to 0 */
+    int whole; /* How far x moves each row, rounded down */
+    int frac; /* And the rest, in 1/denom pixels */
+    int denom;
+    int bottom; /* Its last row */
+    int winding; /* 1 for edges going down, -1 for up */
+    int next; /* The next edge starting on the same row, or -1 */
+};
+
+/* Kept from one polygon to the next, so only new highs allocate. */
+static struct Edge *edges;
+static int *active; /* Edges crossing the current row, left to right */
+static size_t capEdges;
+static int *rows; /* The edge table: the first edge starting on each row */
+static size_t capRows;
+
+/* Divide n by d, which must be positive, rounding down. C90 leaves which way
+ * negative quotients round up to the compiler. */
+static int divFloor(int n, int d, int *rem)
+{
+    int q = n / d;
+    int r = n % d;
+
+    if (r < 0)
+    {
+        --q;
+        r += d;
+    }
+
+    *rem = r;
+    return q;
+}
+
+/* Set e up on row y, for the edge from (x0, y0) down to (x1, y1). */
+static void initEdge(struct Edge *e, int x0, int y0, int x1, int y1, int y)
+{
+    int dx = x1 - x0;
+    int dy = y1 - y0;
+    int k = y - y0;
+    u32 q;
+    u32 r;
+    int c;
+    int rem;
+
+    /* Row k's center is k + 1/2 rows down, where the edge is k + 1/2 of
+     * dx / dy along. The first pixel center on or right of that is
+     * ceil(((2k + 1) dx - dy) / 2dy) along, and each row adds 2dx / 2dy.
+     * Splitting that into whole and fractional pixels keeps the products
+     * small, and mulDiv() doesn't mind the one that isn't. */
+    e->denom = dy + dy;
+    e->whole = divFloor(dx + dx, e->denom, &e->frac);
+    q = mulDiv((u32)k, (u32)e->frac, (u32)e->denom, &r);
+    c = divFloor((int)r + dx - dy, e->denom, &rem);
+    e->x = x0 + k * e->whole + (int)q + c + (rem > 0);
+    e->error = rem > 0 ? rem - e->denom : 0;
+    e->bottom = y1 - 1;
+}
+
+static void stepEdge(struct Edge *e)
+{
+    e->x += e->whole;
+    e->error += e->frac;
+    if (e->error > 0)
+    {
+        ++e->x;
+        e->error -= e->denom;
+    }
+}
+
+static void fitEdges(size_t n)
+{
+    if (n > capEdges)
+    {
+        capEdges = n > capEdges * 2 ? n : capEdges * 2;
+        edges = prealloc(edges, capEdges * sizeof(*edges));
+        active = prealloc(active, capEdges * sizeof(*active));
+    }
+}
+
+static void fitRows(size_t n)
+{
+    if (n > capRows)
+    {
+        capRows = n > capRows * 2 ? n : capRows * 2;
+        rows = prealloc(rows, capRows * sizeof(*rows));
+    }
+}
+
+int polygonBounds(struct Rect *bounds, const int *xy, size_t n)
+{
+    int left;
+    int top;
+    int right;
+    int bottom;
+    size_t i;
+
+    if (n < 3)
+    {
+        return 0;
+    }
+
+    left = right = xy[0];
+    top = bottom = xy[1];
+    for (i = 1; i < n; ++i)
+    {
+        const int *p = &xy[i * 2];
+
+        left = p[0] < left ? p[0] : left;
+        right = p[0] > right ? p[0] : right;
+        top = p[1] < top ? p[1] : top;
+        bottom = p[1] > bottom ? p[1] : bottom;
+    }
+
+    /* Pixels are inside up to, but not including, the rightmost and
+     * bottommost points. */
+    InitRect(bounds, left, top, right - left, bottom - top);
+
+    return right > left && bottom > top;
+}
+
+/* Put the edges of the polygon that cross rows first to last into the edge
+ * table. */
+static void buildEdges(const int *xy, size_t n, int first, int last)
+{
+    int num = 0;
+    size_t i;
+
+    for (i = 0; i < n; ++i)
+    {
+        const int *p = &xy[i * 2];
+        const int *q = &xy[(i + 1) % n * 2];
+        struct Edge *e = &edges[num];
+        int start;
+        int end;
+
+        /* Rows are only ever crossed, never run along. */
+        if (p[1] == q[1])
+        {
+            continue;
+        }
+
+        e->winding = p[1] < q[1] ? 1 : -1;
+        if (e->winding < 0)
+        {
+            const int *t = p;
+
+            p = q;
+            q = t;
+        }
+
+        start = p[1] > first ? p[1] : first;
+        end = q[1] - 1 < last ? q[1] - 1 : last;
+        if (start > end)
+        {
+            continue;
+        }
+
+        initEdge(e, p[0], p[1], q[0], q[1], start);
+        e->next = rows[start - first];
+        rows[start - first] = num;
+        ++num;
+    }
+}
+
+/* Sort the active edges by x. Edges only swap places where they cross, so
+ * from one row to the next they're nearly in order already. */
+static void sortActive(int numActive)
+{
+    int i;
+
+    for (i = 1; i < numActive; ++i)
+    {
+        int a = active[i];
+        int x = edges[a].x;
+        int j = i;
+
+        while (j > 0 && edges[active[j - 1]].x > x)
+        {
+            active[j] = active[j - 1];
+            --j;
+        }
+        active[j] = a;
+    }
+}
+
+static int isInside(int rule, int count)
+{
+    return rule == FILL_NONZERO ? count != 0 : count & 1;
+}
+
+void scanPolygon(const int *xy, size_t n, int rule, const struct Rect *clip,
+                 poly_span_fn fn, const void *ctx)
+{
+    struct Rect bounds;
+    int first;
+    int last;
+    int numActive;
+    int y;
+    int i;
+
+    if (rule != FILL_EVEN_ODD && rule != FILL_NONZERO)
+    {
+        panic("Unknown fill rule: %d", rule);
+    }
+
+    if (!polygonBounds(&bounds, xy, n) ||
+        ClipRect(&bounds, clip) == CLIP_REJECTED)
+    {
+        return;
+    }
+
+    first = bounds.top;
+    last = bounds.bottom;
+    fitEdges(n);
+    fitRows((size_t)(last - first + 1));
+    for (y = first; y <= last; ++y)
+    {
+        rows[y - first] = -1;
+    }
+    buildEdges(xy, n, first, last);
+
+    numActive = 0;
+    for (y = first; y <= last; ++y)
+    {
+        int count;
+        int left;
+        int kept;
+
+        for (i = rows[y - first]; i >= 0; i = edges[i].next)
+        {
+            active[numActive++] = i;
+        }
+        sortActive(numActive);
+
+        /* Fill between where the rule says the row goes in and out of the
+         * polygon. */
+        count = 0;
+        left = 0;
+        for (i = 0; i < numActive; ++i)
+        {
+            const struct Edge *e = &edges[active[i]];
+            int wasInside = isInside(rule, count);
+
+            count += rule == FILL_NONZERO ? e->winding : 1;
+            if (!wasInside && isInside(rule, count))
+            {
+                left = e->x;
+            }
+            else if (wasInside && !isInside(rule, count))
+            {
+                int l = left > clip->left ? left : clip->left;
+                int r = e->x - 1 < clip->right ? e->x - 1 : clip->right;
+
+                if (l <= r)
+                {
+                    fn(l, y, r - l + 1, ctx);
+                }
+            }
+        }
+
+        /* Move on to the next row, dropping edges that end on this one. */
+        kept = 0;
+        for (i = 0; i < numActive; ++i)
+        {
+            struct Edge *e = &edges[active[i]];
+
+            if (e->bottom > y)
+            {
+                stepEdge(e);
+                active[kept++] = active[i];
+            }
+        }
+        numActive = kept;
+    }
+}
+
+void polygonFree(void)
+{
+    pfree(edges);
+    pfree(active);
+    pfree(rows);
+    edges = NULL;
+    active = NULL;
+    rows = NULL;
+    capEdges = 0;
+    capRows = 0;
+}
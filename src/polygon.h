@@ -0,0 +1,33 @@
+/*
+ *  polygon.h
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef POLYGON_H
+#define POLYGON_H
+
+#include <stddef.h>
+
+struct Rect;
+
+/* Called for each span of a polygon, width pixels from (x, y) rightwards. */
+typedef void (*poly_span_fn)(int x, int y, int width, const void *ctx);
+
+/* Find the spans of pixels within clip covered by the polygon joining up n
+ * points, stored as x, y pairs in xy, as FillPolygon() would fill it. Spans
+ * come top to bottom, and left to right along each row. The edge tables are
+ * kept from one polygon to the next, so this is only for one thread at a
+ * time. */
+void scanPolygon(const int *xy, size_t n, int rule, const struct Rect *clip,
+                 poly_span_fn fn, const void *ctx);
+
+/* Find where a polygon's pixels can land. Returns 0 if it has none. */
+int polygonBounds(struct Rect *bounds, const int *xy, size_t n);
+
+/* Free the edge tables, until the next polygon. */
+void polygonFree(void);
+
+#endif
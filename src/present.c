@@ -0,0 +1,106 @@
+/*
+ *  present.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "guikit/present.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int policy = PRESENT_VSYNC;
+static int interval = 1;
+static int frame;
+static int chosen;
+
+static const char *const names[NUM_PRESENT_POLICIES] = {
+    "vsync",
+    "novsync",
+    "never"
+};
+
+void SetPresentPolicy(int newPolicy, int newInterval)
+{
+    policy = newPolicy;
+    interval = newInterval > 0 ? newInterval : 1;
+    frame = 0;
+    chosen = 1;
+}
+
+int ParsePresentPolicy(const char *s)
+{
+    const char *colon;
+    size_t len;
+    int newInterval;
+    int i;
+
+    colon = strchr(s, ':');
+    len = colon ? (size_t)(colon - s) : strlen(s);
+
+    newInterval = 1;
+    if (colon)
+    {
+        char *end;
+        long n;
+
+        n = strtol(colon + 1, &end, 10);
+        if (end == colon + 1 || *end != '\0' || n < 1 || n > 1000000L)
+        {
+            return -1;
+        }
+        newInterval = (int)n;
+    }
+
+    for (i = 0; i < NUM_PRESENT_POLICIES; ++i)
+    {
+        if (strlen(names[i]) == len && strncmp(s, names[i], len) == 0)
+        {
+            SetPresentPolicy(i, newInterval);
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+int GetPresentPolicy(int *intervalOut)
+{
+    if (!chosen)
+    {
+        const char *env = getenv("GUIKIT_PRESENT");
+
+        /* Only look once, even if it's not there or is bad. */
+        chosen = 1;
+        if (env && ParsePresentPolicy(env))
+        {
+            printf("Ignoring unknown GUIKIT_PRESENT: %s\n", env);
+        }
+    }
+
+    *intervalOut = interval;
+
+    return policy;
+}
+
+int ShouldPresent(void)
+{
+    int n;
+
+    if (GetPresentPolicy(&n) == PRESENT_NEVER)
+    {
+        return 0;
+    }
+
+    ++frame;
+    if (frame < n)
+    {
+        return 0;
+    }
+
+    frame = 0;
+    return 1;
+}
@@ -7,6 +7,7 @@
  */
 
 #include "guikit/primrect.h"
+#include <stddef.h>
 
 static int min(int a, int b)
 {
@@ -78,6 +79,14 @@ int RectUnion(const struct Rect *a, const struct Rect *b, struct Rect *u)
     return 0;
 }
 
+void GrowRect(struct Rect *rect, const struct Rect *r)
+{
+    rect->left = min(rect->left, r->left);
+    rect->top = min(rect->top, r->top);
+    rect->right = max(rect->right, r->right);
+    rect->bottom = max(rect->bottom, r->bottom);
+}
+
 int RectIntersect(const struct Rect *a, const struct Rect *b, struct Rect *i)
 {
     /* Fast rejects */
@@ -122,22 +131,55 @@ void TranslateRect(struct Rect *rect, int x, int y)
     rect->bottom += y;
 }
 
-#if 0
-int PushClip(struct Rect *rect, const struct Rect *clip)
+void InitClipStack(struct ClipStack *stack, const struct Rect *bounds)
 {
-    /* Clip rect to clip */
+    stack->rects[0] = *bounds;
+    stack->depth = 1;
 }
 
-int PopClip(struct Rect *rect, const struct Rect *clip)
+const struct Rect *PushClip(struct ClipStack *stack, const struct Rect *rect)
 {
-    /* Restore previously pushed onto clip */
+    const struct Rect *top;
+    struct Rect *clip;
+
+    if (stack->depth == MAX_CLIP_DEPTH)
+    {
+        return NULL;
+    }
+
+    /* Clip rect to the top of the stack */
+    top = &stack->rects[stack->depth - 1];
+    clip = &stack->rects[stack->depth++];
+    if (rect->right < rect->left || rect->bottom < rect->top ||
+        RectIntersect(rect, top, clip) == RECT_NO_INTERSECT)
+    {
+        InitRect(clip, top->left, top->top, 0, 0);
+    }
+
+    return clip;
+}
+
+const struct Rect *PopClip(struct ClipStack *stack)
+{
+    /* Restore the rect pushed before the top one */
+    if (stack->depth <= 1)
+    {
+        return NULL;
+    }
+
+    return &stack->rects[--stack->depth - 1];
 }
-#endif
 
 int ClipRect(struct Rect *rect, const struct Rect *clip)
 {
     int ret = CLIP_NO_CHANGE;
 
+    /* Nothing is within an inside out clip rect. */
+    if (clip->right < clip->left || clip->bottom < clip->top)
+    {
+        return CLIP_REJECTED;
+    }
+
     /* Fast rejects */
     if (rect->bottom < clip->top)
     {
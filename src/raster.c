@@ -0,0 +1,1807 @@
+/*
+ *  raster.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "raster.h"
+
+#include "convert.h"
+#include "hsv.h"
+#include "lineclip.h"
+#include "polygon.h"
+#include "record.h"
+#include "guikit/damage.h"
+#include "guikit/graphics.h"
+#include "guikit/panic.h"
+#include "guikit/pmemory.h"
+#include "guikit/primrect.h"
+#include <string.h>
+
+/* The pen colors for fully saturated, full value hues, which are what gets
+ * asked for most. They depend on the screen's pixel format, so are made when
+ * first needed. */
+static u8 hueRGB[256][3];
+static u32 hueColors[256];
+static int hueColorsMade;
+
+static const u32 *getHueColors(void)
+{
+    u8 hsv[256 * 3];
+    int i;
+
+    if (hueColorsMade)
+    {
+        return hueColors;
+    }
+
+    for (i = 0; i < 256; ++i)
+    {
+        hsv[i * 3] = (u8)i;
+        hsv[i * 3 + 1] = 0xFF;
+        hsv[i * 3 + 2] = 0xFF;
+        hsvToRGB((u8)i, 0xFF, 0xFF, &hueRGB[i][0], &hueRGB[i][1],
+                 &hueRGB[i][2]);
+    }
+    HSVToSurfaceColors(hsv, hueColors, 256);
+    hueColorsMade = 1;
+
+    return hueColors;
+}
+
+void SetColorHSV(unsigned char h, unsigned char s, unsigned char v)
+{
+    u8 r;
+    u8 g;
+    u8 b;
+
+    if (s == 0xFF && v == 0xFF)
+    {
+        const u32 *colors = getHueColors();
+
+        rasterSetPenRGB(hueRGB[h][0], hueRGB[h][1], hueRGB[h][2], colors[h]);
+        return;
+    }
+
+    hsvToRGB(h, s, v, &r, &g, &b);
+    rasterSetPenRGB(r, g, b, rasterRGB(r, g, b));
+}
+
+void rasterPaletteChanged(void)
+{
+    hueColorsMade = 0;
+}
+
+int RotatePalette(int first, int count, int step)
+{
+    struct RGB colors[PALETTE_SIZE];
+    struct RGB rotated[PALETTE_SIZE];
+    int i;
+
+    if (GetPaletteEntries(first, count, colors))
+    {
+        return -1;
+    }
+
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    step %= count;
+    if (step < 0)
+    {
+        step += count;
+    }
+
+    for (i = 0; i < count; ++i)
+    {
+        rotated[(i + step) % count] = colors[i];
+    }
+
+    return SetPaletteEntries(first, count, rotated);
+}
+
+void HSVToSurfaceColors(const u8 *hsv, u32 *out, size_t n)
+{
+    size_t i;
+
+    hsvToXRGB8888(out, hsv, n);
+
+    switch (screenRaster.format)
+    {
+    case PIXEL_FORMAT_XRGB8888:
+        break;
+    case PIXEL_FORMAT_BGR555:
+        for (i = 0; i < n; ++i)
+        {
+            u32 p = out[i];
+
+            out[i] = ((p >> 19) & 0x1F) | ((p >> 11) & 0x1F) << 5 |
+                     ((p >> 3) & 0x1F) << 10;
+        }
+        break;
+    case PIXEL_FORMAT_INDEX8:
+    default:
+        for (i = 0; i < n; ++i)
+        {
+            u32 p = out[i];
+
+            out[i] = rasterRGB((u8)(p >> 16), (u8)(p >> 8), (u8)p);
+        }
+        break;
+    }
+}
+
+unsigned char rasterOp(int op, unsigned char src, const unsigned char *pat,
+                       size_t row)
+{
+    unsigned char p = pat[row % 8];
+    unsigned char byte = src & 0xFF;
+    switch (op)
+    {
+    case OP_SRC_INV:
+        byte = ~byte;
+        break;
+    case OP_SRC_INV_PAT_XOR:
+        byte = ~byte ^ p;
+        break;
+    case OP_PAT_AND:
+        byte &= p;
+        break;
+    case OP_SRC_INV_PAT_AND:
+        byte = ~byte & p;
+        break;
+    case OP_PAT_NOT:
+        byte &= ~p;
+        break;
+    case OP_PAT_OR:
+        byte |= p;
+        break;
+    case OP_SRC_INV_PAT_OR:
+        byte = ~byte | p;
+        break;
+    case OP_PAT_XOR:
+        byte ^= p;
+        break;
+    case OP_NONE:
+    default:
+        break;
+    }
+
+    return byte;
+}
+
+struct Raster screenRaster;
+
+/* Pushed clip rects, with the whole screen at the bottom. The top is
+ * screenRaster's clip rect. */
+static struct ClipStack clips;
+
+void rasterInit(u8 *pixels, int pitch, int format, int width, int height)
+{
+    screenRaster.pixels = pixels;
+    screenRaster.pitch = pitch;
+    screenRaster.format = format;
+    InitRect(&screenRaster.clip, 0, 0, width, height);
+    InitClipStack(&clips, &screenRaster.clip);
+    hueColorsMade = 0;
+}
+
+const struct Rect *rasterScreen(void)
+{
+    return &clips.rects[0];
+}
+
+int rasterRejects(const struct Rect *rect)
+{
+    const struct Rect *clip = &screenRaster.clip;
+
+    return rect->right < rect->left || rect->bottom < rect->top ||
+           clip->right < clip->left || clip->bottom < clip->top ||
+           rect->right < clip->left || rect->left > clip->right ||
+           rect->bottom < clip->top || rect->top > clip->bottom;
+}
+
+static void setClip(const struct Rect *clip)
+{
+    screenRaster.clip = *clip;
+    SetDamageClip(clip);
+    rasterClipChanged();
+}
+
+void PushClipRect(const struct Rect *rect)
+{
+    const struct Rect *clip;
+
+    if (recording)
+    {
+        recordRect(CMD_PUSH_CLIP, rect);
+        return;
+    }
+
+    clip = PushClip(&clips, rect);
+    if (!clip)
+    {
+        panic("Clip rects pushed too deep.");
+    }
+
+    setClip(clip);
+}
+
+void PopClipRect(void)
+{
+    const struct Rect *clip;
+
+    if (recording)
+    {
+        recordInts(CMD_POP_CLIP, 0, 0, 0, 0, 0);
+        return;
+    }
+
+    clip = PopClip(&clips);
+    if (!clip)
+    {
+        panic("Popped a clip rect that wasn't pushed.");
+    }
+
+    setClip(clip);
+}
+
+/* Pick how to draw a primitive that stays within bounds. Returns 0 if nothing
+ * would be visible. */
+static int beginRaster(struct Raster *r, const struct Raster *base,
+                       const struct Rect *bounds)
+{
+    *r = *base;
+
+    /* Nothing is visible through an inside out clip rect, which is what
+     * pushing a clip rect off the others leaves. */
+    if (r->clip.right < r->clip.left || r->clip.bottom < r->clip.top)
+    {
+        return 0;
+    }
+
+    /* An inside out bounds isn't worth thinking about; let the clipped writer
+     * sort it out. */
+    if (bounds->right < bounds->left || bounds->bottom < bounds->top)
+    {
+        r->spans = &clippedSpanWriter;
+        return 1;
+    }
+
+    if (bounds->right < r->clip.left || bounds->left > r->clip.right ||
+        bounds->bottom < r->clip.top || bounds->top > r->clip.bottom)
+    {
+        return 0;
+    }
+
+    /* Clip once per primitive, rather than once per pixel, by only using the
+     * clipping writer when the primitive straddles the edge of the clip
+     * rect. */
+    if (bounds->left >= r->clip.left && bounds->right <= r->clip.right &&
+        bounds->top >= r->clip.top && bounds->bottom <= r->clip.bottom)
+    {
+        r->spans = spanWriter(r->format);
+    }
+    else
+    {
+        r->spans = &clippedSpanWriter;
+    }
+
+    return 1;
+}
+
+static void fillRect(const struct Raster *r, const struct Rect *rect)
+{
+    struct Rect clipped;
+    int y;
+    int width;
+
+    clipped = *rect;
+    if (clipped.right < clipped.left || clipped.bottom < clipped.top ||
+        ClipRect(&clipped, &r->clip) == CLIP_REJECTED)
+    {
+        return;
+    }
+
+    width = clipped.right - clipped.left + 1;
+    for (y = clipped.top; y <= clipped.bottom; ++y)
+    {
+        spanWriter(r->format)->hline(r, clipped.left, y, width);
+    }
+}
+
+void rasterFillRect(const struct Raster *base, const struct Rect *rect)
+{
+    fillRect(base, rect);
+}
+
+void rasterDrawRect(const struct Raster *base, const struct Rect *rect)
+{
+    int x;
+    int y;
+    int width;
+    int height;
+    struct Raster raster;
+    const struct Raster *r = &raster;
+
+    x = rect->left;
+    y = rect->top;
+    width = rect->right - rect->left + 1;
+    height = rect->bottom - rect->top + 1;
+
+    if (!beginRaster(&raster, base, rect))
+    {
+        return;
+    }
+
+    r->spans->vline(r, x, y, height); /* Left */
+    r->spans->hline(r, x + 1, y, width - 1); /* Top */
+    r->spans->vline(r, x + width - 1, y + 1, height - 1); /* Right */
+    r->spans->hline(r, x + 1, y + height - 1, width - 2); /* Bottom */
+}
+
+void DrawRect(const struct Rect *rect)
+{
+    if (recording)
+    {
+        recordRect(CMD_DRAW_RECT, rect);
+        return;
+    }
+
+    AddDamage(rect);
+    rasterDrawRect(&screenRaster, rect);
+}
+
+void FillRect(const struct Rect *rect)
+{
+    if (recording)
+    {
+        recordRect(CMD_FILL_RECT, rect);
+        return;
+    }
+
+    fillRect(&screenRaster, rect);
+    AddDamage(rect);
+}
+
+int rasterRectsBounds(struct Rect *bounds, const struct Rect *rects,
+                      size_t n)
+{
+    int found;
+    size_t i;
+
+    found = 0;
+    for (i = 0; i < n; ++i)
+    {
+        const struct Rect *b = &rects[i];
+
+        if (b->right < b->left || b->bottom < b->top)
+        {
+            continue;
+        }
+
+        if (!found)
+        {
+            *bounds = *b;
+            found = 1;
+            continue;
+        }
+
+        GrowRect(bounds, b);
+    }
+
+    return found;
+}
+
+void rasterFillRects(const struct Raster *base, const struct Rect *rects,
+                     const u32 *colors, size_t n)
+{
+    struct Raster r;
+    size_t i;
+
+    r = *base;
+    for (i = 0; i < n; ++i)
+    {
+        if (colors)
+        {
+            r.color = colors[i];
+        }
+        fillRect(&r, &rects[i]);
+    }
+}
+
+static void fillRects(const struct Rect *rects, const u32 *colors, size_t n)
+{
+    struct Rect bounds;
+
+    if (rasterRectsBounds(&bounds, rects, n))
+    {
+        AddDamage(&bounds);
+        rasterFillRects(&screenRaster, rects, colors, n);
+    }
+}
+
+void FillRects(const struct Rect *rects, size_t n)
+{
+    size_t i;
+
+    if (recording)
+    {
+        for (i = 0; i < n; ++i)
+        {
+            recordRect(CMD_FILL_RECT, &rects[i]);
+        }
+        return;
+    }
+
+    fillRects(rects, NULL, n);
+}
+
+void FillRectsColors(const struct Rect *rects, const u32 *colors, size_t n)
+{
+    if (recording)
+    {
+        recordBatch(CMD_FILL_RECTS_COLORS, rects, colors, n);
+        return;
+    }
+
+    fillRects(rects, colors, n);
+}
+
+void rasterFillRectOp(const struct Raster *base, const unsigned char *pattern,
+                      int op, const struct Rect *rect)
+{
+    const struct SpanWriter *spans;
+    struct Rect clipped;
+    int y;
+    int width;
+
+    clipped = *rect;
+    if (clipped.right < clipped.left || clipped.bottom < clipped.top ||
+        ClipRect(&clipped, &base->clip) == CLIP_REJECTED)
+    {
+        return;
+    }
+
+    /* Patterns line up with the screen, not the rect, so that neighboring
+     * fills join up seamlessly. */
+    spans = spanWriter(base->format);
+    width = clipped.right - clipped.left + 1;
+    for (y = clipped.top; y <= clipped.bottom; ++y)
+    {
+        /* Filling is like blitting a source of all ones. */
+        unsigned char bits = rasterOp(op, 0xFF, pattern, y);
+
+        if (bits == 0xFF)
+        {
+            spans->hline(base, clipped.left, y, width);
+        }
+        else if (bits != 0)
+        {
+            spans->hpattern(base, clipped.left, y, width, bits);
+        }
+    }
+}
+
+void FillRectOp(const unsigned char *pattern,
+                int op, const struct Rect *rect)
+{
+    if (recording)
+    {
+        recordFillRectOp(pattern, op, rect);
+        return;
+    }
+
+    AddDamage(rect);
+    rasterFillRectOp(&screenRaster, pattern, op, rect);
+}
+
+void rasterVertLine(const struct Raster *base, int x1, int y1, int len)
+{
+    clippedSpanWriter.vline(base, x1, y1, len);
+}
+
+void rasterHorizLine(const struct Raster *base, int x1, int y1, int len)
+{
+    clippedSpanWriter.hline(base, x1, y1, len);
+}
+
+void DrawVertLine(int x1, int y1, int len)
+{
+    struct Rect rect;
+
+    if (recording)
+    {
+        recordInts(CMD_VERT_LINE, x1, y1, len, 0, 0);
+        return;
+    }
+
+    InitRect(&rect, x1, y1, 1, len);
+    AddDamage(&rect);
+
+    rasterVertLine(&screenRaster, x1, y1, len);
+}
+
+void DrawHorizLine(int x1, int y1, int len)
+{
+    struct Rect rect;
+
+    if (recording)
+    {
+        recordInts(CMD_HORIZ_LINE, x1, y1, len, 0, 0);
+        return;
+    }
+
+    InitRect(&rect, x1, y1, len, 1);
+    AddDamage(&rect);
+
+    rasterHorizLine(&screenRaster, x1, y1, len);
+}
+
+static void drawDiagLine(const struct Raster *r, int x1, int y1, int x2,
+                         int len)
+{
+    int x;
+    int y;
+    int y_start;
+    int y_end;
+    int leftToRight;
+    const struct SpanWriter *spans = r->spans;
+
+/*
+Diagonal lines for testing.
+-- (40,0) -> (160,120)
+        (40,0)->(160,121)
+-- (280,0) -> (160,120)
+        (280,0)->(160,121)
+-- (160,120) -> (279,239)
+        (160,120)->(279,120)
+-- (160,120) -> (41,239)
+        (160,120)->(41,120)
+-- (360,0) -> (480,120)
+        (360,0)->(480,121)
+-- (600,0) -> (480,120)
+        (600,0)->(480,121)
+-- (480,120) -> (599,239)
+        (480,120)->(599,120)
+-- (480,120) -> (361,239)
+        (480,120)->(361,120)
+-- (40,240) -> (160,360)
+        (40,240)->(160,121)
+-- (280,240) -> (160,360)
+        (280,240)->(160,121)
+-- (160,360) -> (279,479)
+        (160,360)->(279,120)
+-- (160,360) -> (41,479)
+        (160,360)->(41,120)
+-- (360,240) -> (480,360)
+        (360,240)->(480,121)
+-- (600,240) -> (480,360)
+        (600,240)->(480,121)
+-- (480,360) -> (599,479)
+        (480,360)->(599,120)
+-- (480,360) -> (361,479)
+        (480,360)->(361,120)
+*/
+    /*printf("\t(%d,%d)->(%d,%d)\n", x1, y1, x2, len);*/
+
+    /* Right to left or left to right */
+    /* Assumes top to bottom */
+    y_start = y1;
+    y_end = y1 + len - 1;
+    x = x1;
+
+    if (x1 < x2)
+    {
+        leftToRight = 1;
+    }
+    else
+    {
+        leftToRight = -1;
+    }
+
+    if (r->spans == &clippedSpanWriter)
+    {
+        const struct Rect *clip = &r->clip;
+        int first;
+        int last;
+
+        /* Trim the line to the clip rect, after which no pixel needs
+         * checking. */
+        first = clip->top - y1;
+        last = clip->bottom - y1;
+        if (leftToRight > 0)
+        {
+            first = first > clip->left - x1 ? first : clip->left - x1;
+            last = last < clip->right - x1 ? last : clip->right - x1;
+        }
+        else
+        {
+            first = first > x1 - clip->right ? first : x1 - clip->right;
+            last = last < x1 - clip->left ? last : x1 - clip->left;
+        }
+        first = first > 0 ? first : 0;
+        last = last < len - 1 ? last : len - 1;
+        if (first > last)
+        {
+            return;
+        }
+
+        y_start = y1 + first;
+        y_end = y1 + last;
+        x = x1 + leftToRight * first;
+        spans = spanWriter(r->format);
+    }
+
+    for (y = y_start; y <= y_end; ++y)
+    {
+        spans->pixel(r, x, y);
+        x += leftToRight;
+    }
+}
+
+/* Find where a diagonal line's pixels land. Returns 0 if there aren't any. */
+static int diagBounds(struct Rect *bounds, int x1, int y1, int x2, int len)
+{
+    if (len <= 0)
+    {
+        return 0;
+    }
+
+    RectFromLine(bounds, x1, y1, x1 < x2 ? x1 + len - 1 : x1 - len + 1,
+                 y1 + len - 1);
+
+    return 1;
+}
+
+void rasterDiagLine(const struct Raster *base, int x1, int y1, int x2,
+                    int len)
+{
+    struct Rect rect;
+    struct Raster r;
+
+    if (diagBounds(&rect, x1, y1, x2, len) && beginRaster(&r, base, &rect))
+    {
+        drawDiagLine(&r, x1, y1, x2, len);
+    }
+}
+
+void DrawDiagLine(int x1, int y1, int x2, int len)
+{
+    struct Rect rect;
+
+    if (recording)
+    {
+        recordInts(CMD_DIAG_LINE, x1, y1, x2, len, 0);
+        return;
+    }
+
+    if (diagBounds(&rect, x1, y1, x2, len))
+    {
+        AddDamage(&rect);
+        rasterDiagLine(&screenRaster, x1, y1, x2, len);
+    }
+}
+
+/* XXX We are doing run-sliced bressenham. For small lines, standard bressenham
+ * should be faster, (but only if we can figure out how to write more than 1
+ * pixel at a time from standard bressenham). */
+/* Provide standard bressenham here, too, so we can do short lines quickly,
+ * without a divide or extra setup. */
+/* Algorithm from Michael Abrash's Graphics Programming Black Book, Chapter 37.
+ * Variable names and comments kept similar for ease of comparison with the
+ * text. */
+static void drawLine(const struct Raster *r, int x1, int y1, int x2, int y2)
+{
+    int AdjUp; /* Error term adjust up on each advance*/
+    int AdjDown; /* Error term adjust down when error term turns over*/
+    int XAdvance; /* 1 or -1, for direction in which x advances*/
+    int YDelta;
+    int XDelta;
+    int min_run_len;
+    int final_run_len;
+    int run_len; /* aka step */
+    int errorAdj;
+    int first; /* The first and last runs that can be seen */
+    int last;
+    int i;
+
+    /*printf("(%03d,%03d)->(%03d,%03d)\r", x1, y1, x2, y2);*/
+
+    /* We'll draw top to bottom, to reduce the number of cases we have to
+     * handle, and to make lines between the same endpoints always draw the
+     * same pixels. */
+    /* TODO remove this, as we'll like patterned lines to work well without
+     * having to reverse the pattern. */
+    if (y1 > y2)
+    {
+        int tmp;
+
+        /* Swap y1 and y2 */
+        tmp = y1;
+        y1 = y2;
+        y2 = tmp;
+        /* Swap x1 and x2 */
+        tmp = x1;
+        x1 = x2;
+        x2 = tmp;
+    }
+    /* Now the line is top to bottom */
+
+    /* Figure out how far we're going vertically (guaranteed to be positive) */
+    YDelta = y2 - y1;
+
+    /* Figure out whether we're going left or right, and how far we're going
+     * horizontally. In the process, special-case vertical lines, for speed and
+     * to avoid nasty boundary conditions and division by 0 */
+    XDelta = x2 - x1;
+    /* Do we have a vertical line? */
+    if (XDelta == 0)
+    {
+        /* Yes, so use vertical line drawing */
+        r->spans->vline(r, x1, y1, YDelta+1);
+        return;
+    }
+    else if (XDelta < 0)
+    {
+        /* Right to left */
+        XAdvance = -1;
+        XDelta = -XDelta; /* |XDelta| -- Make XDelta positive */
+    }
+    else
+    {
+        /* Left to right */
+        XAdvance = 1;
+    }
+
+    /* Special-case horizontal lines */
+    if (YDelta == 0)
+    {
+        if (XAdvance < 0)
+        {
+            /* Right-to-left */
+            r->spans->hline(r, x2, y1, XDelta+1);
+            return;
+        }
+        else
+        {
+            /* Left-to-right */
+            r->spans->hline(r, x1, y1, XDelta+1);
+            return;
+        }
+    }
+    /* Special-case diagonal lines */
+    else if (YDelta == XDelta)
+    {
+        /*printf("-- (%d,%d) -> (%d,%d)\n", x1, y1, x2, y2);*/
+        drawDiagLine(r, x1, y1, x2, XDelta+1);
+        return;
+    }
+
+    /* Only bother with the runs that reach into the clip rect. Skipped runs
+     * still move the error term along, so the rest land where they would
+     * have anyway. */
+    if (r->spans == &clippedSpanWriter)
+    {
+        if (!clipLineRuns(&r->clip, x1, y1, XAdvance, XDelta, YDelta, &first,
+                          &last))
+        {
+            return;
+        }
+    }
+    else
+    {
+        first = 0;
+        last = XDelta > YDelta ? YDelta : XDelta;
+    }
+
+    /* Determine whether the line is X or Y major, and handle accordingly. */
+    if (XDelta > YDelta)
+    {
+        /* X-major */
+        /* More horizontal than vertical */
+
+        min_run_len = XDelta / YDelta;
+        errorAdj = XDelta % YDelta;
+        AdjUp = errorAdj + errorAdj;
+        AdjDown = YDelta + YDelta;
+
+        /* Initial error term; reflects an initial step of 0.5 along the Y
+         * axis */
+        errorAdj -= AdjDown;
+
+        /* The initial and last runs are partial, because Y advances only 0.5
+         * for these runs, rather than 1. Divide one full run, plus the initial
+         * pixel, between the initial and last runs. */
+        run_len = min_run_len / 2 + 1;
+        final_run_len = run_len;
+
+        /* If there is an odd number of pixels per run, we have one pixel that
+         * can't be allocated to either the initial or last partial run, so
+         * we'll add 0.5 to the error term so this pixel will be handled by the
+         * normal full-run loop. */
+        /* Is the run length odd? */
+        if (min_run_len & 1)
+        {
+            /* Odd length, add YDelta to error term (add 0.5 of a pixel to the
+             * error term) */
+            errorAdj += YDelta;
+        }
+        else
+        {
+            /* The basic run length is even */
+            /* If there's no fractional advance, we have one pixel that could
+             * go to either the initial or last partial run, which we'll
+             * arbitrarily allocate to the last run.*/
+            if (AdjUp == 0)
+            {
+                --run_len;
+            }
+        }
+
+        /* X-Major adjustments done now */
+
+        if (first > 0)
+        {
+            /* Skip straight past the runs before the clip rect. */
+            x1 += XAdvance * (run_len + skipLineRuns(first - 1, min_run_len,
+                                                     AdjUp, AdjDown,
+                                                     &errorAdj));
+            y1 += first;
+        }
+        else
+        {
+            /* Draw the first partial run of pixels. */
+            /* XXX TODO extract out the x2 x1 choice to the outside of the
+             * loop. */
+            /* Option: make an x variable we set when we choose XAdvance, and
+             * then always use XAdvance as "1" when doing x-major
+             * Another choice is to have a horizontal line drawing function
+             * that takes Xadvance as a param, to pick to go left or right */
+            if (XAdvance < 0)
+            {
+                /* Right to left */
+                r->spans->hline(r, x1-run_len+1, y1++, run_len);
+                x1 -= run_len;
+            }
+            else
+            {
+                /* Left to right */
+                r->spans->hline(r, x1, y1++, run_len);
+                x1 += run_len;
+            }
+        }
+
+        /* Draw all full runs, up to the last one that can be seen */
+        for (i = first > 1 ? first : 1; i < YDelta && i <= last; ++i)
+        {
+            run_len = min_run_len; /* Run is at least this long */
+            /* Advance the error term and add an extra pixel if the error term
+             * so indicates. */
+            errorAdj += AdjUp;
+            if (errorAdj > 0)
+            {
+                /* One extra pixel in run */
+                ++run_len;
+                /* Reset the error term */
+                errorAdj -= AdjDown;
+            }
+            if (XAdvance < 0)
+            {
+                /* Right to left */
+                r->spans->hline(r, x1-run_len+1, y1++, run_len);
+                x1 -= run_len;
+            }
+            else
+            {
+                /* Left to right */
+                r->spans->hline(r, x1, y1++, run_len);
+                x1 += run_len;
+            }
+        }
+
+        if (last < YDelta)
+        {
+            return;
+        }
+        if (XAdvance < 0)
+        {
+            /* Right to left */
+            r->spans->hline(r, x1-final_run_len+1, y1, final_run_len);
+        }
+        else
+        {
+            /* Left to right */
+            r->spans->hline(r, x1, y1, final_run_len);
+        }
+        return;
+    }
+    else
+    {
+        /* Y-major */
+        /* More vertical than horizontal */
+        min_run_len = YDelta / XDelta;
+        errorAdj = YDelta % XDelta;
+        AdjUp = errorAdj + errorAdj;
+        AdjDown = XDelta + XDelta;
+
+        /* Initial error term; reflects an initial step of 0.5 along the X
+         * axis */
+        errorAdj -= AdjDown;
+
+        /* The initial and last runs are partial, because X advances only 0.5
+         * for these runs, rather than 1. Divide one full run, plus the initial
+         * pixel, between the initial and last runs. */
+        run_len = min_run_len / 2 + 1;
+        final_run_len = run_len;
+
+        /* If there is an odd number of pixels per run, we have one pixel that
+         * can't be allocated to either the initial or last partial run, so
+         * we'll add 0.5 to the error term so this pixel will be handled by the
+         * normal full-run loop. */
+        /* Is the run length odd? */
+        if (min_run_len & 1)
+        {
+            /* Odd length, add XDelta to error term (add 0.5 of a pixel to the
+             * error term) */
+            errorAdj += XDelta;
+        }
+        else
+        {
+            /* The basic run length is even */
+            /* If there's no fractional advance, we have one pixel that could
+             * go to either the initial or last partial run, which we'll
+             * arbitrarily allocate to the last run.*/
+            if (AdjUp == 0)
+            {
+                --run_len;
+            }
+        }
+
+        /* Y-Major adjustments done now */
+
+        if (first > 0)
+        {
+            /* Skip straight past the runs before the clip rect. */
+            y1 += run_len + skipLineRuns(first - 1, min_run_len, AdjUp,
+                                         AdjDown, &errorAdj);
+            x1 += XAdvance * first;
+        }
+        else
+        {
+            /* Draw the first partial run of pixels. */
+            /*printf("x1,y1,len: (%d,%d,%d)\r", x1, y1, run_len);*/
+            r->spans->vline(r, x1, y1, run_len);
+            y1 += run_len;
+            x1 += XAdvance;
+        }
+
+        /* Draw all full runs, up to the last one that can be seen */
+        for (i = first > 1 ? first : 1; i < XDelta && i <= last; ++i)
+        {
+            run_len = min_run_len; /* Run is at least this long */
+            /* Advance the error term and add an extra pixel if the error term
+             * so indicates. */
+            errorAdj += AdjUp;
+            if (errorAdj > 0)
+            {
+                /* One extra pixel in run */
+                ++run_len;
+                /* Reset the error term */
+                errorAdj -= AdjDown;
+            }
+            /*printf("x1,y1,len: (%d,%d,%d)\r", x1, y1, run_len);*/
+            r->spans->vline(r, x1, y1, run_len);
+            y1 += run_len;
+            x1 += XAdvance;
+        }
+
+        if (last < XDelta)
+        {
+            return;
+        }
+        /*printf("x1,y1,len: (%d,%d,%d)\r", x1, y1, run_len);*/
+        r->spans->vline(r, x1, y1, final_run_len);
+        return;
+    }
+}
+
+void rasterLine(const struct Raster *base, int x1, int y1, int x2, int y2)
+{
+    struct Rect bounds;
+    struct Raster r;
+
+    RectFromLine(&bounds, x1, y1, x2, y2);
+    if (beginRaster(&r, base, &bounds))
+    {
+        drawLine(&r, x1, y1, x2, y2);
+    }
+}
+
+void DrawLine(int x1, int y1, int x2, int y2)
+{
+    struct Rect bounds;
+
+    if (recording)
+    {
+        recordInts(CMD_LINE, x1, y1, x2, y2, 0);
+        return;
+    }
+
+    RectFromLine(&bounds, x1, y1, x2, y2);
+    AddDamage(&bounds);
+    rasterLine(&screenRaster, x1, y1, x2, y2);
+}
+
+void rasterLinesBounds(struct Rect *bounds, const struct LineSeg *lines,
+                       size_t n)
+{
+    size_t i;
+
+    RectFromLine(bounds, lines[0].x1, lines[0].y1, lines[0].x2, lines[0].y2);
+    for (i = 1; i < n; ++i)
+    {
+        struct Rect b;
+
+        RectFromLine(&b, lines[i].x1, lines[i].y1, lines[i].x2, lines[i].y2);
+        GrowRect(bounds, &b);
+    }
+}
+
+void rasterLines(const struct Raster *base, const struct LineSeg *lines,
+                 const u32 *colors, size_t n)
+{
+    struct Rect bounds;
+    struct Raster r;
+    int inside;
+    size_t i;
+
+    if (!n)
+    {
+        return;
+    }
+
+    rasterLinesBounds(&bounds, lines, n);
+    if (!beginRaster(&r, base, &bounds))
+    {
+        return;
+    }
+
+    /* When the whole batch is within the clip rect, no line needs checking
+     * on its own. */
+    inside = r.spans != &clippedSpanWriter;
+    for (i = 0; i < n; ++i)
+    {
+        const struct LineSeg *l = &lines[i];
+
+        if (colors)
+        {
+            r.color = colors[i];
+        }
+
+        if (inside)
+        {
+            drawLine(&r, l->x1, l->y1, l->x2, l->y2);
+        }
+        else
+        {
+            rasterLine(&r, l->x1, l->y1, l->x2, l->y2);
+        }
+    }
+}
+
+void DrawLines(const struct LineSeg *lines, size_t n)
+{
+    struct Rect bounds;
+    size_t i;
+
+    if (recording)
+    {
+        for (i = 0; i < n; ++i)
+        {
+            recordInts(CMD_LINE, lines[i].x1, lines[i].y1, lines[i].x2,
+                       lines[i].y2, 0);
+        }
+        return;
+    }
+
+    if (n)
+    {
+        rasterLinesBounds(&bounds, lines, n);
+        AddDamage(&bounds);
+        rasterLines(&screenRaster, lines, NULL, n);
+    }
+}
+
+void DrawLinesColors(const struct LineSeg *lines, const u32 *colors,
+                     size_t n)
+{
+    struct Rect bounds;
+
+    if (recording)
+    {
+        recordBatch(CMD_LINES_COLORS, lines, colors, n);
+        return;
+    }
+
+    if (n)
+    {
+        rasterLinesBounds(&bounds, lines, n);
+        AddDamage(&bounds);
+        rasterLines(&screenRaster, lines, colors, n);
+    }
+}
+
+void DrawPolyline(const int *xy, size_t n)
+{
+    struct Rect bounds;
+    struct Raster r;
+    int inside;
+    size_t i;
+
+    if (recording)
+    {
+        for (i = 1; i < n; ++i)
+        {
+            recordInts(CMD_LINE, xy[i * 2 - 2], xy[i * 2 - 1], xy[i * 2],
+                       xy[i * 2 + 1], 0);
+        }
+        return;
+    }
+
+    if (n < 2)
+    {
+        return;
+    }
+
+    RectFromLine(&bounds, xy[0], xy[1], xy[0], xy[1]);
+    for (i = 1; i < n; ++i)
+    {
+        struct Rect b;
+
+        RectFromLine(&b, xy[i * 2], xy[i * 2 + 1], xy[i * 2], xy[i * 2 + 1]);
+        GrowRect(&bounds, &b);
+    }
+    AddDamage(&bounds);
+
+    if (!beginRaster(&r, &screenRaster, &bounds))
+    {
+        return;
+    }
+
+    inside = r.spans != &clippedSpanWriter;
+    for (i = 1; i < n; ++i)
+    {
+        const int *p = &xy[i * 2 - 2];
+
+        if (inside)
+        {
+            drawLine(&r, p[0], p[1], p[2], p[3]);
+        }
+        else
+        {
+            rasterLine(&r, p[0], p[1], p[2], p[3]);
+        }
+    }
+}
+
+static void circlePoints(const struct Raster *r, int x0, int y0, int x,
+                         int y)
+{
+    r->spans->pixel(r, x0 + x, y0 + y);
+    r->spans->pixel(r, x0 + y, y0 + x);
+    r->spans->pixel(r, x0 + y, y0 - x);
+    r->spans->pixel(r, x0 + x, y0 - y);
+    r->spans->pixel(r, x0 - x, y0 - y);
+    r->spans->pixel(r, x0 - y, y0 - x);
+    r->spans->pixel(r, x0 - y, y0 + x);
+    r->spans->pixel(r, x0 - x, y0 + y);
+}
+
+void rasterDrawCircle(const struct Raster *base, int x0, int y0, int radius)
+{
+    int x;
+    int y;
+    int d;
+    int deltaE;
+    int deltaNE;
+    struct Rect bounds;
+    struct Raster raster;
+    const struct Raster *r = &raster;
+
+    InitRect(&bounds, x0 - radius, y0 - radius, 2 * radius + 1,
+             2 * radius + 1);
+    if (!beginRaster(&raster, base, &bounds))
+    {
+        return;
+    }
+
+    /* Speed this up by accumulating horizontal, diagonal, and vertical line
+     * segments. Draw each line segment reflected around in each octant. */
+
+    x = 0;
+    y = radius;
+    d = 1 - radius;
+    deltaE = 3;
+    deltaNE = -2 * radius + 5;
+    circlePoints(r, x0, y0, x, y);
+
+    while (y > x)
+    {
+        if (d < 0)
+        {
+            /* East */
+            d += deltaE;
+            deltaE += 2;
+            deltaNE += 2;
+        }
+        else
+        {
+            /* Northeast */
+            d += deltaNE;
+            deltaE += 2;
+            deltaNE += 4;
+            --y;
+        }
+        ++x;
+        circlePoints(r, x0, y0, x, y);
+    }
+}
+
+void DrawCircle(int x0, int y0, int radius)
+{
+    struct Rect bounds;
+
+    if (recording)
+    {
+        recordInts(CMD_DRAW_CIRCLE, x0, y0, radius, 0, 0);
+        return;
+    }
+
+    InitRect(&bounds, x0 - radius, y0 - radius, 2 * radius + 1,
+             2 * radius + 1);
+    AddDamage(&bounds);
+    rasterDrawCircle(&screenRaster, x0, y0, radius);
+}
+
+/* Half widths of each row of a filled circle, from its middle row out. Tables
+ * for small radii are kept, so that circles and rounded corners of the same
+ * size don't have to run the midpoint algorithm every time. */
+enum {
+    NUM_ROUND_TABLES = 16,
+    MAX_ROUND_RADIUS = 255 /* Biggest radius worth keeping a table for */
+};
+
+static int roundTables[NUM_ROUND_TABLES][MAX_ROUND_RADIUS + 1];
+static int roundRadius[NUM_ROUND_TABLES]; /* Which radius each table is for */
+
+/* While held, tables are only read, so many threads can draw at once. */
+static int roundHeld;
+
+/* Run the midpoint algorithm, noting the widest span it would draw on each
+ * row, or -1 for rows it wouldn't draw on at all. */
+static void makeRoundTable(int *half, int radius)
+{
+    int x;
+    int y;
+    int d;
+    int deltaE;
+    int deltaNE;
+    int i;
+
+    for (i = 0; i <= radius; ++i)
+    {
+        half[i] = -1;
+    }
+
+    x = 0;
+    y = radius;
+    d = 1 - radius;
+    deltaE = 3;
+    deltaNE = -2 * radius + 5;
+    for (;;)
+    {
+        /* Each step gives a span on row y as wide as x, and on row x as wide
+         * as y. */
+        half[y] = x > half[y] ? x : half[y];
+        half[x] = y > half[x] ? y : half[x];
+
+        if (y <= x)
+        {
+            break;
+        }
+
+        if (d < 0)
+        {
+            /* East */
+            d += deltaE;
+            deltaE += 2;
+            deltaNE += 2;
+        }
+        else
+        {
+            /* Northeast */
+            d += deltaNE;
+            deltaE += 2;
+            deltaNE += 4;
+            --y;
+        }
+        ++x;
+    }
+}
+
+/* Get the table for radius, from those kept if possible, or else made in buf,
+ * which has room for radius + 1 entries. */
+static const int *roundTable(int radius, int *buf)
+{
+    int slot;
+
+    if (radius <= MAX_ROUND_RADIUS)
+    {
+        slot = radius % NUM_ROUND_TABLES;
+        if (roundRadius[slot] == radius)
+        {
+            return roundTables[slot];
+        }
+
+        if (!roundHeld)
+        {
+            makeRoundTable(roundTables[slot], radius);
+            roundRadius[slot] = radius;
+            return roundTables[slot];
+        }
+    }
+
+    makeRoundTable(buf, radius);
+    return buf;
+}
+
+void rasterKeepRound(int radius)
+{
+    int buf[MAX_ROUND_RADIUS + 1];
+
+    if (radius >= 0 && radius <= MAX_ROUND_RADIUS)
+    {
+        roundTable(radius, buf);
+    }
+}
+
+void rasterHoldRound(void)
+{
+    roundHeld = 1;
+}
+
+void rasterReleaseRound(void)
+{
+    roundHeld = 0;
+}
+
+void rasterFillCircle(const struct Raster *base, int x0, int y0, int radius)
+{
+    int buf[MAX_ROUND_RADIUS + 1];
+    int *made;
+    const int *half;
+    struct Rect bounds;
+    struct Raster raster;
+    const struct Raster *r = &raster;
+    int d;
+
+    InitRect(&bounds, x0 - radius, y0 - radius, 2 * radius + 1,
+             2 * radius + 1);
+    if (radius < 0 || !beginRaster(&raster, base, &bounds))
+    {
+        return;
+    }
+
+    made = radius > MAX_ROUND_RADIUS ?
+        pmalloc((radius + 1) * sizeof(*made)) : buf;
+    half = roundTable(radius, made);
+
+    /* One span per row, each reaching out as far as the midpoint algorithm
+     * got on that row. */
+    for (d = 0; d <= radius; ++d)
+    {
+        int h = half[d];
+
+        if (h > 0)
+        {
+            r->spans->hline(r, x0 - h, y0 - d, h + h);
+            if (d)
+            {
+                r->spans->hline(r, x0 - h, y0 + d, h + h);
+            }
+        }
+    }
+
+    if (made != buf)
+    {
+        pfree(made);
+    }
+}
+
+void FillCircle(int x0, int y0, int radius)
+{
+    struct Rect bounds;
+
+    if (recording)
+    {
+        recordInts(CMD_FILL_CIRCLE, x0, y0, radius, 0, 0);
+        return;
+    }
+
+    InitRect(&bounds, x0 - radius, y0 - radius, 2 * radius + 1,
+             2 * radius + 1);
+    AddDamage(&bounds);
+    rasterFillCircle(&screenRaster, x0, y0, radius);
+}
+
+void rasterRoundBounds(struct Rect *bounds, int x0, int y0, int radius,
+                       int width, int height)
+{
+    if (radius < 0)
+    {
+        /* Too weird to bother working out; always clip. */
+        InitRect(bounds, x0, y0, 0, 0);
+        return;
+    }
+
+    bounds->left = x0 + (width - radius - 1 < 0 ? width - radius - 1 : 0);
+    bounds->top = y0 + (height - radius - 1 < 0 ? height - radius - 1 : 0);
+    bounds->right = x0 + (width - 1 > radius ? width - 1 : radius);
+    bounds->bottom = y0 + (height - 1 > radius ? height - 1 : radius);
+}
+
+static void roundPoints(const struct Raster *r, int x0, int y0, int radius,
+                        int x, int y, int width, int height)
+{
+    /* SE */
+    r->spans->pixel(r, x0 + x + width - radius - 1,
+                    y0 + y + height - radius - 1);
+    r->spans->pixel(r, x0 + y + width - radius - 1,
+                    y0 + x + height - radius - 1);
+
+    /* NE */
+    r->spans->pixel(r, x0 + y + width - radius - 1, y0 - x + radius);
+    r->spans->pixel(r, x0 + x + width - radius - 1, y0 - y + radius);
+
+    /* NW */
+    r->spans->pixel(r, x0 - x + radius, y0 - y + radius);
+    r->spans->pixel(r, x0 - y + radius, y0 - x + radius);
+
+    /* SW */
+    r->spans->pixel(r, x0 - y + radius, y0 + x + height - radius - 1);
+    r->spans->pixel(r, x0 - x + radius, y0 + y + height - radius - 1);
+}
+
+void rasterDrawRoundRect(const struct Raster *base, int x0, int y0,
+                         int radius, int width, int height)
+{
+    int x;
+    int y;
+    int d;
+    int deltaE;
+    int deltaNE;
+    struct Rect bounds;
+    struct Raster raster;
+    const struct Raster *r = &raster;
+
+    /* TODO Fix crash when radius is more curvy than a circle is allowed to be
+     * */
+
+    rasterRoundBounds(&bounds, x0, y0, radius, width, height);
+    if (!beginRaster(&raster, base, &bounds))
+    {
+        return;
+    }
+
+    /* Draw rectangle portion, without corners */
+    r->spans->vline(r, x0, y0 + radius + 1,
+                    height - 2 - 2 * radius); /* Left */
+    r->spans->hline(r, x0 + 1 + radius, y0,
+                    width - 2 - 2 * radius); /* Top */
+    r->spans->vline(r, x0 + width - 1, y0 + radius + 1,
+                    height - 2 - 2 * radius); /* Right */
+    r->spans->hline(r, x0 + 1 + radius, y0 + height - 1,
+                    width - 2 - 2 * radius); /* Bottom */
+
+    /* Same as DrawCircle(), but with roundPoints() */
+    x = 0;
+    y = radius;
+    d = 1 - radius;
+    deltaE = 3;
+    deltaNE = -2 * radius + 5;
+    roundPoints(r, x0, y0, radius, x, y, width, height);
+
+    while (y > x)
+    {
+        if (d < 0)
+        {
+            /* East */
+            d += deltaE;
+            deltaE += 2;
+            deltaNE += 2;
+        }
+        else
+        {
+            /* Northeast */
+            d += deltaNE;
+            deltaE += 2;
+            deltaNE += 4;
+            --y;
+        }
+        ++x;
+        roundPoints(r, x0, y0, radius, x, y, width, height);
+    }
+}
+
+void DrawRoundRect(int x0, int y0, int radius, int width, int height)
+{
+    struct Rect rect;
+
+    if (recording)
+    {
+        recordInts(CMD_DRAW_ROUND_RECT, x0, y0, radius, width, height);
+        return;
+    }
+
+    InitRect(&rect, x0, y0, width, height);
+    AddDamage(&rect);
+    rasterDrawRoundRect(&screenRaster, x0, y0, radius, width, height);
+}
+
+/* Draw a row of a rounded rectangle's corners, h further out than the
+ * corners' middles. */
+static void roundSpan(const struct Raster *r, int x0, int y, int radius,
+                      int width, int h)
+{
+    if (h >= 0)
+    {
+        r->spans->hline(r, x0 + radius - h, y, width - 2 * radius + 2 * h);
+    }
+}
+
+void rasterFillRoundRect(const struct Raster *base, int x0, int y0,
+                         int radius, int width, int height)
+{
+    int buf[MAX_ROUND_RADIUS + 1];
+    int *made;
+    const int *half;
+    int top;
+    int bottom;
+    int d;
+    struct Rect rect;
+    struct Raster raster;
+    const struct Raster *r = &raster;
+
+    rasterRoundBounds(&rect, x0, y0, radius, width, height);
+    if (!beginRaster(&raster, base, &rect))
+    {
+        return;
+    }
+
+    /* Too weird to round; fill it square. */
+    if (radius < 0)
+    {
+        radius = 0;
+    }
+
+    /* Use FillRect() to set mode for us, and avoid extra register setting */
+    rect.left = x0;
+    rect.top = y0 + radius + 1;
+    rect.right = rect.left + width - 1;
+    rect.bottom = rect.top + height - radius - radius - 2 - 1;
+    fillRect(r, &rect);
+
+    made = radius > MAX_ROUND_RADIUS ?
+        pmalloc((radius + 1) * sizeof(*made)) : buf;
+    half = roundTable(radius, made);
+
+    /* The rows through the middles of the top and bottom corners */
+    top = y0 + radius;
+    bottom = y0 + height - radius - 1;
+
+    /* Short rects have rows in both the top and bottom corners. Those get
+     * one span, as wide as the wider of the two. */
+    for (d = 0; d <= radius; ++d)
+    {
+        int h = half[d];
+        int e = top - d - bottom;
+
+        if (e >= 0 && e <= radius && half[e] > h)
+        {
+            h = half[e];
+        }
+        roundSpan(r, x0, top - d, radius, width, h);
+    }
+    for (d = 0; d <= radius; ++d)
+    {
+        int e = top - bottom - d;
+
+        if (e < 0 || e > radius)
+        {
+            roundSpan(r, x0, bottom + d, radius, width, half[d]);
+        }
+    }
+
+    if (made != buf)
+    {
+        pfree(made);
+    }
+}
+
+void FillRoundRect(int x0, int y0, int radius, int width, int height)
+{
+    struct Rect rect;
+
+    if (recording)
+    {
+        recordInts(CMD_FILL_ROUND_RECT, x0, y0, radius, width, height);
+        return;
+    }
+
+    InitRect(&rect, x0, y0, width, height);
+    AddDamage(&rect);
+    rasterFillRoundRect(&screenRaster, x0, y0, radius, width, height);
+}
+
+static void polygonSpan(int x, int y, int width, const void *ctx)
+{
+    const struct Raster *r = ctx;
+
+    spanWriter(r->format)->hline(r, x, y, width);
+}
+
+void FillPolygon(const int *xy, size_t n, int rule)
+{
+    struct Rect bounds;
+
+    if (recording)
+    {
+        recordPolygon(xy, n, rule);
+        return;
+    }
+
+    /* Spans come already clipped, so go straight to the framebuffer, as
+     * FillRect() does. */
+    if (polygonBounds(&bounds, xy, n))
+    {
+        AddDamage(&bounds);
+    }
+    scanPolygon(xy, n, rule, &screenRaster.clip, polygonSpan, &screenRaster);
+}
+
+static u8 widen5(unsigned int c)
+{
+    c &= 0x1F;
+
+    return (u8)((c << 3) | (c >> 2));
+}
+
+/* Convert an RGB pixel of srcFormat to the framebuffer's format, the slow
+ * way. */
+static u32 convertPixel(const u8 *src, int srcFormat)
+{
+    u16 p16;
+    u32 p32;
+
+    if (srcFormat == PIXEL_FORMAT_BGR555)
+    {
+        memcpy(&p16, src, sizeof(p16));
+        return rasterRGB(widen5(p16), widen5(p16 >> 5), widen5(p16 >> 10));
+    }
+
+    memcpy(&p32, src, sizeof(p32));
+    return rasterRGB((u8)(p32 >> 16), (u8)(p32 >> 8), (u8)p32);
+}
+
+void rasterConvertRow(u8 *dst, const u8 *src, int srcFormat, int width,
+                      const u32 *lut)
+{
+    int format = screenRaster.format;
+    int bpp = bytesPerPixel(format);
+    int x;
+
+    if (srcFormat == format)
+    {
+        memcpy(dst, src, (size_t)width * bpp);
+    }
+    else if (lut)
+    {
+        convertLookup(dst, bpp, src, width, lut);
+    }
+    else if (format == PIXEL_FORMAT_XRGB8888)
+    {
+        convertBGR555ToXRGB8888(dst, src, width);
+    }
+    else if (format == PIXEL_FORMAT_BGR555)
+    {
+        convertXRGB8888ToBGR555(dst, src, width);
+    }
+    else
+    {
+        /* Finding the nearest palette entry is slow regardless. */
+        for (x = 0; x < width; ++x)
+        {
+            dst[x] = (u8)convertPixel(&src[x * bytesPerPixel(srcFormat)],
+                                      srcFormat);
+        }
+    }
+}
+
+const u32 *rasterLookup(int srcFormat, u32 *table)
+{
+    int i;
+
+    /* 8bpp sources only have 256 colors to convert, so convert them once up
+     * front. */
+    if (srcFormat == PIXEL_FORMAT_HSV8)
+    {
+        return getHueColors();
+    }
+
+    if (srcFormat == PIXEL_FORMAT_INDEX8 &&
+        screenRaster.format != PIXEL_FORMAT_INDEX8)
+    {
+        for (i = 0; i < 256; ++i)
+        {
+            table[i] = rasterColor(i % NUM_COLORS);
+        }
+        return table;
+    }
+
+    return NULL;
+}
+
+int DrawPixelArray(const struct Rect *dst, const void *src, int srcPitch,
+                   int srcFormat)
+{
+    struct Rect clipped;
+    u32 table[256];
+    const u32 *lut;
+    int srcBpp;
+    int dstBpp;
+    int width;
+    int y;
+
+    if (srcFormat < 0 || srcFormat > PIXEL_FORMAT_HSV8)
+    {
+        return -1;
+    }
+
+    if (recording)
+    {
+        recordBlit(CMD_DRAW_PIXEL_ARRAY, src, NULL, srcFormat, dst, NULL,
+                   srcPitch);
+        return 0;
+    }
+
+    AddDamage(dst);
+
+    clipped = *dst;
+    if (clipped.right < clipped.left || clipped.bottom < clipped.top ||
+        ClipRect(&clipped, &screenRaster.clip) == CLIP_REJECTED)
+    {
+        return 0;
+    }
+
+    lut = rasterLookup(srcFormat, table);
+
+    srcBpp = bytesPerPixel(srcFormat);
+    dstBpp = bytesPerPixel(screenRaster.format);
+    width = clipped.right - clipped.left + 1;
+    for (y = clipped.top; y <= clipped.bottom; ++y)
+    {
+        const u8 *s = (const u8 *)src + (y - dst->top) * srcPitch +
+                      (clipped.left - dst->left) * srcBpp;
+        u8 *d = &screenRaster.pixels[y * screenRaster.pitch +
+                                     clipped.left * dstBpp];
+
+        rasterConvertRow(d, s, srcFormat, width, lut);
+    }
+
+    return 0;
+}
@@ -0,0 +1,113 @@
+/*
+ *  raster.h
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef RASTER_H
+#define RASTER_H
+
+#include "span.h"
+#include "guikit/ptypes.h"
+#include <stddef.h>
+
+struct LineSeg;
+struct Rect;
+
+/* Backends that render into memory share the rectangle, line, circle, and
+ * rounded rectangle drawing in raster.c. They point it at their framebuffer
+ * with rasterInit() and keep screenRaster.color up to date with the current
+ * pen color. */
+extern struct Raster screenRaster;
+
+void rasterInit(u8 *pixels, int pitch, int format, int width, int height);
+
+/* The whole screen, whatever clip rects have been pushed */
+const struct Rect *rasterScreen(void);
+
+/* Return non-zero if nothing within rect would get through the clip rect, so
+ * drawing there can be skipped up front. */
+int rasterRejects(const struct Rect *rect);
+
+/* Backends provide this, to clip their own drawing to screenRaster's clip rect
+ * when PushClipRect() or PopClipRect() changes it. */
+void rasterClipChanged(void);
+
+/* Backends provide these, to convert a color into screenRaster's pixel format
+ * the same way the pen would. */
+u32 rasterColor(int color);
+u32 rasterRGB(u8 r, u8 g, u8 b);
+
+/* Backends provide this too, to set the pen to an RGB color that's already
+ * been converted with rasterRGB(). */
+void rasterSetPenRGB(u8 r, u8 g, u8 b, u32 color);
+
+/* Backends call this when the palette of an indexed screen changes, so that
+ * pen colors get mapped to it afresh. */
+void rasterPaletteChanged(void);
+
+/* Get ready to convert pixels from srcFormat with rasterConvertRow(). Returns
+ * a table to look 8bpp formats up in, filling in table if need be, or NULL. */
+const u32 *rasterLookup(int srcFormat, u32 *table);
+
+/* Convert width pixels of srcFormat into the framebuffer's format, as with
+ * DrawPixelArray(). lut comes from rasterLookup(). Only reads shared state,
+ * so can be called from many threads at once. */
+void rasterConvertRow(u8 *dst, const u8 *src, int srcFormat, int width,
+                      const u32 *lut);
+
+/* The drawing behind the public functions of the same name, into base with
+ * its color, clipped to its clip rect. These don't record or add damage, and
+ * only touch pixels within base's clip rect, so can draw separate parts of
+ * the screen at the same time. */
+void rasterFillRect(const struct Raster *base, const struct Rect *rect);
+void rasterDrawRect(const struct Raster *base, const struct Rect *rect);
+void rasterFillRectOp(const struct Raster *base, const unsigned char *pattern,
+                      int op, const struct Rect *rect);
+void rasterVertLine(const struct Raster *base, int x1, int y1, int len);
+void rasterHorizLine(const struct Raster *base, int x1, int y1, int len);
+void rasterDiagLine(const struct Raster *base, int x1, int y1, int x2,
+                    int len);
+void rasterLine(const struct Raster *base, int x1, int y1, int x2, int y2);
+void rasterDrawCircle(const struct Raster *base, int x0, int y0, int radius);
+void rasterFillCircle(const struct Raster *base, int x0, int y0, int radius);
+void rasterDrawRoundRect(const struct Raster *base, int x0, int y0,
+                         int radius, int width, int height);
+void rasterFillRoundRect(const struct Raster *base, int x0, int y0,
+                         int radius, int width, int height);
+
+/* Draw n rects or lines, each in its own color if colors is given. */
+void rasterFillRects(const struct Raster *base, const struct Rect *rects,
+                     const u32 *colors, size_t n);
+void rasterLines(const struct Raster *base, const struct LineSeg *lines,
+                 const u32 *colors, size_t n);
+
+/* Find where a batch's pixels can land. Inside out rects are left out, and if
+ * that leaves nothing, returns 0. There must be at least one line. */
+int rasterRectsBounds(struct Rect *bounds, const struct Rect *rects,
+                      size_t n);
+void rasterLinesBounds(struct Rect *bounds, const struct LineSeg *lines,
+                       size_t n);
+
+/* Filled circles and rounded rectangles keep tables of their rows' widths for
+ * small radii. Make sure the table for radius is kept. */
+void rasterKeepRound(int radius);
+
+/* Between these, kept tables aren't changed, so filled circles and rounded
+ * rectangles can be drawn from many threads at once. */
+void rasterHoldRound(void);
+void rasterReleaseRound(void);
+
+/* Find where a rounded rectangle's pixels can land. This is the rectangle
+ * itself, unless the radius is too big for it. */
+void rasterRoundBounds(struct Rect *bounds, int x0, int y0, int radius,
+                       int width, int height);
+
+/* Combine a byte of 1bpp source with the given row of an 8x8 pattern,
+ * according to op (one of the OP_* drawing operations). */
+unsigned char rasterOp(int op, unsigned char src, const unsigned char *pat,
+                       size_t row);
+
+#endif
@@ -0,0 +1,135 @@
+/*
+ *  record.h
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef RECORD_H
+#define RECORD_H
+
+#include "guikit/primrect.h"
+#include "guikit/ptypes.h"
+#include "guikit/shade.h"
+#include <stddef.h>
+
+struct DisplayList;
+
+/* The list being recorded into, or NULL. Drawing functions check this first,
+ * and when set, record themselves with one of the functions below instead of
+ * drawing. */
+extern struct DisplayList *recording;
+
+enum {
+    CMD_FILL_SCREEN,
+    CMD_DRAW_RECT,
+    CMD_FILL_RECT,
+    CMD_FILL_RECT_OP,
+    CMD_VERT_LINE,
+    CMD_HORIZ_LINE,
+    CMD_DIAG_LINE,
+    CMD_LINE,
+    CMD_DRAW_CIRCLE,
+    CMD_FILL_CIRCLE,
+    CMD_DRAW_ROUND_RECT,
+    CMD_FILL_ROUND_RECT,
+    CMD_DRAW_BITMAP,
+    CMD_DRAW_COLOR_BITMAP,
+    CMD_BLIT_OP,
+    CMD_BLIT_WITH_MASK,
+    CMD_GLYPHS,
+    CMD_DRAW_PIXEL_ARRAY,
+    CMD_RENDER_PER_PIXEL,
+    CMD_RENDER_PER_ROW,
+    CMD_FILL_RECTS_COLORS,
+    CMD_LINES_COLORS,
+    CMD_PUSH_CLIP,
+    CMD_POP_CLIP,
+    CMD_FILL_POLYGON,
+    CMD_FLOOD_FILL,
+    CMD_BOUNDARY_FILL,
+    NUM_CMDS
+};
+
+struct Pen
+{
+    int color; /* One of COLOR_*, or -1 to use r, g, and b */
+    u8 r;
+    u8 g;
+    u8 b;
+};
+
+struct Command
+{
+    int type; /* One of CMD_* */
+    struct Pen pen;
+    int a[5];
+    struct Rect dst;
+    struct Rect src;
+    const unsigned char *img;
+    const unsigned char *mask; /* Or pattern, for CMD_FILL_RECT_OP */
+
+    /* For CMD_GLYPHS, pairs of dst and src rects, one pair per glyph */
+    struct Rect *glyphs;
+    size_t numGlyphs;
+    size_t capGlyphs;
+
+    /* For CMD_RENDER_PER_PIXEL and CMD_RENDER_PER_ROW */
+    color_fn colorFn;
+    row_fn rowFn;
+    void *ctx;
+
+    /* For CMD_FILL_RECTS_COLORS and CMD_LINES_COLORS, the caller's rects or
+     * lines, and a color for each. For CMD_FILL_POLYGON, the caller's
+     * points. */
+    const void *items;
+    const u32 *colors;
+    size_t numItems;
+};
+
+/* Record a command taking up to 5 int arguments, in the order the drawing
+ * function takes them. */
+void recordInts(int type, int a, int b, int c, int d, int e);
+
+/* Record a command taking a rect. */
+void recordRect(int type, const struct Rect *rect);
+
+void recordFillRectOp(const unsigned char *pattern, int op,
+                      const struct Rect *rect);
+
+/* Record a blit or bitmap. src is NULL for bitmaps. */
+void recordBlit(int type, const unsigned char *img, const unsigned char *mask,
+                int op, const struct Rect *dst, const struct Rect *src,
+                int span);
+
+/* Record a RenderPerPixel() (with colorFn) or RenderPerRow() (with rowFn). */
+void recordShade(const struct Rect *area, int format, color_fn colorFn,
+                 row_fn rowFn, void *ctx);
+
+/* Record a batch of n rects or lines, each with its own color. */
+void recordBatch(int type, const void *items, const u32 *colors, size_t n);
+
+/* Record a FillPolygon(). */
+void recordPolygon(const int *xy, size_t n, int rule);
+
+/* Record drawing a glyph from img like atlasBlit() would. Glyphs from the
+ * same image in the same color, one after another, are kept together. */
+void recordGlyph(const unsigned char *img, int span, int height,
+                 const struct Rect *dst, const struct Rect *src);
+
+/* Backends call these whenever the pen color changes, so each command can be
+ * recorded with the pen it would have drawn with. */
+void notePenColor(int color);
+void notePenRGB(u8 r, u8 g, u8 b);
+
+int samePen(const struct Pen *a, const struct Pen *b);
+
+/* Make p the pen, through SetColor() or SetColorRGB() */
+void setPen(const struct Pen *p);
+
+/* Draw c, as with the drawing call it was recorded from, with the current
+ * pen. */
+void executeCommand(const struct Command *c);
+
+#endif
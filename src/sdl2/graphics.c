@@ -7,13 +7,25 @@
  */
 
 #include "guikit/graphics.h"
+#include "guikit/damage.h"
 #include "guikit/panic.h"
+#include "guikit/pmemory.h"
+#include "guikit/present.h"
 #include "guikit/primrect.h"
+#include "atlas.h"
+#include "expand.h"
+#include "polygon.h"
+#include "raster.h"
+#include "record.h"
+#include "workers.h"
 #include <SDL.h>
+#include <stddef.h>
 #include <stdio.h>
+#include <string.h>
 
 #define ARRAY_SIZE(x) (sizeof(x) / sizeof((x)[0]))
 #define COLOR_TRANSPARENT 16
+#define COLOR_PEN 17
 
 static const struct SDL_Color mac_pal[] = {
     {0x00, 0x00, 0x00, 0xFF}, /* Black */
@@ -40,17 +52,68 @@ const unsigned char blackPattern[] = {0, 0, 0, 0, 0, 0, 0, 0};
 static SDL_Window *window;
 static SDL_Surface *surface;
 static SDL_Renderer *renderer;
+static SDL_Texture *texture;
 static Uint8 *pixels;
 static int pitch;
 static Uint32 penColor;
 static int setColor;
 
+/* With GRAPHICS_ASYNC_PRESENT, the presenter thread owns the renderer and
+ * texture. ShowGraphics() hands it the surface just drawn, along with its
+ * damage, and drawing carries on in the spare surface. */
+static SDL_Thread *presenter;
+static SDL_Surface *spare;
+static SDL_mutex *presentLock;
+static SDL_cond *presentCond; /* Signalled whenever the below change */
+static SDL_Surface *presenting; /* NULL when the presenter is idle */
+static struct Rect *presentDamage;
+static size_t numPresentDamage;
+static size_t capPresentDamage;
+static int presenterReady;
+static int presenterQuit;
+
+/* Indexed surfaces can't be uploaded to a texture as-is, so we expand them
+ * through this lookup table into ARGB8888 on upload. */
+static Uint32 texturePalette[256];
+static int paletteChanged; /* Since texturePalette was last updated */
+
 /* An 8x8 1-bit bitmap, packed 1bpp */
 static const unsigned char *currentPattern;
 
+/* The pen color as RGB, for the COLOR_PEN entry of scratch surfaces */
+static SDL_Color penRGB = {0x00, 0x00, 0x00, 0xFF};
+
+/* Bitmaps are colorized into these before being blitted to the screen. They
+ * are bucketed by power of two width and height and kept around until
+ * FreeGraphics(), so we don't allocate a surface for every blit. Only sizes up
+ * to the largest bucket are kept, which holds the pool to a few megabytes;
+ * bigger blits get a surface of their own for just that blit. */
+enum {
+    MIN_SCRATCH_SHIFT = 3, /* 8 pixels */
+    NUM_SCRATCH_BUCKETS = 8, /* Up to 1024 pixels */
+    MAX_SCRATCH_SIZE = 1 << (MIN_SCRATCH_SHIFT + NUM_SCRATCH_BUCKETS - 1)
+};
+static SDL_Surface *scratch[NUM_SCRATCH_BUCKETS][NUM_SCRATCH_BUCKETS];
+
+/* A row of 1bpp source after applying a drawing operation. Wider rows are done
+ * a piece at a time. */
+static Uint8 opRow[MAX_SCRATCH_SIZE / 8];
+
+static int isIndexed(void)
+{
+    return SDL_ISPIXELFORMAT_INDEXED(surface->format->format);
+}
+
 static Uint32 surfaceColor(int color)
 {
     const SDL_Color *c;
+
+    /* Colors are palette entries, whatever they've been changed to. */
+    if (isIndexed())
+    {
+        return color & 0xF;
+    }
+
     c = &mac_pal[color & 0xF];
 
     return SDL_MapRGBA(surface->format, c->r, c->g, c->b, c->a);
@@ -61,1037 +124,896 @@ static Uint32 surfaceRGB(Uint8 r, Uint8 g, Uint8 b)
     return SDL_MapRGBA(surface->format, r, g, b, 0xFF);
 }
 
-/* TODO Add mode parameter to InitGraphics(), so we can pick 16 color or 16-bit
- * color. */
+u32 rasterColor(int color)
+{
+    return surfaceColor(color);
+}
 
-int InitGraphicsBGR555(const char *name)
+u32 rasterRGB(u8 r, u8 g, u8 b)
 {
-    int ret;
+    return surfaceRGB(r, g, b);
+}
 
-    currentPattern = blackPattern;
+static int scratchBucket(int size)
+{
+    int bucket;
 
-    ret = SDL_Init(SDL_INIT_VIDEO);
-    if (ret < 0)
+    bucket = 0;
+    while ((1 << (bucket + MIN_SCRATCH_SHIFT)) < size)
     {
-        panic("SDL Error: %s\n", SDL_GetError());
+        ++bucket;
     }
 
-    SDL_SetHintWithPriority(SDL_HINT_RENDER_VSYNC, "1", SDL_HINT_OVERRIDE);
+    return bucket;
+}
 
-    /* Don't disable the compositor. */
-    SDL_SetHint(SDL_HINT_VIDEO_X11_NET_WM_BYPASS_COMPOSITOR, "0");
+static SDL_Surface *newScratch(int width, int height)
+{
+    SDL_Surface *s;
 
-    window = SDL_CreateWindow(name, SDL_WINDOWPOS_UNDEFINED,
-                  SDL_WINDOWPOS_UNDEFINED, SCREEN_WIDTH, SCREEN_HEIGHT,
-                  SDL_WINDOW_ALLOW_HIGHDPI /* | SDL_WINDOW_FULLSCREEN_DESKTOP*/);
-    if (window == NULL)
+    s = SDL_CreateRGBSurfaceWithFormat(0, width, height, 8,
+                                       SDL_PIXELFORMAT_INDEX8);
+    if (!s)
     {
         panic("SDL Error: %s\n", SDL_GetError());
     }
+    if (isIndexed())
+    {
+        /* With the same palette as the screen, blits copy indices
+         * straight across, however the palette has been changed. */
+        SDL_SetPaletteColors(s->format->palette,
+                             surface->format->palette->colors, 0,
+                             surface->format->palette->ncolors);
+    }
+    else
+    {
+        SDL_SetPaletteColors(s->format->palette, mac_pal, 0,
+                             ARRAY_SIZE(mac_pal));
+        SDL_SetPaletteColors(s->format->palette, &penRGB, COLOR_PEN, 1);
+    }
+    SDL_SetColorKey(s, SDL_TRUE, COLOR_TRANSPARENT);
 
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
-    if (renderer == NULL)
+    return s;
+}
+
+/* Get a scratch surface at least width by height. Its contents are left over
+ * from whatever used it last. Hand it back with putScratch() after blitting
+ * from it. */
+static SDL_Surface *getScratch(int width, int height)
+{
+    SDL_Surface *s;
+    SDL_Color *pen;
+    int w;
+    int h;
+
+    if (width > MAX_SCRATCH_SIZE || height > MAX_SCRATCH_SIZE)
     {
-        panic("SDL Error: %s\n", SDL_GetError());
+        return newScratch(width, height);
     }
 
-    /* Set up a BGR555 format surface */
-    surface =
-        SDL_CreateRGBSurface(0, SCREEN_WIDTH, SCREEN_HEIGHT, 16, 0x001F,
-        0x03E0, 0x7C00, 0);
-    if (surface == NULL)
+    w = scratchBucket(width);
+    h = scratchBucket(height);
+
+    s = scratch[h][w];
+    if (!s)
     {
-        panic("SDL Error: %s\n", SDL_GetError());
+        s = newScratch(1 << (w + MIN_SCRATCH_SHIFT),
+                       1 << (h + MIN_SCRATCH_SHIFT));
+        scratch[h][w] = s;
     }
-    SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
-    pixels = surface->pixels;
-    pitch = surface->pitch;
 
-    /* Update the screen with the new surface. */
-    ret = SDL_FillRect(surface, NULL, surfaceRGB(0xFF, 0xFF, 0xFF));
-    if (ret < 0)
+    if (isIndexed())
     {
-        panic("SDL Error: %s\n", SDL_GetError());
+        return s;
     }
 
-    ShowGraphics();
+    /* Changing the palette makes SDL rebuild its blit mapping, so only do it
+     * when the pen has actually changed. */
+    pen = &s->format->palette->colors[COLOR_PEN];
+    if (pen->r != penRGB.r || pen->g != penRGB.g || pen->b != penRGB.b)
+    {
+        SDL_SetPaletteColors(s->format->palette, &penRGB, COLOR_PEN, 1);
+    }
 
-    return 0;
+    return s;
 }
 
-int InitGraphics(void)
+static void putScratch(SDL_Surface *s)
 {
-    int ret;
+    /* Only surfaces too big for the pool are left out of it. */
+    if (s->w > MAX_SCRATCH_SIZE || s->h > MAX_SCRATCH_SIZE)
+    {
+        SDL_FreeSurface(s);
+    }
+}
 
-    currentPattern = blackPattern;
+static void freeScratch(void)
+{
+    int w;
+    int h;
 
-    ret = SDL_Init(SDL_INIT_VIDEO);
-    if (ret < 0)
+    for (h = 0; h < NUM_SCRATCH_BUCKETS; ++h)
     {
-        panic("SDL Error: %s\n", SDL_GetError());
+        for (w = 0; w < NUM_SCRATCH_BUCKETS; ++w)
+        {
+            SDL_FreeSurface(scratch[h][w]);
+            scratch[h][w] = NULL;
+        }
     }
+}
 
-    SDL_SetHintWithPriority(SDL_HINT_RENDER_VSYNC, "1", SDL_HINT_OVERRIDE);
+/* The scratch surface color to draw with the pen. Indexed screens share the
+ * scratch palette, so the pen is already an index; others use COLOR_PEN. */
+static Uint8 scratchPen(void)
+{
+    return isIndexed() ? (Uint8)penColor : COLOR_PEN;
+}
 
-    /* Don't disable the compositor. */
-    SDL_SetHint(SDL_HINT_VIDEO_X11_NET_WM_BYPASS_COMPOSITOR, "0");
+static void updateTexturePalette(void)
+{
+    const SDL_Palette *pal;
+    int i;
 
-    window = SDL_CreateWindow("Patater GUI Kit", SDL_WINDOWPOS_UNDEFINED,
-                  SDL_WINDOWPOS_UNDEFINED, SCREEN_WIDTH, SCREEN_HEIGHT,
-                  SDL_WINDOW_ALLOW_HIGHDPI /* | SDL_WINDOW_FULLSCREEN_DESKTOP*/);
-    if (window == NULL)
+    pal = surface->format->palette;
+    for (i = 0; i < pal->ncolors; ++i)
     {
-        panic("SDL Error: %s\n", SDL_GetError());
+        const SDL_Color *c = &pal->colors[i];
+        texturePalette[i] = 0xFF000000U | (Uint32)c->r << 16 |
+                            (Uint32)c->g << 8 | (Uint32)c->b;
     }
+}
 
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
-    if (renderer == NULL)
+static void createTexture(void)
+{
+    Uint32 format;
+
+    /* Use a texture with the same format as our surface, so SDL can copy
+     * pixels straight across, except for indexed surfaces which we expand
+     * ourselves. */
+    if (isIndexed())
     {
-        panic("SDL Error: %s\n", SDL_GetError());
+        format = SDL_PIXELFORMAT_ARGB8888;
+        updateTexturePalette();
+    }
+    else
+    {
+        format = surface->format->format;
     }
 
-    /* We might use a bit-depth of 4, but SDL has a bug that means this doesn't
-     * work. We could use a depth of 8 as a workaround. However, we've found a
-     * need to actually use 8 because we want to use a color key for
-     * transparency (without losing one of our 16 colors). There doesn't seem
-     * to be another way to SDL_BlitSurface with some areas of the dst rect not
-     * getting updated without either a color key (fast) or use of alpha
-     * blending (slow). */
-    surface =
-        SDL_CreateRGBSurface(0, SCREEN_WIDTH, SCREEN_HEIGHT, 8, 0, 0, 0, 0);
-    if (surface == NULL)
+    texture = SDL_CreateTexture(renderer, format, SDL_TEXTUREACCESS_STREAMING,
+                                surface->w, surface->h);
+    if (texture == NULL)
     {
         panic("SDL Error: %s\n", SDL_GetError());
     }
-    SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
-    SDL_SetPaletteColors(surface->format->palette, mac_pal, 0,
-                         ARRAY_SIZE(mac_pal));
-    SDL_SetColorKey(surface, SDL_TRUE, COLOR_TRANSPARENT); /* Needed? */
-    pixels = surface->pixels;
-    pitch = surface->pitch;
+}
 
-    /* Update the screen with the new surface. */
-    ret = SDL_FillRect(surface, NULL, surfaceColor(COLOR_WHITE));
-    if (ret < 0)
+static void createRenderer(void)
+{
+    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+    if (renderer == NULL)
     {
         panic("SDL Error: %s\n", SDL_GetError());
     }
 
-    ShowGraphics();
-
-    return 0;
+    createTexture();
 }
 
-void FreeGraphics(void)
+static void initDamage(void)
 {
-    SDL_FreeSurface(surface);
-    SDL_DestroyRenderer(renderer);
-    SDL_DestroyWindow(window);
-    SDL_Quit();
+    struct Rect screen;
+
+    InitRect(&screen, 0, 0, surface->w, surface->h);
+    SetDamageBounds(&screen);
+    AddDamageAll();
 }
 
-void ShowGraphics(void)
+static void uploadIndexed(const SDL_Surface *s, const SDL_Rect *r)
 {
+    void *dst;
+    int dstPitch;
     int ret;
-    SDL_Texture *texture;
-
-    /* Seems needed on mac for some reason, otherwise window doesn't show up...
-     * */
-    SDL_Event event;
-    SDL_PollEvent(&event);
+    int x;
+    int y;
 
-    texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if (texture == 0)
+    ret = SDL_LockTexture(texture, r, &dst, &dstPitch);
+    if (ret < 0)
     {
         panic("SDL Error: %s\n", SDL_GetError());
     }
-    ret = SDL_RenderCopy(renderer, texture, NULL, NULL);
-    if (ret < 0)
+
+    for (y = 0; y < r->h; ++y)
     {
-        panic("SDL Error: %s\n", SDL_GetError());
+        const Uint8 *src;
+        Uint32 *d;
+
+        src = (const Uint8 *)s->pixels + (r->y + y) * s->pitch + r->x;
+        d = (Uint32 *)((Uint8 *)dst + y * dstPitch);
+        for (x = 0; x < r->w; ++x)
+        {
+            d[x] = texturePalette[src[x]];
+        }
     }
 
-    SDL_RenderPresent(renderer);
-    SDL_DestroyTexture(texture); /* It'd be nice to re-use the texture... */
+    SDL_UnlockTexture(texture);
 }
 
-int SaveScreenShot(const char *path)
+static void uploadRect(const SDL_Surface *s, const struct Rect *rect)
 {
+    SDL_Rect r;
     int ret;
 
-    ret = SDL_SaveBMP(surface, path);
-    if (ret)
+    r.x = rect->left;
+    r.y = rect->top;
+    r.w = rect->right - rect->left + 1;
+    r.h = rect->bottom - rect->top + 1;
+
+    if (SDL_ISPIXELFORMAT_INDEXED(s->format->format))
     {
-        printf("SDL_SaveBMP failed: %s\n", SDL_GetError());
+        uploadIndexed(s, &r);
+        return;
     }
 
-    return ret;
+    ret = SDL_UpdateTexture(texture, &r,
+                            (const Uint8 *)s->pixels + r.y * s->pitch +
+                                r.x * s->format->BytesPerPixel,
+                            s->pitch);
+    if (ret < 0)
+    {
+        panic("SDL Error: %s\n", SDL_GetError());
+    }
 }
 
-void SetColor(int color)
+/* Send the damaged parts of s to the texture and show it. The texture keeps
+ * the rest from previous frames. */
+static void present(const SDL_Surface *s, const struct Rect *damage,
+                    size_t num)
 {
-    setColor = color;
-    penColor = surfaceColor(color);
-}
+    size_t i;
+    int ret;
 
-void SetColorRGB(unsigned char r, unsigned char g, unsigned char b)
-{
-    penColor = surfaceRGB(r, g, b);
+    for (i = 0; i < num; ++i)
+    {
+        uploadRect(s, &damage[i]);
+    }
+
+    ret = SDL_RenderCopy(renderer, texture, NULL, NULL);
+    if (ret < 0)
+    {
+        panic("SDL Error: %s\n", SDL_GetError());
+    }
+
+    SDL_RenderPresent(renderer);
 }
 
-void SetColorHSV(unsigned char h, unsigned char s, unsigned char v)
+static int SDLCALL presenterMain(void *unused)
 {
-    enum {
-        MAX_H = 255, /* Maximum value of h */
-        MAX_C = 255, /* Max value for s, v, r, g, b */
-        THE_END = 0
-    };
-    unsigned char r;
-    unsigned char g;
-    unsigned char b;
-    const unsigned int hi = h / (MAX_H / 6 + 1);
-    const unsigned int hj = (h - hi * (MAX_H / 6 + 1)) * 6;
-    const unsigned int p = v * (MAX_C - s) / MAX_C;
-    const unsigned int q = v * (MAX_C - (s * hj) / MAX_H) / MAX_C;
-    const unsigned int t = v * (MAX_C - (s * (MAX_H - hj)) / MAX_H) / MAX_C;
-
-    switch (hi)
-    {
-        case 0:
-            r = v;
-            g = t;
-            b = p;
-            break;
-        case 1:
-            r = q;
-            g = v;
-            b = p;
-            break;
-        case 2:
-            r = p;
-            g = v;
-            b = t;
-            break;
-        case 3:
-            r = p;
-            g = q;
-            b = v;
-            break;
-        case 4:
-            r = t;
-            g = p;
-            b = v;
-            break;
-        case 5:
-            r = v;
-            g = p;
-            b = q;
-            break;
-        default:
-            r = 0;
-            g = 0;
-            b = 0;
+    const SDL_Surface *s;
+
+    (void)unused;
+
+    /* The renderer belongs to the thread that made it. */
+    createRenderer();
+
+    SDL_LockMutex(presentLock);
+    presenterReady = 1;
+    SDL_CondBroadcast(presentCond);
+    for (;;)
+    {
+        while (!presenting && !presenterQuit)
+        {
+            SDL_CondWait(presentCond, presentLock);
+        }
+        if (!presenting)
+        {
             break;
+        }
+        s = presenting;
+        SDL_UnlockMutex(presentLock);
+
+        present(s, presentDamage, numPresentDamage);
+
+        SDL_LockMutex(presentLock);
+        presenting = NULL;
+        SDL_CondBroadcast(presentCond);
     }
+    SDL_UnlockMutex(presentLock);
 
-    SetColorRGB(r, g, b);
-}
+    SDL_DestroyTexture(texture);
+    SDL_DestroyRenderer(renderer);
 
-void FillScreen(void)
-{
-    SDL_FillRect(surface, NULL, penColor);
+    return 0;
 }
 
-static void drawVertLine(int x, int y, int len)
+static void startPresenter(void)
 {
-    SDL_Rect r;
+    presentLock = SDL_CreateMutex();
+    presentCond = SDL_CreateCond();
+    if (!presentLock || !presentCond)
+    {
+        panic("SDL Error: %s\n", SDL_GetError());
+    }
 
-    r.x = x;
-    r.y = y;
-    r.w = 1;
-    r.h = len;
+    presenter = SDL_CreateThread(presenterMain, "guikit present", NULL);
+    if (!presenter)
+    {
+        panic("SDL Error: %s\n", SDL_GetError());
+    }
 
-    SDL_FillRect(surface, &r, penColor);
+    SDL_LockMutex(presentLock);
+    while (!presenterReady)
+    {
+        SDL_CondWait(presentCond, presentLock);
+    }
+    SDL_UnlockMutex(presentLock);
 }
 
-static void drawHorizLine(int x, int y, int len)
+static void stopPresenter(void)
 {
-    SDL_Rect r;
-
-    r.x = x;
-    r.y = y;
-    r.w = len;
-    r.h = 1;
-
-    SDL_FillRect(surface, &r, penColor);
+    SDL_LockMutex(presentLock);
+    presenterQuit = 1;
+    SDL_CondBroadcast(presentCond);
+    SDL_UnlockMutex(presentLock);
+    SDL_WaitThread(presenter, NULL);
+
+    SDL_DestroyCond(presentCond);
+    SDL_DestroyMutex(presentLock);
+    SDL_FreeSurface(spare);
+    pfree(presentDamage);
+
+    presenter = NULL;
+    spare = NULL;
+    presentDamage = NULL;
+    numPresentDamage = 0;
+    capPresentDamage = 0;
+    presenterReady = 0;
+    presenterQuit = 0;
 }
 
-void DrawRect(const struct Rect *rect)
+static void copyRect(SDL_Surface *dst, const SDL_Surface *src,
+                     const struct Rect *rect)
 {
-    int x;
+    int bpp;
     int y;
-    int width;
-    int height;
-
-    x = rect->left;
-    y = rect->top;
-    width = rect->right - rect->left + 1;
-    height = rect->bottom - rect->top + 1;
 
-    drawVertLine(x, y, height); /* Left */
-    drawHorizLine(x + 1, y, width - 1); /* Top */
-    drawVertLine(x + width - 1, y + 1, height - 1); /* Right */
-    drawHorizLine(x + 1, y + height - 1, width - 2); /* Bottom */
+    bpp = src->format->BytesPerPixel;
+    for (y = rect->top; y <= rect->bottom; ++y)
+    {
+        memcpy((Uint8 *)dst->pixels + y * dst->pitch + rect->left * bpp,
+               (const Uint8 *)src->pixels + y * src->pitch + rect->left * bpp,
+               (size_t)(rect->right - rect->left + 1) * bpp);
+    }
 }
 
-void FillRect(const struct Rect *rect)
+/* Hand the finished surface to the presenter and carry on in the spare. */
+static void flip(void)
 {
-    SDL_Rect r;
+    const struct Rect *damage;
+    SDL_Surface *done;
+    size_t num;
+    size_t i;
 
-    r.x = rect->left;
-    r.y = rect->top;
-    r.w = rect->right - rect->left + 1;
-    r.h = rect->bottom - rect->top + 1;
+    damage = GetDamage(&num);
 
-    SDL_FillRect(surface, &r, penColor);
-}
+    /* The spare is free once the presenter is done with it. */
+    SDL_LockMutex(presentLock);
+    while (presenting)
+    {
+        SDL_CondWait(presentCond, presentLock);
+    }
 
-void FillRectOp(const unsigned char *pattern,
-                int op, const struct Rect *rect)
-{
-    /* TODO */
-    (void) pattern;
-    (void) op;
-    FillRect(rect);
-}
+    /* Nor is it looking at the texture palette. */
+    if (paletteChanged)
+    {
+        updateTexturePalette();
+        paletteChanged = 0;
+    }
 
-void DrawVertLine(int x1, int y1, int len)
-{
-    drawVertLine(x1, y1, len);
+    if (num > capPresentDamage)
+    {
+        capPresentDamage = num;
+        presentDamage = prealloc(presentDamage,
+                                 num * sizeof(*presentDamage));
+    }
+    memcpy(presentDamage, damage, num * sizeof(*presentDamage));
+    numPresentDamage = num;
+    presenting = surface;
+    SDL_CondBroadcast(presentCond);
+    SDL_UnlockMutex(presentLock);
+
+    /* The spare is a frame behind, so bring it up to date before drawing
+     * into it. The presenter only reads the finished surface, so this can
+     * happen alongside. */
+    done = surface;
+    surface = spare;
+    spare = done;
+    for (i = 0; i < num; ++i)
+    {
+        copyRect(surface, done, &damage[i]);
+    }
+
+    pixels = surface->pixels;
+    screenRaster.pixels = pixels;
+    rasterClipChanged();
+
+    ClearDamage();
 }
 
-void DrawHorizLine(int x1, int y1, int len)
+static const char *vsyncHint(void)
 {
-    drawHorizLine(x1, y1, len);
+    int interval;
+
+    return GetPresentPolicy(&interval) == PRESENT_VSYNC ? "1" : "0";
 }
 
-static void drawPixel(int x, int y)
+static Uint32 windowFlags(const struct GraphicsMode *mode)
 {
-    SDL_Rect r;
+    Uint32 flags;
+    int interval;
+
+    flags = SDL_WINDOW_ALLOW_HIGHDPI;
+    if (mode->flags & GRAPHICS_FULLSCREEN)
+    {
+        flags |= SDL_WINDOW_FULLSCREEN_DESKTOP;
+    }
 
-    r.x = x;
-    r.y = y;
-    r.w = 1;
-    r.h = 1;
+    /* Nothing will ever be shown, so don't show the window either. */
+    if (GetPresentPolicy(&interval) == PRESENT_NEVER)
+    {
+        flags |= SDL_WINDOW_HIDDEN;
+    }
 
-    SDL_FillRect(surface, &r, penColor);
+    return flags;
 }
 
-static void drawDiagLine(int x1, int y1, int x2, int len)
+static SDL_Surface *createSurface(const struct GraphicsMode *mode)
 {
-    int x;
-    int y;
-    int y_start;
-    int y_end;
-    int leftToRight;
+    SDL_Surface *s;
 
-/*
-Diagonal lines for testing.
--- (40,0) -> (160,120)
-        (40,0)->(160,121)
--- (280,0) -> (160,120)
-        (280,0)->(160,121)
--- (160,120) -> (279,239)
-        (160,120)->(279,120)
--- (160,120) -> (41,239)
-        (160,120)->(41,120)
--- (360,0) -> (480,120)
-        (360,0)->(480,121)
--- (600,0) -> (480,120)
-        (600,0)->(480,121)
--- (480,120) -> (599,239)
-        (480,120)->(599,120)
--- (480,120) -> (361,239)
-        (480,120)->(361,120)
--- (40,240) -> (160,360)
-        (40,240)->(160,121)
--- (280,240) -> (160,360)
-        (280,240)->(160,121)
--- (160,360) -> (279,479)
-        (160,360)->(279,120)
--- (160,360) -> (41,479)
-        (160,360)->(41,120)
--- (360,240) -> (480,360)
-        (360,240)->(480,121)
--- (600,240) -> (480,360)
-        (600,240)->(480,121)
--- (480,360) -> (599,479)
-        (480,360)->(599,120)
--- (480,360) -> (361,479)
-        (480,360)->(361,120)
-*/
-    /*printf("\t(%d,%d)->(%d,%d)\n", x1, y1, x2, len);*/
-
-    /* Right to left or left to right */
-    /* Assumes top to bottom */
-    y_start = y1;
-    y_end = y1 + len - 1;
-    x = x1;
-
-    if (x1 < x2)
-    {
-        leftToRight = 1;
-    }
-    else
+    switch (mode->format)
     {
-        leftToRight = -1;
+    case PIXEL_FORMAT_INDEX8:
+        /* We might use a bit-depth of 4, but SDL has a bug that means this
+         * doesn't work. We could use a depth of 8 as a workaround. However,
+         * we've found a need to actually use 8 because we want to use a color
+         * key for transparency (without losing one of our 16 colors). There
+         * doesn't seem to be another way to SDL_BlitSurface with some areas
+         * of the dst rect not getting updated without either a color key
+         * (fast) or use of alpha blending (slow). */
+        s = SDL_CreateRGBSurface(0, mode->width, mode->height, 8, 0, 0, 0, 0);
+        if (s)
+        {
+            SDL_SetPaletteColors(s->format->palette, mac_pal, 0,
+                                 ARRAY_SIZE(mac_pal));
+            SDL_SetColorKey(s, SDL_TRUE, COLOR_TRANSPARENT); /* Needed? */
+        }
+        break;
+    case PIXEL_FORMAT_BGR555:
+        s = SDL_CreateRGBSurface(0, mode->width, mode->height, 16, 0x001F,
+                                 0x03E0, 0x7C00, 0);
+        break;
+    case PIXEL_FORMAT_XRGB8888:
+        /* Textures are happiest with 32-bit pixels, so this one uploads
+         * without any conversion at all. */
+        s = SDL_CreateRGBSurfaceWithFormat(0, mode->width, mode->height, 32,
+                                           SDL_PIXELFORMAT_RGB888);
+        break;
+    default:
+        return NULL;
     }
 
-    for (y = y_start; y <= y_end; ++y)
+    if (s == NULL)
     {
-        drawPixel(x, y);
-        x += leftToRight;
+        panic("SDL Error: %s\n", SDL_GetError());
     }
-}
+    SDL_SetSurfaceBlendMode(s, SDL_BLENDMODE_NONE);
 
-void DrawDiagLine(int x1, int y1, int x2, int len)
-{
-    drawDiagLine(x1, y1, x2, len);
+    return s;
 }
 
-/* XXX We are doing run-sliced bressenham. For small lines, standard bressenham
- * should be faster, (but only if we can figure out how to write more than 1
- * pixel at a time from standard bressenham). */
-/* Provide standard bressenham here, too, so we can do short lines quickly,
- * without a divide or extra setup. */
-/* Algorithm from Michael Abrash's Graphics Programming Black Book, Chapter 37.
- * Variable names and comments kept similar for ease of comparison with the
- * text. */
-void DrawLine(int x1, int y1, int x2, int y2)
+int InitGraphicsEx(const struct GraphicsMode *mode)
 {
-    int AdjUp; /* Error term adjust up on each advance*/
-    int AdjDown; /* Error term adjust down when error term turns over*/
-    int XAdvance; /* 1 or -1, for direction in which x advances*/
-    int YDelta;
-    int XDelta;
-    int min_run_len;
-    int final_run_len;
-    int run_len; /* aka step */
-    int errorAdj;
-
-    /*printf("(%03d,%03d)->(%03d,%03d)\r", x1, y1, x2, y2);*/
-
-    /* We'll draw top to bottom, to reduce the number of cases we have to
-     * handle, and to make lines between the same endpoints always draw the
-     * same pixels. */
-    /* TODO remove this, as we'll like patterned lines to work well without
-     * having to reverse the pattern. */
-    if (y1 > y2)
-    {
-        int tmp;
-
-        /* Swap y1 and y2 */
-        tmp = y1;
-        y1 = y2;
-        y2 = tmp;
-        /* Swap x1 and x2 */
-        tmp = x1;
-        x1 = x2;
-        x2 = tmp;
-    }
-    /* Now the line is top to bottom */
-
-    /* Figure out how far we're going vertically (guaranteed to be positive) */
-    YDelta = y2 - y1;
-
-    /* Figure out whether we're going left or right, and how far we're going
-     * horizontally. In the process, special-case vertical lines, for speed and
-     * to avoid nasty boundary conditions and division by 0 */
-    XDelta = x2 - x1;
-    /* Do we have a vertical line? */
-    if (XDelta == 0)
-    {
-        /* Yes, so use vertical line drawing */
-        drawVertLine(x1, y1, YDelta+1);
-        return;
+    int ret;
+
+    if (mode->width <= 0 || mode->height <= 0 || mode->format < 0 ||
+        mode->format >= NUM_PIXEL_FORMATS)
+    {
+        return -1;
     }
-    else if (XDelta < 0)
+
+    if (mode->flags & GRAPHICS_NO_PRESENT)
     {
-        /* Right to left */
-        XAdvance = -1;
-        XDelta = -XDelta; /* |XDelta| -- Make XDelta positive */
+        SetPresentPolicy(PRESENT_NEVER, 1);
     }
-    else
+    else if (mode->flags & GRAPHICS_NO_VSYNC)
     {
-        /* Left to right */
-        XAdvance = 1;
+        SetPresentPolicy(PRESENT_NO_VSYNC, 1);
     }
 
-    /* Special-case horizontal lines */
-    if (YDelta == 0)
+    currentPattern = blackPattern;
+
+    ret = SDL_Init(SDL_INIT_VIDEO);
+    if (ret < 0)
     {
-        if (XAdvance < 0)
-        {
-            /* Right-to-left */
-            drawHorizLine(x2, y1, XDelta+1);
-            return;
-        }
-        else
-        {
-            /* Left-to-right */
-            drawHorizLine(x1, y1, XDelta+1);
-            return;
-        }
+        panic("SDL Error: %s\n", SDL_GetError());
     }
-    /* Special-case diagonal lines */
-    else if (YDelta == XDelta)
+
+    SDL_SetHintWithPriority(SDL_HINT_RENDER_VSYNC, vsyncHint(),
+                            SDL_HINT_OVERRIDE);
+
+    /* Don't disable the compositor. */
+    SDL_SetHint(SDL_HINT_VIDEO_X11_NET_WM_BYPASS_COMPOSITOR, "0");
+
+    window = SDL_CreateWindow(mode->title ? mode->title : "Patater GUI Kit",
+                              SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
+                              mode->width, mode->height, windowFlags(mode));
+    if (window == NULL)
     {
-        /*printf("-- (%d,%d) -> (%d,%d)\n", x1, y1, x2, y2);*/
-        drawDiagLine(x1, y1, x2, XDelta+1);
-        return;
+        panic("SDL Error: %s\n", SDL_GetError());
+    }
+
+    surface = createSurface(mode);
+    pixels = surface->pixels;
+    pitch = surface->pitch;
+    rasterInit(pixels, pitch, mode->format, surface->w, surface->h);
+
+    if (mode->flags & GRAPHICS_ASYNC_PRESENT)
+    {
+        spare = createSurface(mode);
+        startPresenter();
     }
+    else
+    {
+        createRenderer();
+    }
+    initDamage();
 
-    /* Determine whether the line is X or Y major, and handle accordingly. */
-    if (XDelta > YDelta)
+    /* Update the screen with the new surface. */
+    ret = SDL_FillRect(surface, NULL, surfaceColor(COLOR_WHITE));
+    if (ret < 0)
     {
-        /* X-major */
-        /* More horizontal than vertical */
+        panic("SDL Error: %s\n", SDL_GetError());
+    }
 
-        min_run_len = XDelta / YDelta;
-        errorAdj = XDelta % YDelta;
-        AdjUp = errorAdj + errorAdj;
-        AdjDown = YDelta + YDelta;
+    ShowGraphics();
 
-        /* Initial error term; reflects an initial step of 0.5 along the Y
-         * axis */
-        errorAdj -= AdjDown;
+    return 0;
+}
 
-        /* The initial and last runs are partial, because Y advances only 0.5
-         * for these runs, rather than 1. Divide one full run, plus the initial
-         * pixel, between the initial and last runs. */
-        run_len = min_run_len / 2 + 1;
-        final_run_len = run_len;
+static int init(const char *title, int format)
+{
+    struct GraphicsMode mode;
 
-        /* If there is an odd number of pixels per run, we have one pixel that
-         * can't be allocated to either the initial or last partial run, so
-         * we'll add 0.5 to the error term so this pixel will be handled by the
-         * normal full-run loop. */
-        /* Is the run length odd? */
-        if (min_run_len & 1)
-        {
-            /* Odd length, add YDelta to error term (add 0.5 of a pixel to the
-             * error term) */
-            errorAdj += YDelta;
-        }
-        else
-        {
-            /* The basic run length is even */
-            /* If there's no fractional advance, we have one pixel that could
-             * go to either the initial or last partial run, which we'll
-             * arbitrarily allocate to the last run.*/
-            if (AdjUp == 0)
-            {
-                --run_len;
-            }
-        }
+    mode.width = SCREEN_WIDTH;
+    mode.height = SCREEN_HEIGHT;
+    mode.format = format;
+    mode.title = title;
+    mode.flags = 0;
 
-        /* X-Major adjustments done now */
+    return InitGraphicsEx(&mode);
+}
 
-        /* Draw the first partial run of pixels. */
-        /* XXX TODO extract out the x2 x1 choice to the outside of the loop. */
-        /* Option: make an x variable we set when we choose XAdvance, and then
-         * always use XAdvance as "1" when doing x-major
-         * Another choice is to have a horizontal line drawing function that
-         * takes Xadvance as a param, to pick to go left or right */
-        if (XAdvance < 0)
-        {
-            /* Right to left */
-            drawHorizLine(x1-run_len+1, y1++, run_len);
-            x1 -= run_len;
-        }
-        else
-        {
-            /* Left to right */
-            drawHorizLine(x1, y1++, run_len);
-            x1 += run_len;
-        }
+int InitGraphicsBGR555(const char *name)
+{
+    return init(name, PIXEL_FORMAT_BGR555);
+}
 
-        /* Draw all full runs */
-        /* Are there more than 2 scans? so there are some full runs? */
-        if (YDelta < 2)
-        {
-            /* No, no full runs */
-            goto xmajor_final;
-        }
+int InitGraphics(void)
+{
+    return init(NULL, PIXEL_FORMAT_INDEX8);
+}
 
-        while (YDelta-- > 1) {
-            run_len = min_run_len; /* Run is at least this long */
-            /* Advance the error term and add an extra pixel if the error term
-             * so indicates. */
-            errorAdj += AdjUp;
-            if (errorAdj > 0)
-            {
-                /* One extra pixel in run */
-                ++run_len;
-                /* Reset the error term */
-                errorAdj -= AdjDown;
-            }
-            if (XAdvance < 0)
-            {
-                /* Right to left */
-                drawHorizLine(x1-run_len+1, y1++, run_len);
-                x1 -= run_len;
-            }
-            else
-            {
-                /* Left to right */
-                drawHorizLine(x1, y1++, run_len);
-                x1 += run_len;
-            }
-        }
-xmajor_final:
-        if (XAdvance < 0)
-        {
-            /* Right to left */
-            drawHorizLine(x1-final_run_len+1, y1, final_run_len);
-        }
-        else
-        {
-            /* Left to right */
-            drawHorizLine(x1, y1, final_run_len);
-        }
-        return;
+int GetScreenWidth(void)
+{
+    return surface->w;
+}
+
+int GetScreenHeight(void)
+{
+    return surface->h;
+}
+
+void FreeGraphics(void)
+{
+    stopWorkers();
+    atlasFlush();
+    polygonFree();
+    freeScratch();
+    if (presenter)
+    {
+        stopPresenter();
     }
     else
     {
-        /* Y-major */
-        /* More vertical than horizontal */
-        min_run_len = YDelta / XDelta;
-        errorAdj = YDelta % XDelta;
-        AdjUp = errorAdj + errorAdj;
-        AdjDown = XDelta + XDelta;
-
-        /* Initial error term; reflects an initial step of 0.5 along the X
-         * axis */
-        errorAdj -= AdjDown;
-
-        /* The initial and last runs are partial, because X advances only 0.5
-         * for these runs, rather than 1. Divide one full run, plus the initial
-         * pixel, between the initial and last runs. */
-        run_len = min_run_len / 2 + 1;
-        final_run_len = run_len;
-
-        /* If there is an odd number of pixels per run, we have one pixel that
-         * can't be allocated to either the initial or last partial run, so
-         * we'll add 0.5 to the error term so this pixel will be handled by the
-         * normal full-run loop. */
-        /* Is the run length odd? */
-        if (min_run_len & 1)
-        {
-            /* Odd length, add XDelta to error term (add 0.5 of a pixel to the
-             * error term) */
-            errorAdj += XDelta;
-        }
-        else
-        {
-            /* The basic run length is even */
-            /* If there's no fractional advance, we have one pixel that could
-             * go to either the initial or last partial run, which we'll
-             * arbitrarily allocate to the last run.*/
-            if (AdjUp == 0)
-            {
-                --run_len;
-            }
-        }
+        SDL_DestroyTexture(texture);
+        SDL_DestroyRenderer(renderer);
+    }
+    SDL_FreeSurface(surface);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+}
+
+void ShowGraphics(void)
+{
+    const struct Rect *damage;
+    size_t num;
+
+    /* Seems needed on mac for some reason, otherwise window doesn't show up...
+     * */
+    SDL_Event event;
+    SDL_PollEvent(&event);
+
+    if (!ShouldPresent())
+    {
+        /* Keep collecting damage until we do present. */
+        return;
+    }
+
+    if (paletteChanged)
+    {
+        /* The texture holds pixels as they looked in the old palette, so
+         * every one needs sending again. */
+        AddDamageAll();
+    }
+
+    if (presenter)
+    {
+        flip();
+        return;
+    }
 
-        /* Y-Major adjustments done now */
+    if (paletteChanged)
+    {
+        updateTexturePalette();
+        paletteChanged = 0;
+    }
 
-        /* Draw the first partial run of pixels. */
-        /*printf("x1,y1,len: (%d,%d,%d)\r", x1, y1, run_len);*/
-        drawVertLine(x1, y1, run_len);
-        y1 += run_len;
-        x1 += XAdvance;
+    damage = GetDamage(&num);
+    present(surface, damage, num);
+    ClearDamage();
+}
 
-        /* Draw all full runs */
-        /* Are there more than 2 scans? so there are some full runs? */
-        if (XDelta < 2)
-        {
-            /* No, no full runs */
-            goto ymajor_final;
-        }
+void *GetFrameBuffer(int *pitchOut, int *formatOut)
+{
+    *pitchOut = pitch;
+    *formatOut = screenRaster.format;
 
-        while (XDelta-- > 1) {
-            run_len = min_run_len; /* Run is at least this long */
-            /* Advance the error term and add an extra pixel if the error term
-             * so indicates. */
-            errorAdj += AdjUp;
-            if (errorAdj > 0)
-            {
-                /* One extra pixel in run */
-                ++run_len;
-                /* Reset the error term */
-                errorAdj -= AdjDown;
-            }
-            /*printf("x1,y1,len: (%d,%d,%d)\r", x1, y1, run_len);*/
-            drawVertLine(x1, y1, run_len);
-            y1 += run_len;
-            x1 += XAdvance;
-        }
-ymajor_final:
-        /*printf("x1,y1,len: (%d,%d,%d)\r", x1, y1, run_len);*/
-        drawVertLine(x1, y1, final_run_len);
-        return;
-    }
+    return pixels;
 }
 
-static void circlePoints(int x0, int y0, int x, int y)
+static int checkPalette(int first, int count)
 {
-    drawPixel(x0 + x, y0 + y);
-    drawPixel(x0 + y, y0 + x);
-    drawPixel(x0 + y, y0 - x);
-    drawPixel(x0 + x, y0 - y);
-    drawPixel(x0 - x, y0 - y);
-    drawPixel(x0 - y, y0 - x);
-    drawPixel(x0 - y, y0 + x);
-    drawPixel(x0 - x, y0 + y);
+    if (!isIndexed() || first < 0 || count < 0 ||
+        first + count > surface->format->palette->ncolors)
+    {
+        return -1;
+    }
+
+    return 0;
 }
 
-void DrawCircle(int x0, int y0, int radius)
+int SetPaletteEntries(int first, int count, const struct RGB *colors)
 {
-    int x;
-    int y;
-    int d;
-    int deltaE;
-    int deltaNE;
+    SDL_Color c[PALETTE_SIZE];
+    int i;
+    int w;
+    int h;
 
-    /* Speed this up by accumulating horizontal, diagonal, and vertical line
-     * segments. Draw each line segment reflected around in each octant. */
+    if (checkPalette(first, count))
+    {
+        return -1;
+    }
 
-    x = 0;
-    y = radius;
-    d = 1 - radius;
-    deltaE = 3;
-    deltaNE = -2 * radius + 5;
-    circlePoints(x0, y0, x, y);
+    for (i = 0; i < count; ++i)
+    {
+        c[i].r = colors[i].r;
+        c[i].g = colors[i].g;
+        c[i].b = colors[i].b;
+        c[i].a = 0xFF;
+    }
 
-    while (y > x)
+    /* Keep every indexed surface on the same palette, so blits between them
+     * don't have to map colors. */
+    SDL_SetPaletteColors(surface->format->palette, c, first, count);
+    if (spare)
     {
-        if (d < 0)
-        {
-            /* East */
-            d += deltaE;
-            deltaE += 2;
-            deltaNE += 2;
-        }
-        else
+        SDL_SetPaletteColors(spare->format->palette, c, first, count);
+    }
+    for (h = 0; h < NUM_SCRATCH_BUCKETS; ++h)
+    {
+        for (w = 0; w < NUM_SCRATCH_BUCKETS; ++w)
         {
-            /* Northeast */
-            d += deltaNE;
-            deltaE += 2;
-            deltaNE += 4;
-            --y;
+            if (scratch[h][w])
+            {
+                SDL_SetPaletteColors(scratch[h][w]->format->palette, c, first,
+                                     count);
+            }
         }
-        ++x;
-        circlePoints(x0, y0, x, y);
     }
-}
 
-static void fillCirclePoints(int x0, int y0, int x, int y)
-{
-    /* NW to NE */
-    drawHorizLine(x0 - x, y0 - y, x + x); /* Top */
-    drawHorizLine(x0 - y, y0 - x, y + y); /* Upper middle */
+    paletteChanged = 1;
+    rasterPaletteChanged();
 
-    /* SW to SE */
-    drawHorizLine(x0 - y, y0 + x, y + y); /* Lower middle */
-    drawHorizLine(x0 - x, y0 + y, x + x); /* Bottom */
+    return 0;
 }
 
-void FillCircle(int x0, int y0, int radius)
+int GetPaletteEntries(int first, int count, struct RGB *colors)
 {
-    int x;
-    int y;
-    int d;
-    int deltaE;
-    int deltaNE;
-
-    /* Speed this up by accumulating horizontal, diagonal, and vertical line
-     * segments. Draw each line segment reflected around in each octant. */
-    /* Speed this up by not drawing the same pixels multiple times. (Currently,
-     * any horizontal lines at the top of the circle are drawn over many times,
-     * as a specific example.) */
-
-    x = 0;
-    y = radius;
-    d = 1 - radius;
-    deltaE = 3;
-    deltaNE = -2 * radius + 5;
-    fillCirclePoints(x0, y0, x, y);
-
-    while (y > x)
-    {
-        if (d < 0)
-        {
-            /* East */
-            d += deltaE;
-            deltaE += 2;
-            deltaNE += 2;
-        }
-        else
-        {
-            /* Northeast */
-            d += deltaNE;
-            deltaE += 2;
-            deltaNE += 4;
-            --y;
-        }
-        ++x;
-        fillCirclePoints(x0, y0, x, y);
+    const SDL_Color *c;
+    int i;
+
+    if (checkPalette(first, count))
+    {
+        return -1;
+    }
+
+    c = &surface->format->palette->colors[first];
+    for (i = 0; i < count; ++i)
+    {
+        colors[i].r = c[i].r;
+        colors[i].g = c[i].g;
+        colors[i].b = c[i].b;
     }
+
+    return 0;
 }
 
-static void roundPoints(int x0, int y0, int radius, int x, int y, int width, int height)
+int SaveScreenShot(const char *path)
 {
-    /* SE */
-    drawPixel(x0 + x + width - radius - 1, y0 + y + height - radius - 1);
-    drawPixel(x0 + y + width - radius - 1, y0 + x + height - radius - 1);
-
-    /* NE */
-    drawPixel(x0 + y + width - radius - 1, y0 - x + radius);
-    drawPixel(x0 + x + width - radius - 1, y0 - y + radius);
+    int ret;
 
-    /* NW */
-    drawPixel(x0 - x + radius, y0 - y + radius);
-    drawPixel(x0 - y + radius, y0 - x + radius);
+    ret = SDL_SaveBMP(surface, path);
+    if (ret)
+    {
+        printf("SDL_SaveBMP failed: %s\n", SDL_GetError());
+    }
 
-    /* SW */
-    drawPixel(x0 - y + radius, y0 + x + height - radius - 1);
-    drawPixel(x0 - x + radius, y0 + y + height - radius - 1);
+    return ret;
 }
 
-void DrawRoundRect(int x0, int y0, int radius, int width, int height)
+void SetColor(int color)
 {
-    int x;
-    int y;
-    int d;
-    int deltaE;
-    int deltaNE;
+    notePenColor(color);
+    setColor = color;
+    penColor = surfaceColor(color);
+    penRGB = mac_pal[color & 0xF];
+    screenRaster.color = penColor;
+}
 
-    /* TODO Fix crash when radius is more curvy than a circle is allowed to be
-     * */
+void rasterSetPenRGB(u8 r, u8 g, u8 b, u32 color)
+{
+    notePenRGB(r, g, b);
+    penColor = color;
+    penRGB.r = r;
+    penRGB.g = g;
+    penRGB.b = b;
+    penRGB.a = 0xFF;
+    screenRaster.color = penColor;
+}
 
-    /* Draw rectangle portion, without corners */
-    drawVertLine(x0, y0 + radius + 1, height - 2 - 2 * radius); /* Left */
-    drawHorizLine(x0 + 1 + radius, y0, width - 2 - 2 * radius); /* Top */
-    drawVertLine(x0 + width - 1, y0 + radius + 1,
-                 height - 2 - 2 * radius); /* Right */
-    drawHorizLine(x0 + 1 + radius, y0 + height - 1,
-                  width - 2 - 2 * radius); /* Bottom */
-
-    /* Same as DrawCircle(), but with roundPoints() */
-    x = 0;
-    y = radius;
-    d = 1 - radius;
-    deltaE = 3;
-    deltaNE = -2 * radius + 5;
-    roundPoints(x0, y0, radius, x, y, width, height);
-
-    while (y > x)
-    {
-        if (d < 0)
-        {
-            /* East */
-            d += deltaE;
-            deltaE += 2;
-            deltaNE += 2;
-        }
-        else
-        {
-            /* Northeast */
-            d += deltaNE;
-            deltaE += 2;
-            deltaNE += 4;
-            --y;
-        }
-        ++x;
-        roundPoints(x0, y0, radius, x, y, width, height);
-    }
+void SetColorRGB(unsigned char r, unsigned char g, unsigned char b)
+{
+    rasterSetPenRGB(r, g, b, surfaceRGB(r, g, b));
 }
 
-static void fillRoundPoints(int x0, int y0, int radius, int x, int y, int width, int height)
+void rasterClipChanged(void)
 {
-    /* NW to NE */
-    drawHorizLine(x0 - x + radius, y0 - y + radius,
-                  (x0 + x + width - radius) - (x0 - x + radius)); /* Top */
-    drawHorizLine(x0 - y + radius, y0 - x + radius,
-                  (x0 + y + width - radius) -
-                      (x0 - y + radius)); /* Upper middle */
-
-    /* SW to SE */
-    drawHorizLine(x0 - y + radius, y0 + x + height - radius - 1,
-                  (x0 + y + width - radius) -
-                      (x0 - y + radius)); /* Lower middle */
-    drawHorizLine(x0 - x + radius, y0 + y + height - radius - 1,
-                  (x0 + x + width - radius) - (x0 - x + radius)); /* Bottom */
+    const struct Rect *clip = &screenRaster.clip;
+    SDL_Rect rect;
+
+    /* SDL's blits and fills clip to the surface's clip rect. */
+    rect.x = clip->left;
+    rect.y = clip->top;
+    rect.w = clip->right - clip->left + 1;
+    rect.h = clip->bottom - clip->top + 1;
+    if (rect.w < 0 || rect.h < 0)
+    {
+        rect.w = 0;
+        rect.h = 0;
+    }
+    SDL_SetClipRect(surface, &rect);
 }
 
-void FillRoundRect(int x0, int y0, int radius, int width, int height)
+void FillScreen(void)
 {
-    int x;
-    int y;
-    int d;
-    int deltaE;
-    int deltaNE;
-    struct Rect rect;
-
-    /* Use FillRect() to set mode for us, and avoid extra register setting */
-    rect.left = x0;
-    rect.top = y0 + radius + 1;
-    rect.right = rect.left + width - 1;
-    rect.bottom = rect.top + height - radius - radius - 2 - 1;
-    FillRect(&rect);
-
-    x = 0;
-    y = radius;
-    d = 1 - radius;
-    deltaE = 3;
-    deltaNE = -2 * radius + 5;
-    fillRoundPoints(x0, y0, radius, x, y, width, height);
-
-    while (y > x)
-    {
-        if (d < 0)
-        {
-            /* East */
-            d += deltaE;
-            deltaE += 2;
-            deltaNE += 2;
-        }
-        else
-        {
-            /* Northeast */
-            d += deltaNE;
-            deltaE += 2;
-            deltaNE += 4;
-            --y;
-        }
-        ++x;
-        fillRoundPoints(x0, y0, radius, x, y, width, height);
+    if (recording)
+    {
+        recordInts(CMD_FILL_SCREEN, 0, 0, 0, 0, 0);
+        return;
     }
+
+    /* A NULL rect fills the surface's clip rect. */
+    SDL_FillRect(surface, NULL, penColor);
+    AddDamage(&screenRaster.clip);
 }
 
-int BlitWithMask(const unsigned char *img, const unsigned char *mask,
-                 const struct Rect *dst, const struct Rect *src, int span)
+/* Colorize the part of a masked 1bpp bitmap that src picks out, and blit it to
+ * dst. Only the part of dst within the clip rect is colorized. */
+static void blitMasked(const unsigned char *img, const unsigned char *mask,
+                       const struct Rect *dst, const struct Rect *src,
+                       int spanBytes, Uint8 on, Uint8 off)
 {
     SDL_Surface *masked;
-    int x;
+    struct Rect d;
+    struct Rect s;
     int y;
-    int spanBytes;
+    int width;
+    int height;
+    int rowBytes;
+    int colInByte;
     SDL_Rect srcRect;
     SDL_Rect dstRect;
     Uint8 *bitmapPixels;
 
-    spanBytes = (span + 7) / 8; /* Convert to bytes */
-
+    d = *dst;
+    s = *src;
+    ClipRectAdjust(&d, &s, &screenRaster.clip);
+    width = d.right - d.left + 1;
+    height = d.bottom - d.top + 1;
 
-    srcRect.x = src->left;
-    srcRect.y = src->top;
-    srcRect.w = src->right - src->left + 1;
-    srcRect.h = src->bottom - src->top + 1;
+    /* Expand whole bytes, starting from the one the src rect starts in, and
+     * then skip the pixels before the src rect when blitting. */
+    colInByte = s.left % 8;
+    rowBytes = (colInByte + width + 7) / 8;
 
-    dstRect.x = dst->left;
-    dstRect.y = dst->top;
-    dstRect.w = dst->right - dst->left + 1;
-    dstRect.h = dst->bottom - dst->top + 1;
+    srcRect.x = colInByte;
+    srcRect.y = 0;
+    srcRect.w = width;
+    srcRect.h = height;
 
-    if (srcRect.w != dstRect.w)
-    {
-        panic("Blit width mismatch. Not supported.");
-    }
-    if (srcRect.h != dstRect.h)
-    {
-        panic("Blit height mismatch. Not supported.");
-    }
+    dstRect.x = d.left;
+    dstRect.y = d.top;
+    dstRect.w = width;
+    dstRect.h = height;
 
-    masked = SDL_CreateRGBSurfaceWithFormat(0, span, dstRect.h, 8,
-                                            SDL_PIXELFORMAT_INDEX8);
-    if (!masked)
-    {
-        panic("SDL Error: %s\n", SDL_GetError());
-    }
-    SDL_SetPaletteColors(masked->format->palette, mac_pal, 0,
-                         ARRAY_SIZE(mac_pal));
-    SDL_SetColorKey(masked, SDL_TRUE, COLOR_TRANSPARENT);
+    masked = getScratch(rowBytes * 8, height);
 
-    /* Blit */
+    /* Like a stencil. Wherever the mask is set goes through. */
     SDL_LockSurface(masked);
     bitmapPixels = masked->pixels;
-    for (y = 0; y < dstRect.h; ++y)
+    for (y = 0; y < height; ++y)
     {
-        for (x = 0; x < spanBytes; ++x)
-        {
-            Uint8 maskByte;
-            Uint8 imgByte;
-            int i;
+        size_t offset = (size_t)(s.top + y) * spanBytes + s.left / 8;
 
-            i = y * masked->pitch + x * 8;
-
-            maskByte = mask[y * spanBytes + x];
-            imgByte = img[y * spanBytes + x];
-
-            /* Mode 0 */
-            /* Copies the white as color. black as transparent. */
-            bitmapPixels[i] = imgByte & maskByte ? COLOR_TRANSPARENT : penColor;
-            /* Mode 3 */
-            /* Like a stencil. Whereever is black is goes through to the color
-             * */
-            bitmapPixels[i] = imgByte & maskByte ? penColor : COLOR_TRANSPARENT;
-        }
+        expandBitsMasked(&bitmapPixels[y * masked->pitch], &img[offset],
+                         &mask[offset], rowBytes, on, off, COLOR_TRANSPARENT);
     }
     SDL_UnlockSurface(masked);
 
     SDL_BlitSurface(masked, &srcRect, surface, &dstRect);
-
-    return 0;
+    putScratch(masked);
 }
 
-static unsigned char get_op(int op, const unsigned char src,
-                            const unsigned char *pat, size_t row)
+int BlitWithMask(const unsigned char *img, const unsigned char *mask,
+                 const struct Rect *dst, const struct Rect *src, int span)
 {
-    unsigned char p = pat[row % 8];
-    unsigned char byte = src & 0xFF;
-    switch (op)
+    if (recording)
     {
-    case OP_SRC_INV:
-        byte = ~byte;
-        break;
-    case OP_SRC_INV_PAT_XOR:
-        byte = ~byte ^ p;
-        break;
-    case OP_PAT_AND:
-        byte &= p;
-        break;
-    case OP_SRC_INV_PAT_AND:
-        byte = ~byte & p;
-        break;
-    case OP_PAT_NOT:
-        byte &= ~p;
-        break;
-    case OP_PAT_OR:
-        byte |= p;
-        break;
-    case OP_SRC_INV_PAT_OR:
-        byte = ~byte | p;
-        break;
-    case OP_PAT_XOR:
-        byte ^= p;
-        break;
-    case OP_NONE:
-    default:
-        break;
+        recordBlit(CMD_BLIT_WITH_MASK, img, mask, OP_NONE, dst, src, span);
+        return 0;
+    }
+
+    if (src->right - src->left != dst->right - dst->left)
+    {
+        panic("Blit width mismatch. Not supported.");
+    }
+    if (src->bottom - src->top != dst->bottom - dst->top)
+    {
+        panic("Blit height mismatch. Not supported.");
     }
 
-    return byte;
+    if (rasterRejects(dst))
+    {
+        return 0;
+    }
+
+    AddDamage(dst);
+
+    /* Wherever both are set goes through to the color. */
+    blitMasked(img, mask, dst, src, (span + 7) / 8, scratchPen(),
+               COLOR_TRANSPARENT);
+
+    return 0;
 }
 
 int Blit(const unsigned char *img, const struct Rect *dst0,
@@ -1100,111 +1022,118 @@ int Blit(const unsigned char *img, const struct Rect *dst0,
     return BlitOp(img, OP_NONE, dst0, src0, span);
 }
 
+/* Expand a row of 1bpp source, applying op a byte at a time on the way. */
+static void expandOpRow(Uint8 *dst, const Uint8 *src, int bytes, int op,
+                        int row, Uint8 pen)
+{
+    int x;
+    int n;
+
+    if (op == OP_NONE)
+    {
+        expandBits(dst, src, bytes, pen, COLOR_TRANSPARENT);
+        return;
+    }
+
+    while (bytes > 0)
+    {
+        n = bytes < (int)sizeof(opRow) ? bytes : (int)sizeof(opRow);
+        for (x = 0; x < n; ++x)
+        {
+            opRow[x] = rasterOp(op, src[x], currentPattern, row);
+        }
+        expandBits(dst, opRow, n, pen, COLOR_TRANSPARENT);
+
+        dst += n * 8;
+        src += n;
+        bytes -= n;
+    }
+}
+
 int BlitOp(const unsigned char *img, int op, const struct Rect *dst0,
            const struct Rect *src0, int span)
 {
     SDL_Surface *colored;
-    int x;
+    struct Rect d;
+    struct Rect s;
     int y;
-    int srcWidth;
-    int srcHeight;
-    int dstWidth;
-    int dstHeight;
+    int width;
+    int height;
     int spanBytes;
+    int rowBytes;
     SDL_Rect srcRect;
     SDL_Rect dstRect;
     Uint8 *bitmapPixels;
+    Uint8 pen;
     int colInByte;
-    size_t row;
+
+    if (recording)
+    {
+        recordBlit(CMD_BLIT_OP, img, NULL, op, dst0, src0, span);
+        return 0;
+    }
 
     spanBytes = (span + 7) / 8; /* Convert to bytes */
 
-    srcWidth = src0->right - src0->left + 1;
-    srcHeight = src0->bottom - src0->top + 1;
-    dstWidth = dst0->right - dst0->left + 1;
-    dstHeight = dst0->bottom - dst0->top + 1;
-    if (srcWidth != dstWidth)
+    if (src0->right - src0->left != dst0->right - dst0->left)
     {
         panic("Blit width mismatch. Not supported.");
     }
-    if (srcHeight != dstHeight)
+    if (src0->bottom - src0->top != dst0->bottom - dst0->top)
     {
         panic("Blit height mismatch. Not supported.");
     }
 
-    srcRect.x = 0;
+    if (rasterRejects(dst0))
+    {
+        return 0;
+    }
+
+    AddDamage(dst0);
+
+    /* Only colorize the part of the src rect that lands within the clip
+     * rect. */
+    d = *dst0;
+    s = *src0;
+    ClipRectAdjust(&d, &s, &screenRaster.clip);
+    width = d.right - d.left + 1;
+    height = d.bottom - d.top + 1;
+
+    /* Expand whole bytes, starting from the one the src rect starts in, and
+     * then skip the pixels before the src rect when blitting. */
+    colInByte = s.left % 8; /* keep only the column in-byte address */
+    rowBytes = (colInByte + width + 7) / 8;
+
+    srcRect.x = colInByte;
     srcRect.y = 0;
-    srcRect.w = srcWidth;
-    srcRect.h = srcHeight;
+    srcRect.w = width;
+    srcRect.h = height;
 
-    dstRect.x = dst0->left;
-    dstRect.y = dst0->top;
-    dstRect.w = dstWidth;
-    dstRect.h = dstHeight;
+    dstRect.x = d.left;
+    dstRect.y = d.top;
+    dstRect.w = width;
+    dstRect.h = height;
 
-    colored = SDL_CreateRGBSurfaceWithFormat(0, span, dstHeight, 8,
-                                             SDL_PIXELFORMAT_INDEX8);
-    if (!colored)
-    {
-        panic("SDL Error: %s\n", SDL_GetError());
-    }
-    SDL_SetPaletteColors(colored->format->palette, mac_pal, 0,
-                         ARRAY_SIZE(mac_pal));
-    SDL_SetColorKey(colored, SDL_TRUE, COLOR_TRANSPARENT);
+    colored = getScratch(rowBytes * 8, height);
+    pen = scratchPen();
 
     /* Blit */
     /* Make a new texture from the 1-bit bitmap, colorizing it along the way.
-     * */
+     * Like a stencil, wherever is set goes through to the color. Pattern rows
+     * count from the top of the whole src rect, clipped or not. */
     SDL_LockSurface(colored);
     bitmapPixels = colored->pixels;
-    colInByte = src0->left % 8; /* keep only the column in-byte address */
-
-    /* If x starts at 3 pixels in, we want pixel numbers 2 3 4 5 6 7 0 1 in
-     * that order, where 0 and 1 are from the next byte. */
-    row = 0;
-    for (y = 0; y < srcHeight; ++y)
+    for (y = 0; y < height; ++y)
     {
-        int curColInByte;
-        const Uint8 *imgByte;
-        Uint8 byte;
-
-        curColInByte = colInByte;
-        imgByte = &img[(y + src0->top) * spanBytes + src0->left / 8];
-
-        for (x = 0; x < srcWidth; ++x)
-        {
-            int i;
-            int mask;
-            int shift;
-            unsigned char src;
-
-            i = y * colored->pitch + x;
-            src = *imgByte;
-            byte = get_op(op, src, currentPattern, row);
-            shift = 7 - curColInByte;
-            mask = 1 << shift;
-
-            /* Mode 0 */
-            /* Copies the white as color. black as transparent. */
-            bitmapPixels[i] = byte & mask ? COLOR_TRANSPARENT : penColor;
-            /* Mode 3 */
-            /* Like a stencil. Whereever is black is goes through to the color
-             * */
-            bitmapPixels[i] = byte & mask ? penColor : COLOR_TRANSPARENT;
-
-            ++curColInByte;
-            if (curColInByte == 8)
-            {
-                curColInByte = 0;
-                ++imgByte;
-            }
-        }
-        ++row;
+        expandOpRow(&bitmapPixels[y * colored->pitch],
+                    &img[(size_t)(s.top + y) * spanBytes + s.left / 8],
+                    rowBytes, op, s.top - src0->top + y, pen);
     }
     SDL_UnlockSurface(colored);
 
     /* Copy from the new texture onto our main graphics surface. */
     SDL_BlitSurface(colored, &srcRect, surface, &dstRect);
+    putScratch(colored);
 
     return 0;
 }
@@ -1212,94 +1141,25 @@ int BlitOp(const unsigned char *img, int op, const struct Rect *dst0,
 int DrawBitmap(const struct Rect *dst, int span, const unsigned char *img,
                const unsigned char *mask)
 {
-    SDL_Surface *masked;
-    int x;
-    int y;
-    int width;
-    int height;
-    int spanBytes;
-    SDL_Rect srcRect;
-    SDL_Rect dstRect;
-    Uint8 *bitmapPixels;
-
-    spanBytes = (span + 7) / 8; /* Convert to bytes */
-
-    width = dst->right - dst->left + 1;
-    height = dst->bottom - dst->top + 1;
-
-    srcRect.x = 0;
-    srcRect.y = 0;
-    srcRect.w = width;
-    srcRect.h = height;
-
-    dstRect.x = dst->left;
-    dstRect.y = dst->top;
-    dstRect.w = width;
-    dstRect.h = height;
+    struct Rect src;
 
-    masked = SDL_CreateRGBSurfaceWithFormat(0, span, height, 8,
-                                            SDL_PIXELFORMAT_INDEX8);
-    if (!masked)
+    if (recording)
     {
-        panic("SDL Error: %s\n", SDL_GetError());
+        recordBlit(CMD_DRAW_BITMAP, img, mask, OP_NONE, dst, NULL, span);
+        return 0;
     }
-    SDL_SetPaletteColors(masked->format->palette, mac_pal, 0,
-                         ARRAY_SIZE(mac_pal));
-    SDL_SetColorKey(masked, SDL_TRUE, COLOR_TRANSPARENT);
 
-    /* Blit */
-    SDL_LockSurface(masked);
-    bitmapPixels = masked->pixels;
-    for (y = 0; y < height; ++y)
+    if (rasterRejects(dst))
     {
-        for (x = 0; x < spanBytes; ++x)
-        {
-            Uint8 maskByte;
-            Uint8 imgByte;
-            int i;
-
-            i = y * masked->pitch + x * 8;
-
-            maskByte = mask[y * spanBytes + x];
-            imgByte = img[y * spanBytes + x];
-
-            bitmapPixels[i + 0] =
-                maskByte & (0x80 >> 0)
-                    ? imgByte & (0x80 >> 0) ? COLOR_WHITE : penColor
-                    : COLOR_TRANSPARENT;
-            bitmapPixels[i + 1] =
-                maskByte & (0x80 >> 1)
-                    ? imgByte & (0x80 >> 1) ? COLOR_WHITE : penColor
-                    : COLOR_TRANSPARENT;
-            bitmapPixels[i + 2] =
-                maskByte & (0x80 >> 2)
-                    ? imgByte & (0x80 >> 2) ? COLOR_WHITE : penColor
-                    : COLOR_TRANSPARENT;
-            bitmapPixels[i + 3] =
-                maskByte & (0x80 >> 3)
-                    ? imgByte & (0x80 >> 3) ? COLOR_WHITE : penColor
-                    : COLOR_TRANSPARENT;
-            bitmapPixels[i + 4] =
-                maskByte & (0x80 >> 4)
-                    ? imgByte & (0x80 >> 4) ? COLOR_WHITE : penColor
-                    : COLOR_TRANSPARENT;
-            bitmapPixels[i + 5] =
-                maskByte & (0x80 >> 5)
-                    ? imgByte & (0x80 >> 5) ? COLOR_WHITE : penColor
-                    : COLOR_TRANSPARENT;
-            bitmapPixels[i + 6] =
-                maskByte & (0x80 >> 6)
-                    ? imgByte & (0x80 >> 6) ? COLOR_WHITE : penColor
-                    : COLOR_TRANSPARENT;
-            bitmapPixels[i + 7] =
-                maskByte & (0x80 >> 7)
-                    ? imgByte & (0x80 >> 7) ? COLOR_WHITE : penColor
-                    : COLOR_TRANSPARENT;
-        }
+        return 0;
     }
-    SDL_UnlockSurface(masked);
 
-    SDL_BlitSurface(masked, &srcRect, surface, &dstRect);
+    AddDamage(dst);
+
+    InitRect(&src, 0, 0, dst->right - dst->left + 1,
+             dst->bottom - dst->top + 1);
+    blitMasked(img, mask, dst, &src, (span + 7) / 8, COLOR_WHITE,
+               scratchPen());
 
     return 0;
 }
@@ -1308,60 +1168,84 @@ int DrawColorBitmap(const struct Rect *dst, int span, const unsigned char *img,
                     const unsigned char *mask)
 {
     SDL_Surface *masked;
+    struct Rect d;
+    struct Rect s;
     int x;
     int y;
     int width;
     int height;
+    int planeSize;
     int spanBytes;
+    int rowBytes;
+    int colInByte;
     SDL_Rect srcRect;
     SDL_Rect dstRect;
     Uint8 *bitmapPixels;
 
+    if (recording)
+    {
+        recordBlit(CMD_DRAW_COLOR_BITMAP, img, mask, OP_NONE, dst, NULL,
+                   span);
+        return 0;
+    }
+
+    if (rasterRejects(dst))
+    {
+        return 0;
+    }
+
+    AddDamage(dst);
+
     spanBytes = (span + 7) / 8; /* Convert to bytes */
 
-    width = dst->right - dst->left + 1;
-    height = dst->bottom - dst->top + 1;
+    /* The planes follow one another, each as tall as dst. */
+    planeSize = spanBytes * (dst->bottom - dst->top + 1);
+
+    /* Only colorize the part of the bitmap that lands within the clip
+     * rect. */
+    d = *dst;
+    InitRect(&s, 0, 0, d.right - d.left + 1, d.bottom - d.top + 1);
+    ClipRectAdjust(&d, &s, &screenRaster.clip);
+    width = d.right - d.left + 1;
+    height = d.bottom - d.top + 1;
 
-    srcRect.x = 0;
+    colInByte = s.left % 8;
+    rowBytes = (colInByte + width + 7) / 8;
+
+    srcRect.x = colInByte;
     srcRect.y = 0;
     srcRect.w = width;
     srcRect.h = height;
 
-    dstRect.x = dst->left;
-    dstRect.y = dst->top;
+    dstRect.x = d.left;
+    dstRect.y = d.top;
     dstRect.w = width;
     dstRect.h = height;
 
-    masked = SDL_CreateRGBSurfaceWithFormat(0, span, height, 8,
-                                            SDL_PIXELFORMAT_INDEX8);
-    if (!masked)
-    {
-        panic("SDL Error: %s\n", SDL_GetError());
-    }
-    SDL_SetPaletteColors(masked->format->palette, mac_pal, 0,
-                         ARRAY_SIZE(mac_pal));
-    SDL_SetColorKey(masked, SDL_TRUE, COLOR_TRANSPARENT);
+    masked = getScratch(rowBytes * 8, height);
 
     /* Color Blit */
     SDL_LockSurface(masked);
     bitmapPixels = masked->pixels;
     for (y = 0; y < height; ++y)
     {
-        for (x = 0; x < spanBytes; ++x)
+        for (x = 0; x < rowBytes; ++x)
         {
             Uint8 maskByte;
             Uint8 imgBytes[4];
             Uint8 color[16];
+            int offset;
             int i;
 
             i = y * masked->pitch + x*8;
 
-            maskByte = mask[y * spanBytes + x];
+            offset = (s.top + y) * spanBytes + s.left / 8 + x;
+            maskByte = mask[offset];
 
-            imgBytes[0] = img[0 * spanBytes * height + y * spanBytes + x];
-            imgBytes[1] = img[1 * spanBytes * height + y * spanBytes + x];
-            imgBytes[2] = img[2 * spanBytes * height + y * spanBytes + x];
-            imgBytes[3] = img[3 * spanBytes * height + y * spanBytes + x];
+            imgBytes[0] = img[0 * planeSize + offset];
+            imgBytes[1] = img[1 * planeSize + offset];
+            imgBytes[2] = img[2 * planeSize + offset];
+            imgBytes[3] = img[3 * planeSize + offset];
 
             color[0] = (((imgBytes[0] & 0x80) >> 7)) << 0 |
                        (((imgBytes[1] & 0x80) >> 7)) << 1 |
@@ -1441,6 +1325,7 @@ int DrawColorBitmap(const struct Rect *dst, int span, const unsigned char *img,
     SDL_UnlockSurface(masked);
 
     SDL_BlitSurface(masked, &srcRect, surface, &dstRect);
+    putScratch(masked);
 
     return 0;
 }
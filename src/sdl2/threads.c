@@ -0,0 +1,132 @@
+/*
+ *  threads.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "threads.h"
+
+#include "guikit/panic.h"
+#include "guikit/pmemory.h"
+#include <SDL.h>
+#include <stddef.h>
+
+struct Thread
+{
+    SDL_Thread *thread;
+    void (*fn)(void);
+};
+
+struct Mutex
+{
+    SDL_mutex *mutex;
+};
+
+struct Cond
+{
+    SDL_cond *cond;
+};
+
+int cpuCount(void)
+{
+    int n = SDL_GetCPUCount();
+
+    return n > 1 ? n : 1;
+}
+
+static int SDLCALL threadMain(void *arg)
+{
+    struct Thread *thread = arg;
+
+    thread->fn();
+
+    return 0;
+}
+
+struct Thread *startThread(void (*fn)(void))
+{
+    struct Thread *thread;
+
+    thread = pmalloc(sizeof(*thread));
+    thread->fn = fn;
+    thread->thread = SDL_CreateThread(threadMain, "guikit render", thread);
+    if (!thread->thread)
+    {
+        panic("SDL Error: %s\n", SDL_GetError());
+    }
+
+    return thread;
+}
+
+void joinThread(struct Thread *thread)
+{
+    SDL_WaitThread(thread->thread, NULL);
+    pfree(thread);
+}
+
+struct Mutex *newMutex(void)
+{
+    struct Mutex *mutex;
+
+    mutex = pmalloc(sizeof(*mutex));
+    mutex->mutex = SDL_CreateMutex();
+    if (!mutex->mutex)
+    {
+        panic("SDL Error: %s\n", SDL_GetError());
+    }
+
+    return mutex;
+}
+
+void freeMutex(struct Mutex *mutex)
+{
+    SDL_DestroyMutex(mutex->mutex);
+    pfree(mutex);
+}
+
+void lockMutex(struct Mutex *mutex)
+{
+    SDL_LockMutex(mutex->mutex);
+}
+
+void unlockMutex(struct Mutex *mutex)
+{
+    SDL_UnlockMutex(mutex->mutex);
+}
+
+struct Cond *newCond(void)
+{
+    struct Cond *cond;
+
+    cond = pmalloc(sizeof(*cond));
+    cond->cond = SDL_CreateCond();
+    if (!cond->cond)
+    {
+        panic("SDL Error: %s\n", SDL_GetError());
+    }
+
+    return cond;
+}
+
+void freeCond(struct Cond *cond)
+{
+    SDL_DestroyCond(cond->cond);
+    pfree(cond);
+}
+
+void waitCond(struct Cond *cond, struct Mutex *mutex)
+{
+    SDL_CondWait(cond->cond, mutex->mutex);
+}
+
+void signalCond(struct Cond *cond)
+{
+    SDL_CondSignal(cond->cond);
+}
+
+void broadcastCond(struct Cond *cond)
+{
+    SDL_CondBroadcast(cond->cond);
+}
@@ -0,0 +1,99 @@
+/*
+ *  seedfill.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "seedfill.h"
+
+#include "guikit/array.h"
+#include "guikit/primrect.h"
+#include <stddef.h>
+
+/* A run of pixels on row y, from left to right, already filled or seeded,
+ * with row y + dy next to the run still to look at */
+struct Seg
+{
+    int y;
+    int left;
+    int right;
+    int dy;
+};
+
+static void push(struct Seg **stack, const struct Rect *clip, int y,
+                 int left, int right, int dy)
+{
+    struct Seg s;
+
+    if (y + dy < clip->top || y + dy > clip->bottom)
+    {
+        return;
+    }
+
+    s.y = y;
+    s.left = left;
+    s.right = right;
+    s.dy = dy;
+    array_push(*stack, s);
+}
+
+/* Heckbert's seed fill, from Graphics Gems: each run found is filled whole,
+ * then the rows above and below it are looked at for runs touching it. Only
+ * the parts of the row it came from that stick out past its parent need
+ * looking at again, which keeps pixels from being read more than a few
+ * times. */
+void seedFill(int x, int y, const struct Rect *clip, fill_inside_fn inside,
+              fill_span_fn span, void *ctx)
+{
+    struct Seg *stack = NULL;
+    struct Seg s;
+    int left;
+
+    push(&stack, clip, y, x, x, 1);
+    push(&stack, clip, y + 1, x, x, -1);
+    while (array_len(stack))
+    {
+        s = array_pop(stack);
+        y = s.y + s.dy;
+
+        x = s.left;
+        while (x <= s.right)
+        {
+            if (!inside(x, y, ctx))
+            {
+                ++x;
+                continue;
+            }
+
+            /* Only the first run can reach left of its parent. */
+            left = x;
+            if (x == s.left)
+            {
+                while (left > clip->left && inside(left - 1, y, ctx))
+                {
+                    --left;
+                }
+            }
+            ++x;
+            while (x <= clip->right && inside(x, y, ctx))
+            {
+                ++x;
+            }
+            span(left, y, x - left, ctx);
+
+            push(&stack, clip, y, left, x - 1, s.dy);
+            if (left < s.left)
+            {
+                push(&stack, clip, y, left, s.left - 1, -s.dy);
+            }
+            if (x > s.right + 1)
+            {
+                push(&stack, clip, y, s.right + 1, x - 1, -s.dy);
+            }
+        }
+    }
+
+    array_free(stack);
+}
@@ -0,0 +1,25 @@
+/*
+ *  seedfill.h
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef SEEDFILL_H
+#define SEEDFILL_H
+
+struct Rect;
+
+/* Whether pixel (x, y) is one to fill. Pixels already filled must not be. */
+typedef int (*fill_inside_fn)(int x, int y, void *ctx);
+
+/* Fill width pixels from (x, y) rightwards. */
+typedef void (*fill_span_fn)(int x, int y, int width, void *ctx);
+
+/* Fill the pixels within clip that are inside and joined to (x, y) through
+ * their edges, a run at a time. (x, y) must be within clip and inside. */
+void seedFill(int x, int y, const struct Rect *clip, fill_inside_fn inside,
+              fill_span_fn span, void *ctx);
+
+#endif
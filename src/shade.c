@@ -0,0 +1,169 @@
+/*
+ *  shade.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "guikit/shade.h"
+
+#include "raster.h"
+#include "record.h"
+#include "span.h"
+#include "workers.h"
+#include "guikit/damage.h"
+#include "guikit/graphics.h"
+#include "guikit/pmemory.h"
+#include "guikit/primrect.h"
+#include "guikit/ptypes.h"
+#include <stddef.h>
+#include <string.h>
+
+enum {
+    BANDS_PER_THREAD = 4 /* So threads that finish early can pick up more */
+};
+
+struct Shade
+{
+    struct Rect area; /* Clipped to the screen */
+    int format;
+    color_fn colorFn;
+    row_fn rowFn;
+    void *ctx;
+    const u32 *lut;
+    int bandHeight;
+    size_t rowBytes;
+    u8 *rows; /* One row for each band to shade into */
+};
+
+/* Store each pixel fn returns as bpp bytes. */
+static void shadeRow(const struct Shade *s, u8 *out, int y, int width)
+{
+    int bpp;
+    int x;
+
+    bpp = bytesPerPixel(s->format);
+    for (x = 0; x < width; ++x)
+    {
+        unsigned long p = s->colorFn(s->area.left + x, y, s->ctx);
+        u16 p16;
+        u32 p32;
+
+        switch (bpp)
+        {
+        case 1:
+            out[x] = (u8)p;
+            break;
+        case 2:
+            p16 = (u16)p;
+            memcpy(&out[x * 2], &p16, sizeof(p16));
+            break;
+        case 4:
+        default:
+            p32 = (u32)p;
+            memcpy(&out[x * 4], &p32, sizeof(p32));
+            break;
+        }
+    }
+}
+
+static void shadeBand(void *arg, int band)
+{
+    const struct Shade *s = arg;
+    u8 *row;
+    int dstBpp;
+    int width;
+    int top;
+    int bottom;
+    int y;
+
+    row = &s->rows[band * s->rowBytes];
+    dstBpp = bytesPerPixel(screenRaster.format);
+    width = s->area.right - s->area.left + 1;
+    top = s->area.top + band * s->bandHeight;
+    bottom = top + s->bandHeight - 1;
+    if (bottom > s->area.bottom)
+    {
+        bottom = s->area.bottom;
+    }
+
+    for (y = top; y <= bottom; ++y)
+    {
+        u8 *dst = &screenRaster.pixels[y * screenRaster.pitch +
+                                       s->area.left * dstBpp];
+
+        if (s->rowFn)
+        {
+            s->rowFn(s->area.left, y, width, row, s->ctx);
+        }
+        else
+        {
+            shadeRow(s, row, y, width);
+        }
+
+        rasterConvertRow(dst, row, s->format, width, s->lut);
+    }
+}
+
+static int shade(const struct Rect *area, int format, color_fn colorFn,
+                 row_fn rowFn, void *ctx)
+{
+    struct Shade s;
+    u32 table[256];
+    int height;
+    int bands;
+
+    if (format < 0 || format > PIXEL_FORMAT_HSV8)
+    {
+        return -1;
+    }
+
+    if (recording)
+    {
+        recordShade(area, format, colorFn, rowFn, ctx);
+        return 0;
+    }
+
+    AddDamage(area);
+
+    s.area = *area;
+    if (s.area.right < s.area.left || s.area.bottom < s.area.top ||
+        ClipRect(&s.area, &screenRaster.clip) == CLIP_REJECTED)
+    {
+        return 0;
+    }
+
+    s.format = format;
+    s.colorFn = colorFn;
+    s.rowFn = rowFn;
+    s.ctx = ctx;
+    s.lut = rasterLookup(format, table);
+
+    /* Split the rows into bands, a few per thread. */
+    height = s.area.bottom - s.area.top + 1;
+    s.bandHeight = (height + renderThreads * BANDS_PER_THREAD - 1) /
+                   (renderThreads * BANDS_PER_THREAD);
+    bands = (height + s.bandHeight - 1) / s.bandHeight;
+
+    s.rowBytes = (size_t)(s.area.right - s.area.left + 1) *
+                 bytesPerPixel(format);
+    s.rows = pmalloc(bands * s.rowBytes);
+
+    runWorkers(shadeBand, &s, bands, renderThreads);
+
+    pfree(s.rows);
+
+    return 0;
+}
+
+int RenderPerPixel(const struct Rect *area, int format, color_fn fn,
+                   void *ctx)
+{
+    return shade(area, format, fn, NULL, ctx);
+}
+
+int RenderPerRow(const struct Rect *area, int format, row_fn fn, void *ctx)
+{
+    return shade(area, format, NULL, fn, ctx);
+}
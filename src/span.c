@@ -0,0 +1,337 @@
+/*
+ *  span.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "span.h"
+
+#include "expand.h"
+#include "guikit/graphics.h"
+#include <string.h>
+
+/* Rotate an 8 pixel pattern so its most significant bit is for pixel x. */
+static u8 rotatePattern(u8 pattern, int x)
+{
+    int shift = x & 7;
+
+    return (u8)((pattern << shift) | (pattern >> ((8 - shift) & 7)));
+}
+
+/* Replace the bytes of dst selected by mask with those of src, a word at a
+ * time. */
+static void mergeWords(u8 *dst, const u8 *src, const u8 *mask, size_t size)
+{
+    size_t i;
+
+    for (i = 0; i < size; i += sizeof(u32))
+    {
+        u32 d;
+        u32 s;
+        u32 m;
+
+        memcpy(&d, &dst[i], sizeof(d));
+        memcpy(&s, &src[i], sizeof(s));
+        memcpy(&m, &mask[i], sizeof(m));
+        d = (d & ~m) | (s & m);
+        memcpy(&dst[i], &d, sizeof(d));
+    }
+}
+
+static void pixel8(const struct Raster *r, int x, int y)
+{
+    r->pixels[y * r->pitch + x] = (u8)r->color;
+}
+
+static void hline8(const struct Raster *r, int x, int y, int len)
+{
+    if (len > 0)
+    {
+        memset(&r->pixels[y * r->pitch + x], (u8)r->color, len);
+    }
+}
+
+static void vline8(const struct Raster *r, int x, int y, int len)
+{
+    u8 *p;
+
+    p = &r->pixels[y * r->pitch + x];
+    while (len-- > 0)
+    {
+        *p = (u8)r->color;
+        p += r->pitch;
+    }
+}
+
+static void hpattern8(const struct Raster *r, int x, int y, int len,
+                      u8 pattern)
+{
+    u8 mask[8];
+    u8 color[8];
+    u8 *p;
+    u8 bits;
+
+    bits = rotatePattern(pattern, x);
+    expandBits(mask, &bits, 1, 0xFF, 0x00);
+    memset(color, (u8)r->color, sizeof(color));
+
+    p = &r->pixels[y * r->pitch + x];
+    for (; len >= 8; len -= 8, p += 8)
+    {
+        mergeWords(p, color, mask, sizeof(mask));
+    }
+
+    /* Leftover pixels */
+    for (; len > 0; --len, ++p, bits <<= 1)
+    {
+        if (bits & 0x80)
+        {
+            *p = (u8)r->color;
+        }
+    }
+}
+
+static void pixel16(const struct Raster *r, int x, int y)
+{
+    ((u16 *)&r->pixels[y * r->pitch])[x] = (u16)r->color;
+}
+
+static void hline16(const struct Raster *r, int x, int y, int len)
+{
+    u16 *p;
+    u16 color;
+
+    p = &((u16 *)&r->pixels[y * r->pitch])[x];
+    color = (u16)r->color;
+    while (len-- > 0)
+    {
+        *p++ = color;
+    }
+}
+
+static void vline16(const struct Raster *r, int x, int y, int len)
+{
+    u8 *p;
+    u16 color;
+
+    p = &r->pixels[y * r->pitch + x * 2];
+    color = (u16)r->color;
+    while (len-- > 0)
+    {
+        *(u16 *)p = color;
+        p += r->pitch;
+    }
+}
+
+static void hpattern16(const struct Raster *r, int x, int y, int len,
+                       u8 pattern)
+{
+    u8 mask[16];
+    u16 color[8];
+    u8 *p;
+    u8 bits;
+    int i;
+
+    bits = rotatePattern(pattern, x);
+    for (i = 0; i < 8; ++i)
+    {
+        mask[i * 2] = mask[i * 2 + 1] = bits & (0x80 >> i) ? 0xFF : 0x00;
+        color[i] = (u16)r->color;
+    }
+
+    p = &r->pixels[y * r->pitch + x * 2];
+    for (; len >= 8; len -= 8, p += 16)
+    {
+        mergeWords(p, (const u8 *)color, mask, sizeof(mask));
+    }
+
+    /* Leftover pixels */
+    for (; len > 0; --len, p += 2, bits <<= 1)
+    {
+        if (bits & 0x80)
+        {
+            *(u16 *)p = (u16)r->color;
+        }
+    }
+}
+
+static void pixel32(const struct Raster *r, int x, int y)
+{
+    ((u32 *)&r->pixels[y * r->pitch])[x] = r->color;
+}
+
+static void hline32(const struct Raster *r, int x, int y, int len)
+{
+    u32 *p;
+    u32 color;
+
+    p = &((u32 *)&r->pixels[y * r->pitch])[x];
+    color = r->color;
+    while (len-- > 0)
+    {
+        *p++ = color;
+    }
+}
+
+static void vline32(const struct Raster *r, int x, int y, int len)
+{
+    u8 *p;
+    u32 color;
+
+    p = &r->pixels[y * r->pitch + x * 4];
+    color = r->color;
+    while (len-- > 0)
+    {
+        *(u32 *)p = color;
+        p += r->pitch;
+    }
+}
+
+static void hpattern32(const struct Raster *r, int x, int y, int len,
+                       u8 pattern)
+{
+    u32 *p;
+    u8 bits;
+    int i;
+
+    /* Pixels are already a word each, so there's nothing to gain from
+     * merging. */
+    bits = rotatePattern(pattern, x);
+    p = &((u32 *)&r->pixels[y * r->pitch])[x];
+    for (; len >= 8; len -= 8, p += 8)
+    {
+        for (i = 0; i < 8; ++i)
+        {
+            if (bits & (0x80 >> i))
+            {
+                p[i] = r->color;
+            }
+        }
+    }
+
+    /* Leftover pixels */
+    for (; len > 0; --len, ++p, bits <<= 1)
+    {
+        if (bits & 0x80)
+        {
+            *p = r->color;
+        }
+    }
+}
+
+static const struct SpanWriter spans8 = {
+    pixel8, hline8, vline8, hpattern8
+};
+static const struct SpanWriter spans16 = {
+    pixel16, hline16, vline16, hpattern16
+};
+static const struct SpanWriter spans32 = {
+    pixel32, hline32, vline32, hpattern32
+};
+
+const struct SpanWriter *spanWriter(int format)
+{
+    switch (format)
+    {
+    case PIXEL_FORMAT_INDEX8:
+        return &spans8;
+    case PIXEL_FORMAT_XRGB8888:
+        return &spans32;
+    case PIXEL_FORMAT_BGR555:
+    default:
+        return &spans16;
+    }
+}
+
+int bytesPerPixel(int format)
+{
+    switch (format)
+    {
+    case PIXEL_FORMAT_INDEX8:
+    case PIXEL_FORMAT_HSV8:
+        return 1;
+    case PIXEL_FORMAT_XRGB8888:
+        return 4;
+    case PIXEL_FORMAT_BGR555:
+    default:
+        return 2;
+    }
+}
+
+static void pixelClipped(const struct Raster *r, int x, int y)
+{
+    if (x < r->clip.left || x > r->clip.right ||
+        y < r->clip.top || y > r->clip.bottom)
+    {
+        return;
+    }
+
+    spanWriter(r->format)->pixel(r, x, y);
+}
+
+static void hlineClipped(const struct Raster *r, int x, int y, int len)
+{
+    if (y < r->clip.top || y > r->clip.bottom)
+    {
+        return;
+    }
+
+    if (x < r->clip.left)
+    {
+        len -= r->clip.left - x;
+        x = r->clip.left;
+    }
+    if (x + len - 1 > r->clip.right)
+    {
+        len = r->clip.right - x + 1;
+    }
+
+    spanWriter(r->format)->hline(r, x, y, len);
+}
+
+static void vlineClipped(const struct Raster *r, int x, int y, int len)
+{
+    if (x < r->clip.left || x > r->clip.right)
+    {
+        return;
+    }
+
+    if (y < r->clip.top)
+    {
+        len -= r->clip.top - y;
+        y = r->clip.top;
+    }
+    if (y + len - 1 > r->clip.bottom)
+    {
+        len = r->clip.bottom - y + 1;
+    }
+
+    spanWriter(r->format)->vline(r, x, y, len);
+}
+
+static void hpatternClipped(const struct Raster *r, int x, int y, int len,
+                            u8 pattern)
+{
+    if (y < r->clip.top || y > r->clip.bottom)
+    {
+        return;
+    }
+
+    if (x < r->clip.left)
+    {
+        len -= r->clip.left - x;
+        x = r->clip.left;
+    }
+    if (x + len - 1 > r->clip.right)
+    {
+        len = r->clip.right - x + 1;
+    }
+
+    spanWriter(r->format)->hpattern(r, x, y, len, pattern);
+}
+
+const struct SpanWriter clippedSpanWriter = {
+    pixelClipped, hlineClipped, vlineClipped, hpatternClipped
+};
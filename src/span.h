@@ -0,0 +1,53 @@
+/*
+ *  span.h
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef SPAN_H
+#define SPAN_H
+
+#include "guikit/primrect.h"
+#include "guikit/ptypes.h"
+
+struct SpanWriter;
+
+/* Everything needed to draw into a framebuffer with a solid color. */
+struct Raster
+{
+    u8 *pixels;
+    int pitch; /* In bytes */
+    int format; /* One of PIXEL_FORMAT_* */
+    u32 color; /* Already converted to the pixel format */
+    struct Rect clip;
+    const struct SpanWriter *spans;
+};
+
+/* Writes horizontal and vertical runs of pixels in the raster's color. */
+struct SpanWriter
+{
+    void (*pixel)(const struct Raster *r, int x, int y);
+    void (*hline)(const struct Raster *r, int x, int y, int len);
+    void (*vline)(const struct Raster *r, int x, int y, int len);
+
+    /* Like hline, but only pixels with a set bit in the 8 pixel pattern are
+     * written. The most significant bit of pattern lines up with x
+     * coordinates that are multiples of 8. */
+    void (*hpattern)(const struct Raster *r, int x, int y, int len,
+                     u8 pattern);
+};
+
+/* Span writers specialized for a pixel format. These write straight into the
+ * framebuffer without looking at the clip rect, so only use them for
+ * primitives known to be entirely within it. */
+const struct SpanWriter *spanWriter(int format);
+
+/* How many bytes one pixel of format takes up */
+int bytesPerPixel(int format);
+
+/* Span writers that clip each span to the clip rect first. */
+extern const struct SpanWriter clippedSpanWriter;
+
+#endif
@@ -0,0 +1,42 @@
+/*
+ *  threads.h
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef THREADS_H
+#define THREADS_H
+
+/* The little of threading the worker pool needs, as each backend has it */
+
+struct Thread;
+struct Mutex;
+struct Cond;
+
+/* Return how many CPUs there are to run threads on, or 1 if unknown or there
+ * are no threads. */
+int cpuCount(void);
+
+/* Start a thread calling fn(). Returns NULL if there are no threads, and
+ * panics if there are but one couldn't be started. */
+struct Thread *startThread(void (*fn)(void));
+
+/* Wait for a thread to return, and free it. */
+void joinThread(struct Thread *thread);
+
+struct Mutex *newMutex(void);
+void freeMutex(struct Mutex *mutex);
+void lockMutex(struct Mutex *mutex);
+void unlockMutex(struct Mutex *mutex);
+
+struct Cond *newCond(void);
+void freeCond(struct Cond *cond);
+
+/* Unlock mutex until cond is signalled, then lock it again. */
+void waitCond(struct Cond *cond, struct Mutex *mutex);
+void signalCond(struct Cond *cond);
+void broadcastCond(struct Cond *cond);
+
+#endif
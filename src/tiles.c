@@ -0,0 +1,418 @@
+/*
+ *  tiles.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "tiles.h"
+
+#include "atlas.h"
+#include "raster.h"
+#include "record.h"
+#include "span.h"
+#include "workers.h"
+#include "guikit/damage.h"
+#include "guikit/pmemory.h"
+#include "guikit/primrect.h"
+#include "guikit/ptypes.h"
+#include <stddef.h>
+
+enum {
+    TILE_SIZE = 64 /* Pixels along each side of a tile */
+};
+
+/* A command, with everything it needs to be drawn from any thread */
+struct Op
+{
+    const struct Command *cmd;
+    u32 color;
+    const struct Atlas *atlas; /* For CMD_GLYPHS */
+    struct Rect bounds; /* Where its pixels can land */
+};
+
+/* A batch of ops, binned by the tiles they touch */
+struct Bins
+{
+    const struct Op *ops;
+    int cols;
+    int rows;
+    struct Rect area; /* The part of the screen split into tiles */
+
+    /* Tile t draws ops[index[i]] for i from first[t] to first[t + 1] - 1. */
+    int *first;
+    int *index;
+    size_t cap;
+};
+
+static int isEmpty(const struct Rect *rect)
+{
+    return rect->right < rect->left || rect->bottom < rect->top;
+}
+
+/* Find where a command's pixels can land. Returns 0 if it must be drawn on
+ * its own, in order with the tiles, rather than as part of them. */
+static int findBounds(const struct Command *c, struct Rect *bounds)
+{
+    const int *a = c->a;
+    size_t i;
+
+    switch (c->type)
+    {
+    case CMD_FILL_SCREEN:
+        *bounds = screenRaster.clip;
+        break;
+    case CMD_DRAW_RECT:
+    case CMD_FILL_RECT:
+    case CMD_FILL_RECT_OP:
+        *bounds = c->dst;
+        break;
+    case CMD_VERT_LINE:
+        InitRect(bounds, a[0], a[1], 1, a[2]);
+        break;
+    case CMD_HORIZ_LINE:
+        InitRect(bounds, a[0], a[1], a[2], 1);
+        break;
+    case CMD_DIAG_LINE:
+        if (a[3] <= 0)
+        {
+            return 0;
+        }
+        RectFromLine(bounds, a[0], a[1],
+                     a[0] < a[2] ? a[0] + a[3] - 1 : a[0] - a[3] + 1,
+                     a[1] + a[3] - 1);
+        break;
+    case CMD_LINE:
+        RectFromLine(bounds, a[0], a[1], a[2], a[3]);
+        break;
+    case CMD_DRAW_CIRCLE:
+    case CMD_FILL_CIRCLE:
+        InitRect(bounds, a[0] - a[2], a[1] - a[2], 2 * a[2] + 1,
+                 2 * a[2] + 1);
+        break;
+    case CMD_DRAW_ROUND_RECT:
+    case CMD_FILL_ROUND_RECT:
+        rasterRoundBounds(bounds, a[0], a[1], a[2], a[3], a[4]);
+        break;
+    case CMD_GLYPHS:
+        if (!c->numGlyphs)
+        {
+            return 0;
+        }
+        *bounds = c->glyphs[0];
+        for (i = 1; i < c->numGlyphs; ++i)
+        {
+            GrowRect(bounds, &c->glyphs[i * 2]);
+        }
+        break;
+    case CMD_FILL_RECTS_COLORS:
+        if (!rasterRectsBounds(bounds, c->items, c->numItems))
+        {
+            return 0;
+        }
+        break;
+    case CMD_LINES_COLORS:
+        if (!c->numItems)
+        {
+            return 0;
+        }
+        rasterLinesBounds(bounds, c->items, c->numItems);
+        break;
+    default:
+        /* Bitmaps and blits can go through the backend, pixel arrays set
+         * up their conversion on this thread, polygons share one set of
+         * edge tables, fills can spread anywhere from what's been drawn
+         * before them, and clip rects change what the ops after them are
+         * clipped to. */
+        return 0;
+    }
+
+    /* Inside out primitives can draw all over the place. */
+    return !isEmpty(bounds);
+}
+
+static void addDamage(const struct Op *op)
+{
+    const struct Command *c = op->cmd;
+    size_t i;
+
+    switch (c->type)
+    {
+    case CMD_GLYPHS:
+        for (i = 0; i < c->numGlyphs; ++i)
+        {
+            AddDamage(&c->glyphs[i * 2]);
+        }
+        break;
+    default:
+        AddDamage(&op->bounds);
+        break;
+    }
+}
+
+static void drawOp(const struct Raster *r, const struct Op *op)
+{
+    const struct Command *c = op->cmd;
+    const int *a = c->a;
+    size_t i;
+
+    switch (c->type)
+    {
+    case CMD_FILL_SCREEN:
+        rasterFillRect(r, &r->clip);
+        break;
+    case CMD_DRAW_RECT:
+        rasterDrawRect(r, &c->dst);
+        break;
+    case CMD_FILL_RECT:
+        rasterFillRect(r, &c->dst);
+        break;
+    case CMD_FILL_RECT_OP:
+        rasterFillRectOp(r, c->mask, a[0], &c->dst);
+        break;
+    case CMD_VERT_LINE:
+        rasterVertLine(r, a[0], a[1], a[2]);
+        break;
+    case CMD_HORIZ_LINE:
+        rasterHorizLine(r, a[0], a[1], a[2]);
+        break;
+    case CMD_DIAG_LINE:
+        rasterDiagLine(r, a[0], a[1], a[2], a[3]);
+        break;
+    case CMD_LINE:
+        rasterLine(r, a[0], a[1], a[2], a[3]);
+        break;
+    case CMD_DRAW_CIRCLE:
+        rasterDrawCircle(r, a[0], a[1], a[2]);
+        break;
+    case CMD_FILL_CIRCLE:
+        rasterFillCircle(r, a[0], a[1], a[2]);
+        break;
+    case CMD_DRAW_ROUND_RECT:
+        rasterDrawRoundRect(r, a[0], a[1], a[2], a[3], a[4]);
+        break;
+    case CMD_FILL_ROUND_RECT:
+        rasterFillRoundRect(r, a[0], a[1], a[2], a[3], a[4]);
+        break;
+    case CMD_FILL_RECTS_COLORS:
+        rasterFillRects(r, c->items, c->colors, c->numItems);
+        break;
+    case CMD_LINES_COLORS:
+        rasterLines(r, c->items, c->colors, c->numItems);
+        break;
+    case CMD_GLYPHS:
+        for (i = 0; i < c->numGlyphs; ++i)
+        {
+            atlasDraw(r, op->atlas, &c->glyphs[i * 2], &c->glyphs[i * 2 + 1]);
+        }
+        break;
+    }
+}
+
+/* Draw every op binned into tile t, clipped to the tile and the clip rect. */
+static void drawTile(void *arg, int t)
+{
+    const struct Bins *bins = arg;
+    struct Raster r;
+    int i;
+
+    r = screenRaster;
+    r.clip.left = bins->area.left + (t % bins->cols) * TILE_SIZE;
+    r.clip.top = bins->area.top + (t / bins->cols) * TILE_SIZE;
+    r.clip.right = r.clip.left + TILE_SIZE - 1;
+    r.clip.bottom = r.clip.top + TILE_SIZE - 1;
+    ClipRect(&r.clip, &bins->area);
+    if (ClipRect(&r.clip, &screenRaster.clip) == CLIP_REJECTED)
+    {
+        return;
+    }
+
+    for (i = bins->first[t]; i < bins->first[t + 1]; ++i)
+    {
+        const struct Op *op = &bins->ops[bins->index[i]];
+
+        r.color = op->color;
+        drawOp(&r, op);
+    }
+}
+
+/* Which tiles the op's bounds touch. Returns 0 if none. */
+static int tileSpan(const struct Bins *bins, const struct Op *op,
+                    struct Rect *tiles)
+{
+    struct Rect b;
+
+    b = op->bounds;
+    if (ClipRect(&b, &bins->area) == CLIP_REJECTED ||
+        ClipRect(&b, &screenRaster.clip) == CLIP_REJECTED)
+    {
+        return 0;
+    }
+
+    tiles->left = (b.left - bins->area.left) / TILE_SIZE;
+    tiles->top = (b.top - bins->area.top) / TILE_SIZE;
+    tiles->right = (b.right - bins->area.left) / TILE_SIZE;
+    tiles->bottom = (b.bottom - bins->area.top) / TILE_SIZE;
+
+    return 1;
+}
+
+/* Bin num ops by tile and draw the tiles. */
+static void drawBatch(struct Bins *bins, const struct Op *ops, int num,
+                      int threads)
+{
+    int numTiles;
+    struct Rect tiles;
+    size_t total;
+    int i;
+    int x;
+    int y;
+
+    if (!num)
+    {
+        return;
+    }
+
+    bins->ops = ops;
+    numTiles = bins->cols * bins->rows;
+    for (i = 0; i <= numTiles; ++i)
+    {
+        bins->first[i] = 0;
+    }
+
+    /* Count each tile's ops, ... */
+    total = 0;
+    for (i = 0; i < num; ++i)
+    {
+        if (!tileSpan(bins, &ops[i], &tiles))
+        {
+            continue;
+        }
+        for (y = tiles.top; y <= tiles.bottom; ++y)
+        {
+            for (x = tiles.left; x <= tiles.right; ++x)
+            {
+                ++bins->first[y * bins->cols + x + 1];
+                ++total;
+            }
+        }
+    }
+
+    /* ... turn the counts into where each tile's list starts, ... */
+    for (i = 0; i < numTiles; ++i)
+    {
+        bins->first[i + 1] += bins->first[i];
+    }
+    if (total > bins->cap)
+    {
+        bins->cap = total;
+        bins->index = prealloc(bins->index, total * sizeof(*bins->index));
+    }
+
+    /* ... then fill the lists in, keeping each in command order. Filling
+     * moves each start along to the next tile's, so they're off by one tile
+     * afterwards. */
+    for (i = 0; i < num; ++i)
+    {
+        if (!tileSpan(bins, &ops[i], &tiles))
+        {
+            continue;
+        }
+        for (y = tiles.top; y <= tiles.bottom; ++y)
+        {
+            for (x = tiles.left; x <= tiles.right; ++x)
+            {
+                bins->index[bins->first[y * bins->cols + x]++] = i;
+            }
+        }
+    }
+    for (i = numTiles; i > 0; --i)
+    {
+        bins->first[i] = bins->first[i - 1];
+    }
+    bins->first[0] = 0;
+
+    rasterHoldRound();
+    runWorkers(drawTile, bins, numTiles, threads);
+    rasterReleaseRound();
+}
+
+int executeTiled(const struct Command *cmds, size_t num, int threads)
+{
+    struct Bins bins;
+    struct Op *ops;
+    const struct Pen *current;
+    int batched;
+    size_t i;
+
+    if (!screenRaster.pixels || isEmpty(rasterScreen()))
+    {
+        return -1;
+    }
+
+    /* Tile the whole screen, as clip rects can be pushed and popped along the
+     * way. */
+    bins.area = *rasterScreen();
+    bins.cols = (bins.area.right - bins.area.left + TILE_SIZE) / TILE_SIZE;
+    bins.rows = (bins.area.bottom - bins.area.top + TILE_SIZE) / TILE_SIZE;
+    bins.first = pmalloc((bins.cols * bins.rows + 1) * sizeof(*bins.first));
+    bins.index = NULL;
+    bins.cap = 0;
+    ops = pmalloc(num * sizeof(*ops));
+
+    /* Glyph atlases made for this batch must still be around when the tiles
+     * get drawn. */
+    atlasHold();
+
+    batched = 0;
+    current = NULL;
+    for (i = 0; i < num; ++i)
+    {
+        const struct Command *c = &cmds[i];
+        struct Op *op = &ops[batched];
+
+        if (!current || !samePen(current, &c->pen))
+        {
+            setPen(&c->pen);
+            current = &c->pen;
+        }
+
+        op->cmd = c;
+        op->color = screenRaster.color;
+        op->atlas = NULL;
+        if (c->type == CMD_GLYPHS)
+        {
+            op->atlas = atlasGet(c->img, c->a[1], c->a[2]);
+        }
+        else if (c->type == CMD_FILL_CIRCLE || c->type == CMD_FILL_ROUND_RECT)
+        {
+            rasterKeepRound(c->a[2]);
+        }
+
+        if (!findBounds(c, &op->bounds) ||
+            (c->type == CMD_GLYPHS && !op->atlas))
+        {
+            /* Draw everything before it first. */
+            drawBatch(&bins, ops, batched, threads);
+            batched = 0;
+            atlasRelease();
+            atlasHold();
+
+            executeCommand(c);
+            continue;
+        }
+
+        addDamage(op);
+        ++batched;
+    }
+    drawBatch(&bins, ops, batched, threads);
+
+    atlasRelease();
+
+    pfree(ops);
+    pfree(bins.index);
+    pfree(bins.first);
+
+    return 0;
+}
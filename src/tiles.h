@@ -0,0 +1,23 @@
+/*
+ *  tiles.h
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef TILES_H
+#define TILES_H
+
+#include <stddef.h>
+
+struct Command;
+
+/* Draw num display list commands by splitting the screen into tiles and
+ * drawing the tiles on up to threads threads. Bitmaps and blits are drawn
+ * on the calling thread, in order, between batches of tiles. Returns 0 once
+ * drawn, or non-zero if the backend can't draw this way, in which case
+ * nothing was drawn. */
+int executeTiled(const struct Command *cmds, size_t num, int threads);
+
+#endif
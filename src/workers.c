@@ -0,0 +1,189 @@
+/*
+ *  workers.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "workers.h"
+
+#include "threads.h"
+#include <stddef.h>
+
+enum {
+    MAX_WORKERS = 63 /* Besides the calling thread */
+};
+
+static struct Thread *pool[MAX_WORKERS];
+static int poolSize;
+static int poolWanted; /* Fewer start when there are no threads. */
+
+/* Everything below is guarded by lock. */
+static struct Mutex *lock;
+static struct Cond *wake;
+static struct Cond *finished;
+static unsigned long generation; /* Goes up by one for each job */
+static unsigned long poolGeneration; /* What it was when the pool started */
+static int stopping;
+static int busy; /* Workers still on the current job */
+
+static void (*jobFn)(void *arg, int i);
+static void *jobArg;
+static int jobCount;
+static int next;
+
+/* Take calls from the current job until there are none left. */
+static void work(void)
+{
+    for (;;)
+    {
+        int i;
+
+        lockMutex(lock);
+        i = next < jobCount ? next++ : -1;
+        unlockMutex(lock);
+
+        if (i < 0)
+        {
+            return;
+        }
+
+        jobFn(jobArg, i);
+    }
+}
+
+static void workerMain(void)
+{
+    unsigned long seen;
+
+    lockMutex(lock);
+    seen = poolGeneration;
+    for (;;)
+    {
+        while (generation == seen && !stopping)
+        {
+            waitCond(wake, lock);
+        }
+        if (stopping)
+        {
+            break;
+        }
+        seen = generation;
+        unlockMutex(lock);
+
+        work();
+
+        lockMutex(lock);
+        if (--busy == 0)
+        {
+            signalCond(finished);
+        }
+    }
+    unlockMutex(lock);
+}
+
+int countCPUs(void)
+{
+    int n = cpuCount();
+
+    return n > MAX_WORKERS + 1 ? MAX_WORKERS + 1 : n;
+}
+
+static void startWorkers(int num)
+{
+    lock = newMutex();
+    wake = newCond();
+    finished = newCond();
+
+    poolGeneration = generation;
+    poolWanted = num;
+    for (poolSize = 0; poolSize < num; ++poolSize)
+    {
+        pool[poolSize] = startThread(workerMain);
+        if (!pool[poolSize])
+        {
+            break;
+        }
+    }
+}
+
+void runWorkers(void (*fn)(void *arg, int i), void *arg, int count,
+                int threads)
+{
+    int i;
+
+    if (threads > MAX_WORKERS + 1)
+    {
+        threads = MAX_WORKERS + 1;
+    }
+    if (threads > count)
+    {
+        threads = count;
+    }
+
+    if (threads <= 1)
+    {
+        for (i = 0; i < count; ++i)
+        {
+            fn(arg, i);
+        }
+        return;
+    }
+
+    if (poolWanted != threads - 1)
+    {
+        stopWorkers();
+        startWorkers(threads - 1);
+    }
+
+    lockMutex(lock);
+    jobFn = fn;
+    jobArg = arg;
+    jobCount = count;
+    next = 0;
+    busy = poolSize;
+    ++generation;
+    broadcastCond(wake);
+    unlockMutex(lock);
+
+    work();
+
+    lockMutex(lock);
+    while (busy > 0)
+    {
+        waitCond(finished, lock);
+    }
+    unlockMutex(lock);
+}
+
+void stopWorkers(void)
+{
+    int i;
+
+    if (!lock)
+    {
+        return;
+    }
+
+    lockMutex(lock);
+    stopping = 1;
+    broadcastCond(wake);
+    unlockMutex(lock);
+
+    for (i = 0; i < poolSize; ++i)
+    {
+        joinThread(pool[i]);
+    }
+
+    stopping = 0;
+    poolSize = 0;
+    poolWanted = 0;
+
+    freeCond(finished);
+    freeCond(wake);
+    freeMutex(lock);
+    finished = NULL;
+    wake = NULL;
+    lock = NULL;
+}
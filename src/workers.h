@@ -0,0 +1,28 @@
+/*
+ *  workers.h
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef WORKERS_H
+#define WORKERS_H
+
+/* How many threads drawing may use, as set by SetRenderThreads() */
+extern int renderThreads;
+
+/* Return how many CPUs there are to run threads on, or 1 if unknown. */
+int countCPUs(void);
+
+/* Call fn(arg, i) for each i from 0 to count - 1, spread over up to threads
+ * threads. The calling thread is one of them. Returns once every call has
+ * returned. Calls may happen in any order, so each must only touch what's
+ * its own. The threads are kept around for next time. */
+void runWorkers(void (*fn)(void *arg, int i), void *arg, int count,
+                int threads);
+
+/* Wait for and free the threads kept by runWorkers(). */
+void stopWorkers(void);
+
+#endif
@@ -0,0 +1,227 @@
+/*
+ *  batch.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "guikit/dlist.h"
+#include "guikit/graphics.h"
+#include "guikit/pmemory.h"
+#include "guikit/primrect.h"
+#include "guikit/ptypes.h"
+#include "ptest/test.h"
+#include "screen.h"
+#include <stddef.h>
+#include <string.h>
+
+enum {
+    WIDTH = 160,
+    HEIGHT = 120,
+    NUM_ITEMS = 6
+};
+
+/* Some within the screen, some crossing its edges, one inside out, and one
+ * off it entirely */
+static const struct Rect rects[NUM_ITEMS] = {
+    {10, 10, 40, 30},
+    {-20, 50, 15, 60},
+    {100, 100, 200, 150},
+    {30, 30, 20, 40},
+    {300, 10, 310, 20},
+    {41, 10, 50, 30}
+};
+
+static const struct LineSeg lines[NUM_ITEMS] = {
+    {0, 0, WIDTH - 1, HEIGHT - 1},
+    {-30, 60, 200, 10},
+    {80, -10, 80, 200},
+    {5, 100, 60, 100},
+    {10, 10, 13, 70},
+    {150, 5, 120, 35}
+};
+
+static const int points[] = {
+    20, 20, 60, 25, 70, 80, 10, 110, 20, 20
+};
+
+static const u8 hsv[NUM_ITEMS * 3] = {
+    0x00, 0xFF, 0xFF,
+    0x30, 0xFF, 0xFF,
+    0x60, 0x80, 0xFF,
+    0x90, 0xFF, 0x40,
+    0xC0, 0xFF, 0xFF,
+    0xF0, 0x00, 0xFF
+};
+
+static int batchesMatchSingleCalls(int format)
+{
+    unsigned char *pixels;
+    unsigned char *expected;
+    size_t i;
+
+    pixels = initScreen(WIDTH, HEIGHT, format);
+    clearScreen();
+    SetColor(COLOR_BLUE);
+    for (i = 0; i < NUM_ITEMS; ++i)
+    {
+        FillRect(&rects[i]);
+    }
+    SetColor(COLOR_RED);
+    for (i = 0; i < NUM_ITEMS; ++i)
+    {
+        DrawLine(lines[i].x1, lines[i].y1, lines[i].x2, lines[i].y2);
+    }
+    SetColor(COLOR_GREEN);
+    for (i = 2; i < sizeof(points) / sizeof(points[0]); i += 2)
+    {
+        DrawLine(points[i - 2], points[i - 1], points[i], points[i + 1]);
+    }
+    expected = copyScreen(pixels);
+
+    clearScreen();
+    SetColor(COLOR_BLUE);
+    FillRects(rects, NUM_ITEMS);
+    SetColor(COLOR_RED);
+    DrawLines(lines, NUM_ITEMS);
+    SetColor(COLOR_GREEN);
+    DrawPolyline(points, sizeof(points) / sizeof(points[0]) / 2);
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+
+    /* Empty batches draw nothing. */
+    FillRects(rects, 0);
+    DrawLines(lines, 0);
+    DrawPolyline(points, 1);
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+
+    pfree(expected);
+    FreeGraphics();
+
+    return 0;
+}
+
+static int batchesMatchSingleCallsIndexed(void)
+{
+    return batchesMatchSingleCalls(PIXEL_FORMAT_INDEX8);
+}
+
+static int batchesMatchSingleCallsBGR555(void)
+{
+    return batchesMatchSingleCalls(PIXEL_FORMAT_BGR555);
+}
+
+static int batchesMatchSingleCallsXRGB8888(void)
+{
+    return batchesMatchSingleCalls(PIXEL_FORMAT_XRGB8888);
+}
+
+static void drawEachColor(void)
+{
+    size_t i;
+
+    for (i = 0; i < NUM_ITEMS; ++i)
+    {
+        SetColorHSV(hsv[i * 3], hsv[i * 3 + 1], hsv[i * 3 + 2]);
+        FillRect(&rects[i]);
+    }
+    for (i = 0; i < NUM_ITEMS; ++i)
+    {
+        SetColorHSV(hsv[i * 3], hsv[i * 3 + 1], hsv[i * 3 + 2]);
+        DrawLine(lines[i].x1, lines[i].y1, lines[i].x2, lines[i].y2);
+    }
+}
+
+static int colorsMatchPen(void)
+{
+    struct DisplayList *list;
+    u32 colors[NUM_ITEMS];
+    unsigned char *pixels;
+    unsigned char *expected;
+
+    pixels = initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_BGR555);
+    clearScreen();
+    drawEachColor();
+    expected = copyScreen(pixels);
+
+    clearScreen();
+    HSVToSurfaceColors(hsv, colors, NUM_ITEMS);
+    FillRectsColors(rects, colors, NUM_ITEMS);
+    DrawLinesColors(lines, colors, NUM_ITEMS);
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+
+    /* The pen is left alone, black from clearScreen(). */
+    FillScreen();
+    TEST_EQ(pixels[0], 0x00);
+    TEST_EQ(pixels[1], 0x00);
+
+    /* Recorded batches play back the same, on one thread or many. */
+    clearScreen();
+    list = NewDisplayList();
+    BeginDisplayList(list);
+    FillRectsColors(rects, colors, NUM_ITEMS);
+    DrawLinesColors(lines, colors, NUM_ITEMS);
+    EndDisplayList();
+    TEST_EQU(DisplayListLength(list), 2);
+
+    ExecuteDisplayList(list);
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+
+    clearScreen();
+    SetRenderThreads(4);
+    ExecuteDisplayList(list);
+    SetRenderThreads(1);
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+
+    FreeDisplayList(list);
+    pfree(expected);
+    FreeGraphics();
+
+    return 0;
+}
+
+static int recordedAsSingleCalls(void)
+{
+    struct DisplayList *list;
+    unsigned char *pixels;
+    unsigned char *expected;
+
+    pixels = initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_XRGB8888);
+    clearScreen();
+    SetColor(COLOR_PURPLE);
+    FillRects(rects, NUM_ITEMS);
+    DrawLines(lines, NUM_ITEMS);
+    DrawPolyline(points, sizeof(points) / sizeof(points[0]) / 2);
+    expected = copyScreen(pixels);
+
+    clearScreen();
+    list = NewDisplayList();
+    BeginDisplayList(list);
+    SetColor(COLOR_PURPLE);
+    FillRects(rects, NUM_ITEMS);
+    DrawLines(lines, NUM_ITEMS);
+    DrawPolyline(points, sizeof(points) / sizeof(points[0]) / 2);
+    EndDisplayList();
+
+    /* Rects and lines are copied, so each one is a command of its own. */
+    TEST_EQU(DisplayListLength(list), NUM_ITEMS + NUM_ITEMS + 4);
+
+    ExecuteDisplayList(list);
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+
+    FreeDisplayList(list);
+    pfree(expected);
+    FreeGraphics();
+
+    return 0;
+}
+
+const test_fn tests[] =
+{
+    batchesMatchSingleCallsIndexed,
+    batchesMatchSingleCallsBGR555,
+    batchesMatchSingleCallsXRGB8888,
+    colorsMatchPen,
+    recordedAsSingleCalls,
+    0
+};
@@ -0,0 +1,243 @@
+/*
+ *  bezier.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "guikit/dlist.h"
+#include "guikit/graphics.h"
+#include "guikit/pmemory.h"
+#include "ptest/test.h"
+#include "screen.h"
+#include <stddef.h>
+#include <string.h>
+
+enum {
+    WIDTH = 160,
+    HEIGHT = 120,
+    NUM_SAMPLES = 2048
+};
+
+/* Some of it off the top of the screen */
+static const int curve[] = {
+    10, 100, 40, -50, 120, 200, 150, 20
+};
+
+static void pointAt(const int *p, double t, double *x, double *y)
+{
+    double s = 1.0 - t;
+    double a = s * s * s;
+    double b = 3.0 * s * s * t;
+    double c = 3.0 * s * t * t;
+    double d = t * t * t;
+
+    *x = a * p[0] + b * p[2] + c * p[4] + d * p[6];
+    *y = a * p[1] + b * p[3] + c * p[5] + d * p[7];
+}
+
+static double nearest(const int *p, double x, double y)
+{
+    double best = -1.0;
+    int i;
+
+    for (i = 0; i <= NUM_SAMPLES; ++i)
+    {
+        double cx;
+        double cy;
+        double d;
+
+        pointAt(p, (double)i / NUM_SAMPLES, &cx, &cy);
+        d = (cx - x) * (cx - x) + (cy - y) * (cy - y);
+        if (best < 0.0 || d < best)
+        {
+            best = d;
+        }
+    }
+
+    return best;
+}
+
+static int straightCurveIsALine(void)
+{
+    static const int straight[] = {0, 0, 30, 15, 60, 30, 90, 45};
+    unsigned char *pixels;
+    unsigned char *expected;
+
+    pixels = initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_INDEX8);
+    clearScreen();
+    DrawLine(0, 0, 90, 45);
+    expected = copyScreen(pixels);
+
+    clearScreen();
+    DrawBezier(straight);
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+
+    pfree(expected);
+    FreeGraphics();
+
+    return 0;
+}
+
+static int curveStaysNearTrueCurve(void)
+{
+    unsigned char *pixels;
+    int x;
+    int y;
+    int i;
+
+    pixels = initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_INDEX8);
+    clearScreen();
+    DrawBezier(curve);
+
+    /* Every pixel drawn is close to the curve, ... */
+    for (y = 0; y < HEIGHT; ++y)
+    {
+        for (x = 0; x < WIDTH; ++x)
+        {
+            if (pixels[y * screenPitch + x] == COLOR_BLACK)
+            {
+                TEST_LE(nearest(curve, x, y) * 16.0, 25.0);
+            }
+        }
+    }
+
+    /* ... and every part of the curve on the screen has a pixel close by. */
+    for (i = 0; i <= NUM_SAMPLES; ++i)
+    {
+        double cx;
+        double cy;
+        int found = 0;
+
+        pointAt(curve, (double)i / NUM_SAMPLES, &cx, &cy);
+        x = (int)(cx + 0.5);
+        y = (int)(cy + 0.5);
+        if (x < 1 || x >= WIDTH - 1 || y < 1 || y >= HEIGHT - 1)
+        {
+            continue;
+        }
+        found = pixels[y * screenPitch + x] == COLOR_BLACK ||
+                pixels[y * screenPitch + x - 1] == COLOR_BLACK ||
+                pixels[y * screenPitch + x + 1] == COLOR_BLACK ||
+                pixels[(y - 1) * screenPitch + x] == COLOR_BLACK ||
+                pixels[(y + 1) * screenPitch + x] == COLOR_BLACK;
+        TEST_TRUE(found);
+    }
+
+    FreeGraphics();
+
+    return 0;
+}
+
+static int curveGoingNowhereIsADot(void)
+{
+    static const int dot[] = {40, 30, 40, 30, 40, 30, 40, 30};
+    unsigned char *pixels;
+    size_t count;
+    size_t i;
+
+    pixels = initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_INDEX8);
+    clearScreen();
+    DrawBezier(dot);
+
+    count = 0;
+    for (i = 0; i < screenSize; ++i)
+    {
+        count += pixels[i] == COLOR_BLACK;
+    }
+    TEST_EQU(count, 1);
+    TEST_EQ(pixels[30 * screenPitch + 40], COLOR_BLACK);
+
+    FreeGraphics();
+
+    return 0;
+}
+
+static int pathMatchesCurves(void)
+{
+    static const int path[] = {
+        10, 10, 60, -20, 80, 100, 40, 60,
+        0, 20, 150, 20, 150, 110
+    };
+    unsigned char *pixels;
+    unsigned char *expected;
+
+    pixels = initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_INDEX8);
+    clearScreen();
+    DrawBezier(&path[0]);
+    DrawBezier(&path[6]);
+    expected = copyScreen(pixels);
+
+    clearScreen();
+    DrawBezierPath(path, 2);
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+
+    /* No curves, no drawing */
+    clearScreen();
+    memcpy(expected, pixels, screenSize);
+    DrawBezierPath(path, 0);
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+
+    pfree(expected);
+    FreeGraphics();
+
+    return 0;
+}
+
+/* Record the curve to count the lines it was split into. */
+static size_t countLines(const int *xy)
+{
+    struct DisplayList *list;
+    size_t n;
+
+    list = NewDisplayList();
+    BeginDisplayList(list);
+    DrawBezier(xy);
+    EndDisplayList();
+    n = DisplayListLength(list);
+    FreeDisplayList(list);
+
+    return n;
+}
+
+static int biggerCurvesUseMoreLines(void)
+{
+    static const int straight[] = {0, 0, 300, 150, 600, 300, 900, 450};
+    int big[8];
+    size_t small;
+    size_t i;
+
+    initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_INDEX8);
+
+    TEST_EQU(countLines(straight), 1);
+
+    small = countLines(curve);
+    TEST_GT(small, 4);
+    for (i = 0; i < 8; ++i)
+    {
+        big[i] = curve[i] * 16;
+    }
+    TEST_GT(countLines(big), small);
+
+    /* Even a huge curve is split a bounded number of times. */
+    for (i = 0; i < 8; ++i)
+    {
+        big[i] = curve[i] * 10000 * (i % 3 ? -1 : 1);
+    }
+    TEST_LE(countLines(big), 65536);
+
+    FreeGraphics();
+
+    return 0;
+}
+
+const test_fn tests[] =
+{
+    straightCurveIsALine,
+    curveStaysNearTrueCurve,
+    curveGoingNowhereIsADot,
+    pathMatchesCurves,
+    biggerCurvesUseMoreLines,
+    0
+};
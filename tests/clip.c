@@ -0,0 +1,385 @@
+/*
+ *  clip.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "guikit/damage.h"
+#include "guikit/dlist.h"
+#include "guikit/graphics.h"
+#include "guikit/pmemory.h"
+#include "guikit/primrect.h"
+#include "ptest/test.h"
+#include "screen.h"
+#include <stddef.h>
+#include <string.h>
+
+enum {
+    WIDTH = 160,
+    HEIGHT = 120,
+    BPP = 4
+};
+
+/* A 16x4 1bpp image */
+static const unsigned char bitmap[] = {
+    0xF0, 0x0F,
+    0x3C, 0xC3,
+    0xFF, 0x00,
+    0xAA, 0x55
+};
+
+/* Something of every kind, all over the screen */
+static void drawScene(void)
+{
+    struct Rect rect;
+    struct Rect src;
+    int i;
+
+    SetColor(COLOR_BLUE);
+    InitRect(&rect, 10, 10, 100, 60);
+    FillRect(&rect);
+
+    SetColor(COLOR_RED);
+    for (i = 0; i < WIDTH; i += 13)
+    {
+        DrawLine(i, 0, WIDTH - 1 - i, HEIGHT - 1);
+    }
+    DrawVertLine(70, -5, 200);
+    DrawHorizLine(-5, 50, 200);
+    DrawDiagLine(20, 5, 100, 80);
+
+    SetColor(COLOR_GREEN);
+    FillCircle(80, 60, 30);
+    DrawCircle(40, 90, 25);
+    FillRoundRect(100, 70, 8, 50, 40);
+    DrawRoundRect(5, 75, 6, 60, 30);
+    InitRect(&rect, 90, 5, 60, 40);
+    DrawRect(&rect);
+
+    SetColor(COLOR_PURPLE);
+    InitRect(&src, 0, 0, 16, 4);
+    for (i = 0; i < 8; ++i)
+    {
+        InitRect(&rect, i * 20, i * 14, 16, 4);
+        Blit(bitmap, &rect, &src, 16);
+    }
+}
+
+/* Compare each pixel with expected inside clip, and with white outside. */
+static int matchesWithin(const unsigned char *pixels,
+                         const unsigned char *expected,
+                         const struct Rect *clip)
+{
+    int x;
+    int y;
+
+    for (y = 0; y < HEIGHT; ++y)
+    {
+        for (x = 0; x < WIDTH; ++x)
+        {
+            const unsigned char *p = &pixels[y * screenPitch + x * BPP];
+
+            if (x >= clip->left && x <= clip->right &&
+                y >= clip->top && y <= clip->bottom)
+            {
+                TEST_EQ(memcmp(p, &expected[y * screenPitch + x * BPP], BPP),
+                        0);
+            }
+            else
+            {
+                TEST_EQX(p[0], 0xFF);
+                TEST_EQX(p[1], 0xFF);
+                TEST_EQX(p[2], 0xFF);
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int drawingStaysWithinClip(void)
+{
+    unsigned char *pixels;
+    unsigned char *expected;
+    struct Rect clip;
+    int ret;
+
+    pixels = initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_XRGB8888);
+    clearScreen();
+    drawScene();
+    expected = copyScreen(pixels);
+
+    clearScreen();
+    InitRect(&clip, 30, 20, 70, 50);
+    PushClipRect(&clip);
+    drawScene();
+    PopClipRect();
+    ret = matchesWithin(pixels, expected, &clip);
+
+    pfree(expected);
+    FreeGraphics();
+
+    return ret;
+}
+
+static int nestedClipsIntersect(void)
+{
+    unsigned char *pixels;
+    unsigned char *expected;
+    struct Rect outer;
+    struct Rect inner;
+    struct Rect both;
+    int ret;
+
+    pixels = initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_XRGB8888);
+    clearScreen();
+    drawScene();
+    expected = copyScreen(pixels);
+
+    clearScreen();
+    InitRect(&outer, -20, 30, 120, 200);
+    InitRect(&inner, 60, -10, 80, 70);
+    PushClipRect(&outer);
+    PushClipRect(&inner);
+    drawScene();
+    PopClipRect();
+    PopClipRect();
+    InitRect(&both, 60, 30, 40, 30);
+    ret = matchesWithin(pixels, expected, &both);
+    if (ret)
+    {
+        return ret;
+    }
+
+    /* Popping gets the outer clip back, then the whole screen. */
+    clearScreen();
+    PushClipRect(&outer);
+    PushClipRect(&inner);
+    PopClipRect();
+    drawScene();
+    PopClipRect();
+    InitRect(&both, 0, 30, 100, HEIGHT - 30);
+    ret = matchesWithin(pixels, expected, &both);
+    if (ret)
+    {
+        return ret;
+    }
+
+    clearScreen();
+    drawScene();
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+
+    pfree(expected);
+    FreeGraphics();
+
+    return 0;
+}
+
+static int offscreenClipDrawsNothing(void)
+{
+    unsigned char *pixels;
+    unsigned char *expected;
+    struct Rect clip;
+    size_t num;
+
+    pixels = initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_XRGB8888);
+    clearScreen();
+    expected = copyScreen(pixels);
+
+    /* Like a widget scrolled out of its pane */
+    InitRect(&clip, 20, HEIGHT + 10, 50, 50);
+    PushClipRect(&clip);
+    drawScene();
+    FillScreen();
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+    GetDamage(&num);
+    TEST_EQU(num, 0);
+
+    /* Nor does anything pushed within it. */
+    InitRect(&clip, 0, 0, WIDTH, HEIGHT);
+    PushClipRect(&clip);
+    drawScene();
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+    PopClipRect();
+    PopClipRect();
+
+    pfree(expected);
+    FreeGraphics();
+
+    return 0;
+}
+
+static int damageIsClipped(void)
+{
+    const struct Rect *damage;
+    struct Rect clip;
+    size_t num;
+
+    initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_XRGB8888);
+    clearScreen();
+
+    InitRect(&clip, 30, 20, 70, 50);
+    PushClipRect(&clip);
+    FillScreen();
+    damage = GetDamage(&num);
+    TEST_EQU(num, 1);
+    TEST_EQ(damage[0].left, clip.left);
+    TEST_EQ(damage[0].top, clip.top);
+    TEST_EQ(damage[0].right, clip.right);
+    TEST_EQ(damage[0].bottom, clip.bottom);
+    PopClipRect();
+
+    /* Once popped, damage can go anywhere again. */
+    FillScreen();
+    damage = GetDamage(&num);
+    TEST_EQU(num, 1);
+    TEST_EQ(damage[0].left, 0);
+    TEST_EQ(damage[0].top, 0);
+    TEST_EQ(damage[0].right, WIDTH - 1);
+    TEST_EQ(damage[0].bottom, HEIGHT - 1);
+
+    FreeGraphics();
+
+    return 0;
+}
+
+static int recordedClipsPlayBack(void)
+{
+    struct DisplayList *list;
+    unsigned char *pixels;
+    unsigned char *expected;
+    struct Rect outer;
+    struct Rect inner;
+
+    pixels = initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_XRGB8888);
+    InitRect(&outer, 10, 10, 130, 90);
+    InitRect(&inner, 50, 30, 100, 40);
+
+    clearScreen();
+    PushClipRect(&outer);
+    drawScene();
+    PushClipRect(&inner);
+    SetColor(COLOR_ORANGE);
+    FillScreen();
+    PopClipRect();
+    FillCircle(20, 20, 15);
+    PopClipRect();
+    expected = copyScreen(pixels);
+
+    list = NewDisplayList();
+    BeginDisplayList(list);
+    PushClipRect(&outer);
+    drawScene();
+    PushClipRect(&inner);
+    SetColor(COLOR_ORANGE);
+    FillScreen();
+    PopClipRect();
+    FillCircle(20, 20, 15);
+    PopClipRect();
+    EndDisplayList();
+
+    /* Recording leaves the clip alone. */
+    clearScreen();
+    drawScene();
+    TEST_NE(memcmp(pixels, expected, screenSize), 0);
+
+    clearScreen();
+    ExecuteDisplayList(list);
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+
+    clearScreen();
+    SetRenderThreads(4);
+    ExecuteDisplayList(list);
+    SetRenderThreads(1);
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+
+    FreeDisplayList(list);
+    pfree(expected);
+    FreeGraphics();
+
+    return 0;
+}
+
+static int clippedLinesMatchWholeLines(void)
+{
+    unsigned char *pixels;
+    unsigned char *expected;
+    struct Rect clip;
+    int x1;
+    int y1;
+    int x2;
+    int y2;
+    int ret;
+    int i;
+
+    pixels = initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_XRGB8888);
+    expected = pmalloc(screenSize);
+
+    /* Lines within the screen are drawn whole, so show where every pixel
+     * should be. Clipped lines skip the runs they can, and must still put
+     * the rest in the same places. */
+    for (i = 0; i < 500; ++i)
+    {
+        x1 = randomIn(0, WIDTH - 1);
+        y1 = randomIn(0, HEIGHT - 1);
+        x2 = randomIn(0, WIDTH - 1);
+        y2 = randomIn(0, HEIGHT - 1);
+        if (i % 4 == 0)
+        {
+            /* Nearly horizontal or vertical, with long runs */
+            x1 = 0;
+            x2 = WIDTH - 1;
+        }
+        else if (i % 4 == 1)
+        {
+            y1 = 0;
+            y2 = HEIGHT - 1;
+        }
+        else if (i % 8 == 2)
+        {
+            /* Diagonal */
+            x2 = x1 < WIDTH / 2 ? x1 + HEIGHT / 2 : x1 - HEIGHT / 2;
+            y1 = randomIn(0, HEIGHT / 2 - 1);
+            y2 = y1 + HEIGHT / 2;
+        }
+
+        clip.left = randomIn(-10, WIDTH + 10);
+        clip.top = randomIn(-10, HEIGHT + 10);
+        clip.right = clip.left + randomIn(0, i % 2 ? 8 : WIDTH);
+        clip.bottom = clip.top + randomIn(0, i % 3 ? 8 : HEIGHT);
+
+        clearScreen();
+        SetColor(COLOR_BLACK);
+        DrawLine(x1, y1, x2, y2);
+        memcpy(expected, pixels, screenSize);
+
+        clearScreen();
+        SetColor(COLOR_BLACK);
+        PushClipRect(&clip);
+        DrawLine(x1, y1, x2, y2);
+        PopClipRect();
+        ret = matchesWithin(pixels, expected, &clip);
+        if (ret)
+        {
+            return ret;
+        }
+    }
+
+    pfree(expected);
+    FreeGraphics();
+
+    return 0;
+}
+
+const test_fn tests[] =
+{
+    drawingStaysWithinClip,
+    nestedClipsIntersect,
+    offscreenClipDrawsNothing,
+    damageIsClipped,
+    recordedClipsPlayBack,
+    clippedLinesMatchWholeLines,
+    0
+};
@@ -0,0 +1,132 @@
+/*
+ *  convert.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "convert.h"
+#include "ptest/test.h"
+#include <string.h>
+
+enum {
+    NUM_555 = 1 << 15
+};
+
+static u32 widen5(u32 c)
+{
+    return (c << 3) | (c >> 2);
+}
+
+static int widensEveryBGR555(void)
+{
+    static u16 src[NUM_555 + 3];
+    static u32 dst[NUM_555 + 3];
+    u32 i;
+
+    for (i = 0; i < NUM_555 + 3; ++i)
+    {
+        src[i] = (u16)(i % NUM_555);
+    }
+
+    /* An odd count, starting off alignment, to hit the leftovers too */
+    convertBGR555ToXRGB8888((u8 *)&dst[1], (const u8 *)&src[1], NUM_555 + 1);
+
+    for (i = 1; i < NUM_555 + 2; ++i)
+    {
+        u32 p = src[i];
+
+        TEST_EQX(dst[i], widen5(p & 0x1F) << 16 |
+                         widen5((p >> 5) & 0x1F) << 8 |
+                         widen5((p >> 10) & 0x1F));
+    }
+
+    return 0;
+}
+
+static int narrowsToBGR555(void)
+{
+    u32 src[37];
+    u16 dst[37];
+    int i;
+
+    for (i = 0; i < 37; ++i)
+    {
+        src[i] = 0xFF000000UL | (u32)i * 0x0107F3UL;
+    }
+
+    convertXRGB8888ToBGR555((u8 *)dst, (const u8 *)src, 37);
+
+    for (i = 0; i < 37; ++i)
+    {
+        u32 p = src[i];
+
+        /* The unused top byte is ignored. */
+        TEST_EQX(dst[i], ((p >> 19) & 0x1F) | ((p >> 11) & 0x1F) << 5 |
+                         ((p >> 3) & 0x1F) << 10);
+    }
+
+    return 0;
+}
+
+static int roundTripsBGR555(void)
+{
+    static u16 src[NUM_555];
+    static u32 wide[NUM_555];
+    static u16 dst[NUM_555];
+    u32 i;
+
+    for (i = 0; i < NUM_555; ++i)
+    {
+        src[i] = (u16)i;
+    }
+
+    convertBGR555ToXRGB8888((u8 *)wide, (const u8 *)src, NUM_555);
+    convertXRGB8888ToBGR555((u8 *)dst, (const u8 *)wide, NUM_555);
+
+    TEST_EQ(memcmp(src, dst, sizeof(src)), 0);
+
+    return 0;
+}
+
+static int looksUpEachSize(void)
+{
+    u32 lut[256];
+    u8 src[19];
+    u8 dst8[19];
+    u16 dst16[19];
+    u32 dst32[19];
+    int i;
+
+    for (i = 0; i < 256; ++i)
+    {
+        lut[i] = 0x01020304UL * (u32)(255 - i);
+    }
+    for (i = 0; i < 19; ++i)
+    {
+        src[i] = (u8)(i * 13);
+    }
+
+    convertLookup(dst8, 1, src, 19, lut);
+    convertLookup((u8 *)dst16, 2, src, 19, lut);
+    convertLookup((u8 *)dst32, 4, src, 19, lut);
+
+    for (i = 0; i < 19; ++i)
+    {
+        TEST_EQX(dst8[i], (u8)lut[src[i]]);
+        TEST_EQX(dst16[i], (u16)lut[src[i]]);
+        TEST_EQX(dst32[i], lut[src[i]]);
+    }
+
+    return 0;
+}
+
+const test_fn tests[] =
+{
+    widensEveryBGR555,
+    narrowsToBGR555,
+    roundTripsBGR555,
+    looksUpEachSize,
+    0
+};
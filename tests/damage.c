@@ -0,0 +1,251 @@
+/*
+ *  damage.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "guikit/damage.h"
+#include "guikit/primrect.h"
+#include "ptest/test.h"
+
+static void resetBounds(void)
+{
+    struct Rect screen;
+
+    InitRect(&screen, 0, 0, 640, 480);
+    SetDamageBounds(&screen);
+}
+
+static int damageStartsEmpty(void)
+{
+    size_t num;
+
+    resetBounds();
+    GetDamage(&num);
+
+    TEST_EQU(num, 0);
+
+    return 0;
+}
+
+static int damageIsClippedToBounds(void)
+{
+    const struct Rect *damage;
+    struct Rect r;
+    size_t num;
+
+    resetBounds();
+    InitRect(&r, -10, -20, 30, 40);
+    AddDamage(&r);
+    damage = GetDamage(&num);
+
+    TEST_EQU(num, 1);
+    TEST_EQ(damage[0].left, 0);
+    TEST_EQ(damage[0].top, 0);
+    TEST_EQ(damage[0].right, 19);
+    TEST_EQ(damage[0].bottom, 19);
+
+    return 0;
+}
+
+static int damageOutsideBoundsIsIgnored(void)
+{
+    struct Rect r;
+    size_t num;
+
+    resetBounds();
+    InitRect(&r, 640, 0, 10, 10);
+    AddDamage(&r);
+    GetDamage(&num);
+
+    TEST_EQU(num, 0);
+
+    return 0;
+}
+
+static int degenerateDamageIsIgnored(void)
+{
+    struct Rect r;
+    size_t num;
+
+    resetBounds();
+    InitRect(&r, 10, 10, 0, 5);
+    AddDamage(&r);
+    GetDamage(&num);
+
+    TEST_EQU(num, 0);
+
+    return 0;
+}
+
+static int onePixelDamageIsKept(void)
+{
+    const struct Rect *damage;
+    struct Rect r;
+    size_t num;
+
+    resetBounds();
+    InitRect(&r, 5, 6, 1, 1);
+    AddDamage(&r);
+    damage = GetDamage(&num);
+
+    TEST_EQU(num, 1);
+    TEST_EQ(damage[0].left, 5);
+    TEST_EQ(damage[0].top, 6);
+    TEST_EQ(damage[0].right, 5);
+    TEST_EQ(damage[0].bottom, 6);
+
+    return 0;
+}
+
+static int adjacentDamageIsMerged(void)
+{
+    const struct Rect *damage;
+    struct Rect r;
+    size_t num;
+
+    /* Glyphs drawn next to each other should end up as one rect. */
+    resetBounds();
+    InitRect(&r, 10, 10, 8, 12);
+    AddDamage(&r);
+    InitRect(&r, 18, 10, 8, 12);
+    AddDamage(&r);
+    damage = GetDamage(&num);
+
+    TEST_EQU(num, 1);
+    TEST_EQ(damage[0].left, 10);
+    TEST_EQ(damage[0].top, 10);
+    TEST_EQ(damage[0].right, 25);
+    TEST_EQ(damage[0].bottom, 21);
+
+    return 0;
+}
+
+static int separateDamageIsKeptSeparate(void)
+{
+    struct Rect r;
+    size_t num;
+
+    resetBounds();
+    InitRect(&r, 10, 10, 8, 8);
+    AddDamage(&r);
+    InitRect(&r, 100, 100, 8, 8);
+    AddDamage(&r);
+    GetDamage(&num);
+
+    TEST_EQU(num, 2);
+
+    return 0;
+}
+
+static int bridgingDamageMergesAll(void)
+{
+    const struct Rect *damage;
+    struct Rect r;
+    size_t num;
+
+    resetBounds();
+    InitRect(&r, 0, 0, 10, 10);
+    AddDamage(&r);
+    InitRect(&r, 50, 0, 10, 10);
+    AddDamage(&r);
+    InitRect(&r, 5, 5, 50, 2);
+    AddDamage(&r);
+    damage = GetDamage(&num);
+
+    TEST_EQU(num, 1);
+    TEST_EQ(damage[0].left, 0);
+    TEST_EQ(damage[0].top, 0);
+    TEST_EQ(damage[0].right, 59);
+    TEST_EQ(damage[0].bottom, 9);
+
+    return 0;
+}
+
+static int damageIsCapped(void)
+{
+    const struct Rect *damage;
+    struct Rect r;
+    size_t num;
+    size_t i;
+    size_t j;
+    int x;
+
+    resetBounds();
+    for (x = 0; x < 600; x += 20)
+    {
+        InitRect(&r, x, 0, 10, 10);
+        AddDamage(&r);
+    }
+    damage = GetDamage(&num);
+
+    TEST_EQU(num, MAX_DAMAGE_RECTS);
+
+    /* Merged rects must not overlap. */
+    for (i = 0; i < num; ++i)
+    {
+        for (j = i + 1; j < num; ++j)
+        {
+            struct Rect overlap;
+            TEST_EQ(RectIntersect(&damage[i], &damage[j], &overlap),
+                    RECT_NO_INTERSECT);
+        }
+    }
+
+    return 0;
+}
+
+static int damageAllCoversBounds(void)
+{
+    const struct Rect *damage;
+    struct Rect r;
+    size_t num;
+
+    resetBounds();
+    InitRect(&r, 10, 10, 8, 8);
+    AddDamage(&r);
+    AddDamageAll();
+    damage = GetDamage(&num);
+
+    TEST_EQU(num, 1);
+    TEST_EQ(damage[0].left, 0);
+    TEST_EQ(damage[0].top, 0);
+    TEST_EQ(damage[0].right, 639);
+    TEST_EQ(damage[0].bottom, 479);
+
+    return 0;
+}
+
+static int clearDamageEmptiesList(void)
+{
+    struct Rect r;
+    size_t num;
+
+    resetBounds();
+    InitRect(&r, 10, 10, 8, 8);
+    AddDamage(&r);
+    ClearDamage();
+    GetDamage(&num);
+
+    TEST_EQU(num, 0);
+
+    return 0;
+}
+
+const test_fn tests[] =
+{
+    damageStartsEmpty,
+    damageIsClippedToBounds,
+    damageOutsideBoundsIsIgnored,
+    degenerateDamageIsIgnored,
+    onePixelDamageIsKept,
+    adjacentDamageIsMerged,
+    separateDamageIsKeptSeparate,
+    bridgingDamageMergesAll,
+    damageIsCapped,
+    damageAllCoversBounds,
+    clearDamageEmptiesList,
+    0
+};
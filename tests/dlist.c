@@ -0,0 +1,237 @@
+/*
+ *  dlist.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "guikit/dlist.h"
+#include "record.h"
+#include "guikit/graphics.h"
+#include "guikit/pmemory.h"
+#include "guikit/primrect.h"
+#include "ptest/test.h"
+#include "screen.h"
+#include <stddef.h>
+#include <string.h>
+
+enum {
+    WIDTH = 160,
+    HEIGHT = 120
+};
+
+/* A 16x2 1bpp image, with 2 glyphs 8 pixels wide */
+static const unsigned char glyphs[] = {
+    0x81, 0x3C,
+    0x7E, 0xC3
+};
+
+static const unsigned char checker[] = {
+    0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55
+};
+
+static void drawScene(void)
+{
+    struct Rect rect;
+
+    SetColor(COLOR_BLUE);
+    InitRect(&rect, 10, 10, 50, 30);
+    FillRect(&rect);
+    SetColorRGB(0x12, 0x80, 0xF0);
+    DrawLine(0, 0, WIDTH - 1, HEIGHT - 1);
+    DrawCircle(80, 60, 30);
+    FillRoundRect(-5, 90, 6, 60, 40);
+    SetColorHSV(0x40, 0xFF, 0xFF);
+    FillCircle(150, 10, 20);
+    DrawVertLine(3, -10, 200);
+    DrawHorizLine(-10, 3, 200);
+    DrawDiagLine(100, 100, 0, 50);
+    DrawRoundRect(20, 50, 4, 30, 20);
+    SetColor(COLOR_RED);
+    InitRect(&rect, 60, 5, 40, 40);
+    FillRectOp(checker, OP_PAT_OR, &rect);
+    DrawRect(&rect);
+}
+
+static int replayMatchesImmediate(void)
+{
+    struct DisplayList *list;
+    unsigned char *pixels;
+    unsigned char *expected;
+
+    pixels = initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_BGR555);
+    drawScene();
+    expected = copyScreen(pixels);
+
+    SetColor(COLOR_WHITE);
+    FillScreen();
+
+    list = NewDisplayList();
+    BeginDisplayList(list);
+    drawScene();
+    EndDisplayList();
+
+    /* Recording doesn't draw anything. */
+    TEST_EQ(pixels[0], 0xFF);
+    TEST_EQ(pixels[screenSize / 2], 0xFF);
+
+    /* The pen is still white, but each command brings its own. */
+    ExecuteDisplayList(list);
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+
+    /* Again, to see the list is still good. */
+    SetColor(COLOR_WHITE);
+    FillScreen();
+    ExecuteDisplayList(list);
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+
+    FreeDisplayList(list);
+    pfree(expected);
+    FreeGraphics();
+
+    return 0;
+}
+
+static int fillsThatLineUpAreMerged(void)
+{
+    struct DisplayList *list;
+    struct Rect rect;
+    unsigned char *pixels;
+    unsigned char *expected;
+    int y;
+
+    pixels = initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_BGR555);
+
+    list = NewDisplayList();
+    BeginDisplayList(list);
+    SetColor(COLOR_GREEN);
+    for (y = 0; y < 8; ++y)
+    {
+        InitRect(&rect, 10, 10 + y * 5, 30, 5);
+        FillRect(&rect);
+    }
+    InitRect(&rect, 40, 10, 20, 40);
+    FillRect(&rect);
+
+    /* A different color breaks the run. */
+    SetColor(COLOR_RED);
+    InitRect(&rect, 60, 10, 20, 40);
+    FillRect(&rect);
+    EndDisplayList();
+
+    TEST_EQU(DisplayListLength(list), 2);
+
+    ExecuteDisplayList(list);
+    expected = copyScreen(pixels);
+
+    SetColor(COLOR_WHITE);
+    FillScreen();
+    SetColor(COLOR_GREEN);
+    InitRect(&rect, 10, 10, 50, 40);
+    FillRect(&rect);
+    SetColor(COLOR_RED);
+    InitRect(&rect, 60, 10, 20, 40);
+    FillRect(&rect);
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+
+    FreeDisplayList(list);
+    pfree(expected);
+    FreeGraphics();
+
+    return 0;
+}
+
+static void drawGlyphs(int record)
+{
+    struct Rect dst;
+    struct Rect src;
+    int i;
+
+    for (i = 0; i < 20; ++i)
+    {
+        InitRect(&src, (i % 2) * 8, 0, 8, 2);
+        InitRect(&dst, i * 8 - 4, 50, 8, 2);
+        if (record)
+        {
+            recordGlyph(glyphs, 16, 2, &dst, &src);
+        }
+        else
+        {
+            BlitOp(glyphs, OP_SRC_INV, &dst, &src, 16);
+        }
+    }
+}
+
+static int glyphsAreCoalesced(void)
+{
+    struct DisplayList *list;
+    unsigned char *pixels;
+    unsigned char *expected;
+
+    pixels = initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_BGR555);
+    SetColor(COLOR_PURPLE);
+    drawGlyphs(0);
+    expected = copyScreen(pixels);
+
+    SetColor(COLOR_WHITE);
+    FillScreen();
+
+    list = NewDisplayList();
+    BeginDisplayList(list);
+    SetColor(COLOR_PURPLE);
+    drawGlyphs(1);
+    EndDisplayList();
+
+    TEST_EQU(DisplayListLength(list), 1);
+
+    ExecuteDisplayList(list);
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+
+    FreeDisplayList(list);
+    pfree(expected);
+    FreeGraphics();
+
+    return 0;
+}
+
+static int listsNestByInlining(void)
+{
+    struct DisplayList *inner;
+    struct DisplayList *outer;
+    struct Rect rect;
+
+    initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_BGR555);
+
+    inner = NewDisplayList();
+    BeginDisplayList(inner);
+    SetColor(COLOR_RED);
+    InitRect(&rect, 0, 0, 10, 10);
+    FillRect(&rect);
+    DrawLine(0, 0, 10, 10);
+    EndDisplayList();
+
+    outer = NewDisplayList();
+    BeginDisplayList(outer);
+    ExecuteDisplayList(inner);
+    ExecuteDisplayList(inner);
+    EndDisplayList();
+
+    /* Each execution copies in all of inner's commands. */
+    TEST_EQU(DisplayListLength(outer), 4);
+
+    FreeDisplayList(outer);
+    FreeDisplayList(inner);
+    FreeGraphics();
+
+    return 0;
+}
+
+const test_fn tests[] =
+{
+    replayMatchesImmediate,
+    fillsThatLineUpAreMerged,
+    glyphsAreCoalesced,
+    listsNestByInlining,
+    0
+};
@@ -0,0 +1,109 @@
+/*
+ *  expand.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "expand.h"
+#include "ptest/test.h"
+
+enum {
+    ON = 0x0C,
+    OFF = 0x03,
+    TRANSPARENT = 0x10,
+    NUM_BYTES = 37 /* Enough to hit both the wide and narrow paths */
+};
+
+static int expandsEveryByte(void)
+{
+    u8 bits[256];
+    u8 pixels[256 * 8];
+    int i;
+
+    for (i = 0; i < 256; ++i)
+    {
+        bits[i] = (u8)i;
+    }
+
+    expandBits(pixels, bits, 256, ON, OFF);
+
+    for (i = 0; i < 256 * 8; ++i)
+    {
+        int set = bits[i / 8] & (0x80 >> (i % 8));
+
+        TEST_EQ(pixels[i], set ? ON : OFF);
+    }
+
+    return 0;
+}
+
+static int expandsOddLengths(void)
+{
+    u8 bits[NUM_BYTES];
+    u8 pixels[NUM_BYTES * 8 + 1];
+    size_t count;
+    int i;
+
+    for (i = 0; i < NUM_BYTES; ++i)
+    {
+        bits[i] = (u8)(i * 37 + 11);
+    }
+
+    for (count = 0; count <= NUM_BYTES; ++count)
+    {
+        pixels[count * 8] = 0xAA;
+        expandBits(pixels, bits, count, ON, OFF);
+
+        for (i = 0; i < (int)count * 8; ++i)
+        {
+            int set = bits[i / 8] & (0x80 >> (i % 8));
+
+            TEST_EQ(pixels[i], set ? ON : OFF);
+        }
+
+        /* Nothing written past the end */
+        TEST_EQ(pixels[count * 8], 0xAA);
+    }
+
+    return 0;
+}
+
+static int expandsMasked(void)
+{
+    u8 bits[NUM_BYTES];
+    u8 mask[NUM_BYTES];
+    u8 pixels[NUM_BYTES * 8];
+    size_t count;
+    int i;
+
+    for (i = 0; i < NUM_BYTES; ++i)
+    {
+        bits[i] = (u8)(i * 37 + 11);
+        mask[i] = (u8)(i * 91 + 5);
+    }
+
+    for (count = 0; count <= NUM_BYTES; ++count)
+    {
+        expandBitsMasked(pixels, bits, mask, count, ON, OFF, TRANSPARENT);
+
+        for (i = 0; i < (int)count * 8; ++i)
+        {
+            int set = bits[i / 8] & (0x80 >> (i % 8));
+            int visible = mask[i / 8] & (0x80 >> (i % 8));
+
+            TEST_EQ(pixels[i], visible ? set ? ON : OFF : TRANSPARENT);
+        }
+    }
+
+    return 0;
+}
+
+const test_fn tests[] =
+{
+    expandsEveryByte,
+    expandsOddLengths,
+    expandsMasked,
+    0
+};
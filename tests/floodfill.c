@@ -0,0 +1,415 @@
+/*
+ *  floodfill.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "guikit/damage.h"
+#include "guikit/dlist.h"
+#include "guikit/graphics.h"
+#include "guikit/pmemory.h"
+#include "guikit/primrect.h"
+#include "ptest/test.h"
+#include "screen.h"
+#include <stddef.h>
+#include <string.h>
+
+enum {
+    WIDTH = 160,
+    HEIGHT = 120
+};
+
+/* Outlines and blobs all over, in red and blue */
+static void drawScene(void)
+{
+    struct Rect rect;
+    int i;
+
+    for (i = 0; i < 12; ++i)
+    {
+        SetColor(i % 2 ? COLOR_RED : COLOR_BLUE);
+        DrawCircle(randomIn(0, WIDTH), randomIn(0, HEIGHT),
+                   randomIn(2, 40));
+        DrawLine(randomIn(0, WIDTH), randomIn(0, HEIGHT),
+                 randomIn(0, WIDTH), randomIn(0, HEIGHT));
+        InitRect(&rect, randomIn(0, WIDTH), randomIn(0, HEIGHT),
+                 randomIn(1, 50), randomIn(1, 50));
+        if (i % 3)
+        {
+            DrawRect(&rect);
+        }
+        else
+        {
+            FillCircle(rect.left, rect.top, randomIn(1, 6));
+        }
+    }
+}
+
+static int samePixel(const unsigned char *a, const unsigned char *b, int x,
+                     int y)
+{
+    size_t i = (size_t)y * screenPitch + (size_t)x * screenBpp;
+
+    return memcmp(&a[i], &b[i], (size_t)screenBpp) == 0;
+}
+
+static int isPixel(const unsigned char *pixels, const unsigned char *color,
+                   int x, int y)
+{
+    size_t i = (size_t)y * screenPitch + (size_t)x * screenBpp;
+
+    return memcmp(&pixels[i], color, (size_t)screenBpp) == 0;
+}
+
+/* Fill the way it's defined, a pixel at a time, into filled: from (x, y)
+ * through pixels like before's at (x, y), or not like border and not like
+ * pen. */
+static void referenceFill(const unsigned char *before,
+                          const unsigned char *border,
+                          const unsigned char *pen, const struct Rect *clip,
+                          int x, int y, unsigned char *filled)
+{
+    static int queue[WIDTH * HEIGHT];
+    static const int dx[] = {1, -1, 0, 0};
+    static const int dy[] = {0, 0, 1, -1};
+    size_t head;
+    size_t tail;
+    int seedX = x;
+    int seedY = y;
+    int i;
+
+    memset(filled, 0, WIDTH * HEIGHT);
+    head = 0;
+    tail = 0;
+    queue[tail++] = y * WIDTH + x;
+    filled[y * WIDTH + x] = 1;
+    while (head < tail)
+    {
+        x = queue[head] % WIDTH;
+        y = queue[head] / WIDTH;
+        ++head;
+
+        for (i = 0; i < 4; ++i)
+        {
+            int nx = x + dx[i];
+            int ny = y + dy[i];
+            int inside;
+
+            if (nx < clip->left || nx > clip->right || ny < clip->top ||
+                ny > clip->bottom || filled[ny * WIDTH + nx])
+            {
+                continue;
+            }
+
+            if (border)
+            {
+                inside = !isPixel(before, border, nx, ny) &&
+                         !isPixel(before, pen, nx, ny);
+            }
+            else
+            {
+                inside = isPixel(before,
+                                 &before[seedY * screenPitch +
+                                         seedX * screenBpp],
+                                 nx, ny);
+            }
+
+            if (inside)
+            {
+                filled[ny * WIDTH + nx] = 1;
+                queue[tail++] = ny * WIDTH + nx;
+            }
+        }
+    }
+}
+
+/* Check every filled pixel is the pen's color, and the rest are as before. */
+static int matchesReference(const unsigned char *pixels,
+                            const unsigned char *before,
+                            const unsigned char *pen,
+                            const unsigned char *filled)
+{
+    int x;
+    int y;
+
+    for (y = 0; y < HEIGHT; ++y)
+    {
+        for (x = 0; x < WIDTH; ++x)
+        {
+            if (filled[y * WIDTH + x])
+            {
+                TEST_TRUE(isPixel(pixels, pen, x, y));
+            }
+            else
+            {
+                TEST_TRUE(samePixel(pixels, before, x, y));
+            }
+        }
+    }
+
+    return 0;
+}
+
+/* Get what a color looks like in the framebuffer, by drawing a pixel of it
+ * in the corner of a scratch screen. */
+static void pixelOf(int color, unsigned char *pixels, unsigned char *out)
+{
+    unsigned char corner[4];
+
+    memcpy(corner, pixels, (size_t)screenBpp);
+    SetColor(color);
+    DrawHorizLine(0, 0, 1);
+    memcpy(out, pixels, (size_t)screenBpp);
+    memcpy(pixels, corner, (size_t)screenBpp);
+}
+
+static int fillsMatchReference(int format)
+{
+    static unsigned char filled[WIDTH * HEIGHT];
+    unsigned char *pixels;
+    unsigned char *before;
+    unsigned char pen[4];
+    unsigned char border[4];
+    struct Rect screen;
+    int ret;
+    int i;
+
+    pixels = initScreen(WIDTH, HEIGHT, format);
+    InitRect(&screen, 0, 0, WIDTH, HEIGHT);
+    pixelOf(COLOR_ORANGE, pixels, pen);
+    pixelOf(COLOR_RED, pixels, border);
+
+    for (i = 0; i < 40; ++i)
+    {
+        int x = randomIn(0, WIDTH - 1);
+        int y = randomIn(0, HEIGHT - 1);
+
+        clearScreen();
+        drawScene();
+        before = copyScreen(pixels);
+
+        SetColor(COLOR_ORANGE);
+        if (i % 2)
+        {
+            BoundaryFill(x, y, COLOR_RED);
+            referenceFill(before, border, pen, &screen, x, y, filled);
+            if (isPixel(before, border, x, y) || isPixel(before, pen, x, y))
+            {
+                memset(filled, 0, sizeof(filled));
+            }
+        }
+        else
+        {
+            FloodFill(x, y);
+            referenceFill(before, NULL, pen, &screen, x, y, filled);
+        }
+
+        ret = matchesReference(pixels, before, pen, filled);
+        pfree(before);
+        if (ret)
+        {
+            return ret;
+        }
+    }
+
+    FreeGraphics();
+
+    return 0;
+}
+
+static int fillsMatchReferenceIndexed(void)
+{
+    return fillsMatchReference(PIXEL_FORMAT_INDEX8);
+}
+
+static int fillsMatchReferenceBGR555(void)
+{
+    return fillsMatchReference(PIXEL_FORMAT_BGR555);
+}
+
+static int fillsMatchReferenceXRGB8888(void)
+{
+    return fillsMatchReference(PIXEL_FORMAT_XRGB8888);
+}
+
+static int fillInsideOutline(void)
+{
+    unsigned char *pixels;
+    unsigned char *expected;
+    struct Rect rect;
+
+    pixels = initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_INDEX8);
+    clearScreen();
+    SetColor(COLOR_BLACK);
+    InitRect(&rect, 20, 10, 100, 80);
+    DrawRect(&rect);
+    SetColor(COLOR_GREEN);
+    InitRect(&rect, 21, 11, 98, 78);
+    FillRect(&rect);
+    expected = copyScreen(pixels);
+
+    /* Filling over the pen's own color changes nothing. */
+    FloodFill(50, 50);
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+
+    clearScreen();
+    SetColor(COLOR_BLACK);
+    InitRect(&rect, 20, 10, 100, 80);
+    DrawRect(&rect);
+    SetColor(COLOR_GREEN);
+    FloodFill(50, 50);
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+
+    /* The outline stops a boundary fill from outside getting in. */
+    SetColor(COLOR_BLUE);
+    BoundaryFill(0, 0, COLOR_BLACK);
+    TEST_EQ(pixels[0], COLOR_BLUE);
+    TEST_EQ(pixels[(HEIGHT - 1) * screenPitch + WIDTH - 1], COLOR_BLUE);
+    TEST_EQ(pixels[10 * screenPitch + 20], COLOR_BLACK);
+    TEST_EQ(pixels[50 * screenPitch + 50], COLOR_GREEN);
+
+    /* Seeds off the screen or on the border fill nothing. */
+    memcpy(expected, pixels, screenSize);
+    SetColor(COLOR_RED);
+    FloodFill(-1, 50);
+    FloodFill(50, HEIGHT);
+    BoundaryFill(20, 10, COLOR_BLACK);
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+
+    pfree(expected);
+    FreeGraphics();
+
+    return 0;
+}
+
+static int fillStaysWithinClip(void)
+{
+    const struct Rect *damage;
+    unsigned char *pixels;
+    struct Rect clip;
+    size_t num;
+    int x;
+    int y;
+
+    pixels = initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_INDEX8);
+    clearScreen();
+    ClearDamage();
+
+    InitRect(&clip, 30, 20, 70, 50);
+    PushClipRect(&clip);
+    SetColor(COLOR_PURPLE);
+    FloodFill(40, 30);
+    PopClipRect();
+
+    for (y = 0; y < HEIGHT; ++y)
+    {
+        for (x = 0; x < WIDTH; ++x)
+        {
+            int inside = x >= clip.left && x <= clip.right &&
+                         y >= clip.top && y <= clip.bottom;
+
+            TEST_EQ(pixels[y * screenPitch + x],
+                    inside ? COLOR_PURPLE : COLOR_WHITE);
+        }
+    }
+
+    damage = GetDamage(&num);
+    TEST_EQU(num, 1);
+    TEST_EQ(damage[0].left, clip.left);
+    TEST_EQ(damage[0].top, clip.top);
+    TEST_EQ(damage[0].right, clip.right);
+    TEST_EQ(damage[0].bottom, clip.bottom);
+
+    FreeGraphics();
+
+    return 0;
+}
+
+/* A spiral, so runs have to wind back and forth to get everywhere */
+static void drawSpiral(void)
+{
+    int i;
+
+    SetColor(COLOR_BLACK);
+    for (i = 0; i < 14; ++i)
+    {
+        int d = i * 4;
+
+        DrawHorizLine(d, d + 2, WIDTH - 2 * d);
+        DrawVertLine(WIDTH - 1 - d, d + 2, HEIGHT - 2 * d - 2);
+        DrawHorizLine(d + 4, HEIGHT - 1 - d, WIDTH - 2 * d - 4);
+        DrawVertLine(d + 4, d + 6, HEIGHT - 2 * d - 6);
+    }
+}
+
+static int recordedFillsPlayBack(void)
+{
+    static unsigned char filled[WIDTH * HEIGHT];
+    struct DisplayList *list;
+    unsigned char *pixels;
+    unsigned char *before;
+    unsigned char *expected;
+    unsigned char pen[1];
+    struct Rect screen;
+    int ret;
+
+    pixels = initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_INDEX8);
+    InitRect(&screen, 0, 0, WIDTH, HEIGHT);
+    clearScreen();
+    drawSpiral();
+    before = copyScreen(pixels);
+
+    SetColor(COLOR_YELLOW);
+    FloodFill(0, 0);
+    pen[0] = COLOR_YELLOW;
+    referenceFill(before, NULL, pen, &screen, 0, 0, filled);
+    ret = matchesReference(pixels, before, pen, filled);
+    if (ret)
+    {
+        return ret;
+    }
+    SetColor(COLOR_PINK);
+    BoundaryFill(WIDTH / 2, HEIGHT / 2, COLOR_BLACK);
+    expected = copyScreen(pixels);
+
+    list = NewDisplayList();
+    BeginDisplayList(list);
+    SetColor(COLOR_WHITE);
+    FillScreen();
+    drawSpiral();
+    SetColor(COLOR_YELLOW);
+    FloodFill(0, 0);
+    SetColor(COLOR_PINK);
+    BoundaryFill(WIDTH / 2, HEIGHT / 2, COLOR_BLACK);
+    EndDisplayList();
+
+    clearScreen();
+    ExecuteDisplayList(list);
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+
+    clearScreen();
+    SetRenderThreads(4);
+    ExecuteDisplayList(list);
+    SetRenderThreads(1);
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+
+    FreeDisplayList(list);
+    pfree(expected);
+    pfree(before);
+    FreeGraphics();
+
+    return 0;
+}
+
+const test_fn tests[] =
+{
+    fillsMatchReferenceIndexed,
+    fillsMatchReferenceBGR555,
+    fillsMatchReferenceXRGB8888,
+    fillInsideOutline,
+    fillStaysWithinClip,
+    recordedFillsPlayBack,
+    0
+};
@@ -0,0 +1,118 @@
+/*
+ *  hsv.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "hsv.h"
+#include "ptest/test.h"
+
+/* The conversion as it was, with real divisions */
+static void divideHSVToRGB(u8 h, u8 s, u8 v, u8 *r, u8 *g, u8 *b)
+{
+    const unsigned int hi = h / 43;
+    const unsigned int hj = (h - hi * 43) * 6;
+    const unsigned int p = v * (255 - s) / 255;
+    const unsigned int q = v * (255 - (s * hj) / 255) / 255;
+    const unsigned int t = v * (255 - (s * (255 - hj)) / 255) / 255;
+    switch (hi)
+    {
+    case 0:
+        *r = (u8)v;
+        *g = (u8)t;
+        *b = (u8)p;
+        break;
+    case 1:
+        *r = (u8)q;
+        *g = (u8)v;
+        *b = (u8)p;
+        break;
+    case 2:
+        *r = (u8)p;
+        *g = (u8)v;
+        *b = (u8)t;
+        break;
+    case 3:
+        *r = (u8)p;
+        *g = (u8)q;
+        *b = (u8)v;
+        break;
+    case 4:
+        *r = (u8)t;
+        *g = (u8)p;
+        *b = (u8)v;
+        break;
+    default:
+        *r = (u8)v;
+        *g = (u8)p;
+        *b = (u8)q;
+        break;
+    }
+}
+
+static int matchesDividing(void)
+{
+    unsigned int h;
+    unsigned int s;
+    unsigned int v;
+
+    for (h = 0; h < 256; ++h)
+    {
+        for (s = 0; s < 256; ++s)
+        {
+            for (v = 0; v < 256; ++v)
+            {
+                u8 r1, g1, b1;
+                u8 r2, g2, b2;
+
+                hsvToRGB((u8)h, (u8)s, (u8)v, &r1, &g1, &b1);
+                divideHSVToRGB((u8)h, (u8)s, (u8)v, &r2, &g2, &b2);
+                TEST_EQ(r1, r2);
+                TEST_EQ(g1, g2);
+                TEST_EQ(b1, b2);
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int batchMatchesOneAtATime(void)
+{
+    /* A whole plane of hue and value at a time, plus some left over */
+    static u8 hsv[(256 * 256 + 5) * 3];
+    static u32 dst[256 * 256 + 5];
+    unsigned int s;
+    unsigned int i;
+
+    for (s = 0; s < 256; ++s)
+    {
+        for (i = 0; i < 256 * 256 + 5; ++i)
+        {
+            hsv[i * 3] = (u8)(i >> 8);
+            hsv[i * 3 + 1] = (u8)s;
+            hsv[i * 3 + 2] = (u8)i;
+        }
+
+        hsvToXRGB8888(dst, hsv, 256 * 256 + 5);
+
+        for (i = 0; i < 256 * 256 + 5; ++i)
+        {
+            u8 r, g, b;
+
+            hsvToRGB(hsv[i * 3], hsv[i * 3 + 1], hsv[i * 3 + 2], &r, &g, &b);
+            TEST_EQX(dst[i], (u32)r << 16 | (u32)g << 8 | b);
+        }
+    }
+
+    return 0;
+}
+
+const test_fn tests[] =
+{
+    matchesDividing,
+    batchMatchesOneAtATime,
+    0
+};
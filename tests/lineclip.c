@@ -0,0 +1,231 @@
+/*
+ *  lineclip.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "lineclip.h"
+#include "guikit/primrect.h"
+#include "ptest/test.h"
+
+/* The error term of a run-sliced line, before its first full run, as
+ * drawLine() in raster.c sets it up */
+struct Runs
+{
+    int minRunLen;
+    int adjUp;
+    int adjDown;
+    int errorAdj;
+};
+
+static void initRuns(struct Runs *runs, int majorDelta, int delta)
+{
+    runs->minRunLen = majorDelta / delta;
+    runs->errorAdj = majorDelta % delta;
+    runs->adjUp = runs->errorAdj + runs->errorAdj;
+    runs->adjDown = delta + delta;
+    runs->errorAdj -= runs->adjDown;
+    if (runs->minRunLen & 1)
+    {
+        runs->errorAdj += delta;
+    }
+}
+
+/* Take count full runs one at a time, like the run loop does. */
+static int stepRuns(struct Runs *runs, int count)
+{
+    int pixels = 0;
+
+    while (count--)
+    {
+        pixels += runs->minRunLen;
+        runs->errorAdj += runs->adjUp;
+        if (runs->errorAdj > 0)
+        {
+            ++pixels;
+            runs->errorAdj -= runs->adjDown;
+        }
+    }
+
+    return pixels;
+}
+
+static int checkSkip(int majorDelta, int delta, int count)
+{
+    struct Runs stepped;
+    struct Runs skipped;
+    int pixels;
+
+    initRuns(&stepped, majorDelta, delta);
+    skipped = stepped;
+
+    pixels = skipLineRuns(count, skipped.minRunLen, skipped.adjUp,
+                          skipped.adjDown, &skipped.errorAdj);
+    TEST_EQ(pixels, stepRuns(&stepped, count));
+    TEST_EQ(skipped.errorAdj, stepped.errorAdj);
+
+    return 0;
+}
+
+static int skipMatchesStepping(void)
+{
+    int majorDelta;
+    int delta;
+    int count;
+    int ret;
+
+    for (delta = 1; delta < 40; ++delta)
+    {
+        for (majorDelta = delta + 1; majorDelta < 130; ++majorDelta)
+        {
+            for (count = 0; count < delta; ++count)
+            {
+                ret = checkSkip(majorDelta, delta, count);
+                if (ret)
+                {
+                    return ret;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int skipLongLines(void)
+{
+    static const int counts[] = {1, 2, 3, 999, 65536, 99999};
+    static const int deltas[][2] = {
+        {100003, 100000},
+        {300007, 100003},
+        {2000000, 100001},
+        {1999999999, 999999937},
+        {1000000000, 3}
+    };
+    size_t i;
+    size_t j;
+    int ret;
+
+    for (i = 0; i < sizeof(deltas) / sizeof(deltas[0]); ++i)
+    {
+        for (j = 0; j < sizeof(counts) / sizeof(counts[0]); ++j)
+        {
+            if (counts[j] >= deltas[i][1])
+            {
+                continue;
+            }
+            ret = checkSkip(deltas[i][0], deltas[i][1], counts[j]);
+            if (ret)
+            {
+                return ret;
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int wholeLineWithinClip(void)
+{
+    struct Rect clip;
+    int first;
+    int last;
+
+    InitRect(&clip, 0, 0, 640, 480);
+
+    TEST_TRUE(clipLineRuns(&clip, 10, 10, 1, 100, 30, &first, &last));
+    TEST_EQ(first, 0);
+    TEST_EQ(last, 30);
+
+    TEST_TRUE(clipLineRuns(&clip, 200, 10, -1, 20, 300, &first, &last));
+    TEST_EQ(first, 0);
+    TEST_EQ(last, 20);
+
+    return 0;
+}
+
+static int lineMissesClip(void)
+{
+    struct Rect clip;
+    int first;
+    int last;
+
+    InitRect(&clip, 100, 100, 50, 50);
+
+    /* Above, below, and to either side */
+    TEST_FALSE(clipLineRuns(&clip, 0, 0, 1, 300, 50, &first, &last));
+    TEST_FALSE(clipLineRuns(&clip, 0, 160, 1, 300, 50, &first, &last));
+    TEST_FALSE(clipLineRuns(&clip, 0, 0, 1, 50, 300, &first, &last));
+    TEST_FALSE(clipLineRuns(&clip, 300, 0, -1, 50, 300, &first, &last));
+
+    /* Passing by a corner */
+    TEST_FALSE(clipLineRuns(&clip, 0, 50, 1, 1000, 40, &first, &last));
+
+    return 0;
+}
+
+static int minorAxisClipsExactly(void)
+{
+    struct Rect clip;
+    int first;
+    int last;
+
+    /* X-major, so one run per row */
+    InitRect(&clip, -1000, 3, 2000, 3);
+    TEST_TRUE(clipLineRuns(&clip, 0, 0, 1, 100, 10, &first, &last));
+    TEST_EQ(first, 3);
+    TEST_EQ(last, 5);
+
+    /* Y-major, so one run per column */
+    InitRect(&clip, 4, -1000, 3, 2000);
+    TEST_TRUE(clipLineRuns(&clip, 0, 0, 1, 10, 100, &first, &last));
+    TEST_EQ(first, 4);
+    TEST_EQ(last, 6);
+
+    /* Going right to left, runs count from the right. */
+    TEST_TRUE(clipLineRuns(&clip, 10, 0, -1, 10, 100, &first, &last));
+    TEST_EQ(first, 4);
+    TEST_EQ(last, 6);
+
+    return 0;
+}
+
+static int majorAxisKeepsNeighbours(void)
+{
+    struct Rect clip;
+    int first;
+    int last;
+
+    /* X-major, with runs 10 pixels long. Run i is around x = 10i, so x = 50
+     * to 59 is mostly runs 5 and 6, but could be run 4 or 7 at a stretch. */
+    InitRect(&clip, 50, -1000, 10, 2000);
+    TEST_TRUE(clipLineRuns(&clip, 0, 0, 1, 1000, 100, &first, &last));
+    TEST_GE(first, 4);
+    TEST_LE(first, 5);
+    TEST_GE(last, 6);
+    TEST_LE(last, 7);
+
+    /* Far from the start of a long line */
+    InitRect(&clip, 0, 0, 640, 480);
+    TEST_TRUE(clipLineRuns(&clip, -1000000, 200, 1, 2000000, 100, &first,
+                           &last));
+    TEST_GE(first, 49);
+    TEST_LE(first, 50);
+    TEST_GE(last, 50);
+    TEST_LE(last, 51);
+
+    return 0;
+}
+
+const test_fn tests[] =
+{
+    skipMatchesStepping,
+    skipLongLines,
+    wholeLineWithinClip,
+    lineMissesClip,
+    minorAxisClipsExactly,
+    majorAxisKeepsNeighbours,
+    0
+};
@@ -0,0 +1,143 @@
+/*
+ *  mode.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "guikit/graphics.h"
+#include "guikit/primrect.h"
+#include "guikit/ptypes.h"
+#include "ptest/test.h"
+#include <stddef.h>
+
+static void initMode(struct GraphicsMode *mode, int width, int height,
+                     int format)
+{
+    mode->width = width;
+    mode->height = height;
+    mode->format = format;
+    mode->title = NULL;
+    mode->flags = 0;
+}
+
+static int rejectsBadModes(void)
+{
+    struct GraphicsMode mode;
+
+    initMode(&mode, 0, 480, PIXEL_FORMAT_INDEX8);
+    TEST_NE(InitGraphicsEx(&mode), 0);
+
+    initMode(&mode, 640, -1, PIXEL_FORMAT_INDEX8);
+    TEST_NE(InitGraphicsEx(&mode), 0);
+
+    initMode(&mode, 640, 480, NUM_PIXEL_FORMATS);
+    TEST_NE(InitGraphicsEx(&mode), 0);
+
+    return 0;
+}
+
+static int drawsAtAnySize(void)
+{
+    struct GraphicsMode mode;
+    struct Rect rect;
+    u8 *pixels;
+    int pitch;
+    int format;
+
+    initMode(&mode, 1920, 1080, PIXEL_FORMAT_INDEX8);
+    TEST_EQ(InitGraphicsEx(&mode), 0);
+    TEST_EQ(GetScreenWidth(), 1920);
+    TEST_EQ(GetScreenHeight(), 1080);
+
+    pixels = GetFrameBuffer(&pitch, &format);
+    TEST_NEP(pixels, NULL);
+    TEST_GE(pitch, 1920);
+    TEST_EQ(format, PIXEL_FORMAT_INDEX8);
+
+    /* Hang off the bottom right, to be clipped there rather than at VGA's
+     * edges. */
+    SetColor(COLOR_RED);
+    InitRect(&rect, 1900, 1070, 40, 40);
+    FillRect(&rect);
+
+    TEST_EQ(pixels[1069 * pitch + 1919], COLOR_WHITE);
+    TEST_EQ(pixels[1070 * pitch + 1899], COLOR_WHITE);
+    TEST_EQ(pixels[1070 * pitch + 1900], COLOR_RED);
+    TEST_EQ(pixels[1079 * pitch + 1919], COLOR_RED);
+
+    FreeGraphics();
+
+    return 0;
+}
+
+static int drawsInBGR555(void)
+{
+    struct GraphicsMode mode;
+    u8 *pixels;
+    int pitch;
+    int format;
+
+    initMode(&mode, 800, 600, PIXEL_FORMAT_BGR555);
+    TEST_EQ(InitGraphicsEx(&mode), 0);
+
+    pixels = GetFrameBuffer(&pitch, &format);
+    TEST_GE(pitch, 800 * 2);
+    TEST_EQ(format, PIXEL_FORMAT_BGR555);
+
+    SetColorRGB(0xF8, 0x00, 0x00);
+    DrawHorizLine(0, 599, 800);
+
+    TEST_EQX(((u16 *)&pixels[599 * pitch])[0], 0x001F);
+    TEST_EQX(((u16 *)&pixels[599 * pitch])[799], 0x001F);
+    TEST_EQX(((u16 *)&pixels[598 * pitch])[799], 0x7FFF);
+
+    FreeGraphics();
+
+    return 0;
+}
+
+static int drawsInXRGB8888(void)
+{
+    struct GraphicsMode mode;
+    u8 *pixels;
+    int pitch;
+    int format;
+
+    initMode(&mode, 1024, 768, PIXEL_FORMAT_XRGB8888);
+    TEST_EQ(InitGraphicsEx(&mode), 0);
+
+    pixels = GetFrameBuffer(&pitch, &format);
+    TEST_GE(pitch, 1024 * 4);
+    TEST_EQ(format, PIXEL_FORMAT_XRGB8888);
+
+    /* Colors come through without losing any bits. */
+    SetColorRGB(0x12, 0x34, 0x56);
+    DrawVertLine(1023, 0, 768);
+    SetColor(COLOR_ORANGE);
+    DrawHorizLine(0, 0, 4);
+
+    TEST_EQX(((u32 *)&pixels[0])[1023], 0x123456);
+    TEST_EQX(((u32 *)&pixels[767 * pitch])[1023], 0x123456);
+    TEST_EQX(((u32 *)&pixels[767 * pitch])[1022], 0xFFFFFF);
+    TEST_EQX(((u32 *)&pixels[0])[3], 0xFF6402);
+
+    /* Colors past the COLOR_* colors wrap around, as on indexed screens. */
+    SetColor(COLOR_ORANGE + 16);
+    DrawHorizLine(0, 1, 4);
+    TEST_EQX(((u32 *)&pixels[pitch])[3], 0xFF6402);
+
+    FreeGraphics();
+
+    return 0;
+}
+
+const test_fn tests[] =
+{
+    rejectsBadModes,
+    drawsAtAnySize,
+    drawsInBGR555,
+    drawsInXRGB8888,
+    0
+};
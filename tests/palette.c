@@ -0,0 +1,169 @@
+/*
+ *  palette.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "guikit/graphics.h"
+#include "guikit/pmemory.h"
+#include "guikit/primrect.h"
+#include "ptest/test.h"
+#include "screen.h"
+#include <stddef.h>
+#include <string.h>
+
+enum {
+    WIDTH = 40,
+    HEIGHT = 30
+};
+
+static void setRGB(struct RGB *c, u8 r, u8 g, u8 b)
+{
+    c->r = r;
+    c->g = g;
+    c->b = b;
+}
+
+static int changesColorsNotPixels(void)
+{
+    struct RGB colors[3];
+    struct RGB got[3];
+    struct Rect rect;
+    unsigned char *pixels;
+    unsigned char *before;
+    int i;
+
+    pixels = initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_INDEX8);
+    for (i = 0; i < NUM_COLORS; ++i)
+    {
+        SetColor(i);
+        InitRect(&rect, i * 2, 0, 2, HEIGHT);
+        FillRect(&rect);
+    }
+    before = copyScreen(pixels);
+
+    setRGB(&colors[0], 0x10, 0x20, 0x30);
+    setRGB(&colors[1], 0x40, 0x50, 0x60);
+    setRGB(&colors[2], 0x70, 0x80, 0x90);
+    TEST_EQ(SetPaletteEntries(COLOR_RED, 3, colors), 0);
+    ShowGraphics();
+
+    TEST_EQ(memcmp(pixels, before, screenSize), 0);
+    TEST_EQ(GetPaletteEntries(COLOR_RED, 3, got), 0);
+    TEST_EQ(memcmp(got, colors, sizeof(colors)), 0);
+
+    /* Entries past the COLOR_* ones can be used too. */
+    TEST_EQ(SetPaletteEntries(PALETTE_SIZE - 1, 1, colors), 0);
+    TEST_EQ(GetPaletteEntries(PALETTE_SIZE - 1, 1, got), 0);
+    TEST_EQ(memcmp(got, colors, sizeof(colors[0])), 0);
+
+    pfree(before);
+    FreeGraphics();
+
+    return 0;
+}
+
+static int rotatesBothWays(void)
+{
+    struct RGB colors[5];
+    struct RGB got[5];
+    int i;
+
+    initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_INDEX8);
+    for (i = 0; i < 5; ++i)
+    {
+        setRGB(&colors[i], (u8)i, (u8)(i * 2), (u8)(i * 3));
+    }
+    TEST_EQ(SetPaletteEntries(20, 5, colors), 0);
+
+    /* Each entry moves 2 along, and the last 2 wrap around to the start. */
+    TEST_EQ(RotatePalette(20, 5, 2), 0);
+    TEST_EQ(GetPaletteEntries(20, 5, got), 0);
+    for (i = 0; i < 5; ++i)
+    {
+        TEST_EQ(got[(i + 2) % 5].r, colors[i].r);
+        TEST_EQ(got[(i + 2) % 5].b, colors[i].b);
+    }
+
+    /* Going back, including by more than a whole turn, undoes it. */
+    TEST_EQ(RotatePalette(20, 5, -7), 0);
+    TEST_EQ(GetPaletteEntries(20, 5, got), 0);
+    TEST_EQ(memcmp(got, colors, sizeof(colors)), 0);
+
+    /* Entries around it are left alone. */
+    TEST_EQ(GetPaletteEntries(19, 1, got), 0);
+    TEST_EQ(GetPaletteEntries(25, 1, &got[1]), 0);
+    TEST_EQ(RotatePalette(20, 0, 3), 0);
+
+    FreeGraphics();
+
+    return 0;
+}
+
+static int penFollowsPalette(void)
+{
+    struct RGB red;
+    unsigned char *pixels;
+    struct Rect rect;
+
+    pixels = initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_INDEX8);
+    InitRect(&rect, 0, 0, 1, 1);
+
+    /* Pure red is nearest to COLOR_RED, until something nearer comes
+     * along. */
+    SetColorHSV(0, 0xFF, 0xFF);
+    FillRect(&rect);
+    TEST_EQ(pixels[0], COLOR_RED);
+
+    setRGB(&red, 0xFF, 0, 0);
+    TEST_EQ(SetPaletteEntries(COLOR_PINK, 1, &red), 0);
+    SetColorHSV(0, 0xFF, 0xFF);
+    FillRect(&rect);
+    TEST_EQ(pixels[0], COLOR_PINK);
+    SetColorRGB(0xFF, 0, 0);
+    FillRect(&rect);
+    TEST_EQ(pixels[0], COLOR_PINK);
+
+    /* COLOR_* values are entries, whatever color they are now. */
+    SetColor(COLOR_BLUE);
+    FillRect(&rect);
+    TEST_EQ(pixels[0], COLOR_BLUE);
+
+    FreeGraphics();
+
+    return 0;
+}
+
+static int refusesBadEntries(void)
+{
+    struct RGB colors[2];
+
+    memset(colors, 0, sizeof(colors));
+
+    initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_INDEX8);
+    TEST_NE(SetPaletteEntries(-1, 2, colors), 0);
+    TEST_NE(SetPaletteEntries(PALETTE_SIZE - 1, 2, colors), 0);
+    TEST_NE(GetPaletteEntries(0, -1, colors), 0);
+    TEST_NE(RotatePalette(PALETTE_SIZE, 1, 1), 0);
+    FreeGraphics();
+
+    /* Only indexed screens have a palette. */
+    initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_BGR555);
+    TEST_NE(SetPaletteEntries(0, 1, colors), 0);
+    TEST_NE(GetPaletteEntries(0, 1, colors), 0);
+    TEST_NE(RotatePalette(0, 2, 1), 0);
+    FreeGraphics();
+
+    return 0;
+}
+
+const test_fn tests[] =
+{
+    changesColorsNotPixels,
+    rotatesBothWays,
+    penFollowsPalette,
+    refusesBadEntries,
+    0
+};
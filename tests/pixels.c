@@ -0,0 +1,309 @@
+/*
+ *  pixels.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "guikit/dlist.h"
+#include "guikit/graphics.h"
+#include "guikit/pmemory.h"
+#include "guikit/primrect.h"
+#include "guikit/ptypes.h"
+#include "ptest/test.h"
+#include "screen.h"
+#include <stddef.h>
+#include <string.h>
+
+enum {
+    WIDTH = 64,
+    HEIGHT = 48
+};
+
+static unsigned char src[HEIGHT][WIDTH];
+
+static void fillSource(int mod)
+{
+    int x;
+    int y;
+
+    for (y = 0; y < HEIGHT; ++y)
+    {
+        for (x = 0; x < WIDTH; ++x)
+        {
+            src[y][x] = (unsigned char)((x * 7 + y * 3) % mod);
+        }
+    }
+}
+
+/* Draw the part of src at dst pixel by pixel, like apps used to. */
+static void drawSlowly(const struct Rect *dst, int hsv)
+{
+    struct Rect rect;
+    int x;
+    int y;
+
+    for (y = dst->top; y <= dst->bottom; ++y)
+    {
+        for (x = dst->left; x <= dst->right; ++x)
+        {
+            int p = src[y - dst->top][x - dst->left];
+
+            if (hsv)
+            {
+                SetColorHSV((unsigned char)p, 255, 255);
+            }
+            else
+            {
+                SetColor(p);
+            }
+            InitRect(&rect, x, y, 1, 1);
+            FillRect(&rect);
+        }
+    }
+}
+
+static int matchesPenColors(int format, int srcFormat)
+{
+    unsigned char *pixels;
+    unsigned char *expected;
+    struct Rect dst;
+
+    fillSource(srcFormat == PIXEL_FORMAT_HSV8 ? 256 : NUM_COLORS);
+
+    pixels = initScreen(WIDTH, HEIGHT, format);
+    clearScreen();
+    InitRect(&dst, 3, 5, 50, 30);
+    drawSlowly(&dst, srcFormat == PIXEL_FORMAT_HSV8);
+    expected = copyScreen(pixels);
+
+    SetColor(COLOR_WHITE);
+    FillScreen();
+    TEST_EQ(DrawPixelArray(&dst, src, WIDTH, srcFormat), 0);
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+
+    pfree(expected);
+    FreeGraphics();
+
+    return 0;
+}
+
+static int hsvMatchesSetColorHSV(void)
+{
+    int format;
+
+    for (format = 0; format < NUM_PIXEL_FORMATS; ++format)
+    {
+        TEST_EQ(matchesPenColors(format, PIXEL_FORMAT_HSV8), 0);
+    }
+
+    return 0;
+}
+
+static int indexedMatchesSetColor(void)
+{
+    int format;
+
+    for (format = 0; format < NUM_PIXEL_FORMATS; ++format)
+    {
+        TEST_EQ(matchesPenColors(format, PIXEL_FORMAT_INDEX8), 0);
+    }
+
+    return 0;
+}
+
+static int copiesAndClips(void)
+{
+    unsigned char *pixels;
+    unsigned char *expected;
+    struct Rect dst;
+    int y;
+
+    fillSource(NUM_COLORS);
+    pixels = initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_INDEX8);
+    clearScreen();
+
+    /* Hanging off the top left, only the bottom right of src shows. */
+    InitRect(&dst, -10, -20, WIDTH, HEIGHT);
+    TEST_EQ(DrawPixelArray(&dst, src, WIDTH, PIXEL_FORMAT_INDEX8), 0);
+
+    expected = pmalloc(screenSize);
+    memset(expected, COLOR_WHITE, screenSize);
+    for (y = 0; y < HEIGHT - 20; ++y)
+    {
+        memcpy(&expected[y * screenPitch], &src[y + 20][10], WIDTH - 10);
+    }
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+
+    /* Entirely off screen, and inside out */
+    InitRect(&dst, WIDTH, 0, 10, 10);
+    TEST_EQ(DrawPixelArray(&dst, src, WIDTH, PIXEL_FORMAT_INDEX8), 0);
+    InitRect(&dst, 10, 10, -5, 10);
+    TEST_EQ(DrawPixelArray(&dst, src, WIDTH, PIXEL_FORMAT_INDEX8), 0);
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+
+    TEST_NE(DrawPixelArray(&dst, src, WIDTH, PIXEL_FORMAT_HSV8 + 1), 0);
+
+    pfree(expected);
+    FreeGraphics();
+
+    return 0;
+}
+
+static int convertsBetweenRGBFormats(void)
+{
+    static u16 wide[HEIGHT][WIDTH];
+    u32 *pixels;
+    struct Rect dst;
+    int x;
+    int y;
+
+    /* BGR555 pure red, green, blue, and white */
+    for (y = 0; y < HEIGHT; ++y)
+    {
+        for (x = 0; x < WIDTH; ++x)
+        {
+            static const u16 colors[] = {0x001F, 0x03E0, 0x7C00, 0x7FFF};
+
+            wide[y][x] = colors[(x + y) % 4];
+        }
+    }
+
+    pixels = (u32 *)initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_XRGB8888);
+    clearScreen();
+    InitRect(&dst, 0, 0, WIDTH, HEIGHT);
+    TEST_EQ(DrawPixelArray(&dst, wide, sizeof(wide[0]), PIXEL_FORMAT_BGR555),
+            0);
+
+    TEST_EQX(pixels[0], 0xFF0000);
+    TEST_EQX(pixels[1], 0x00FF00);
+    TEST_EQX(pixels[2], 0x0000FF);
+    TEST_EQX(pixels[3], 0xFFFFFF);
+    TEST_EQX(pixels[screenPitch / 4], 0x00FF00);
+
+    FreeGraphics();
+
+    return 0;
+}
+
+static int recordsPixelArrays(void)
+{
+    struct DisplayList *list;
+    unsigned char *pixels;
+    unsigned char *expected;
+    struct Rect dst;
+
+    fillSource(256);
+    pixels = initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_BGR555);
+    clearScreen();
+    InitRect(&dst, 0, 0, WIDTH, HEIGHT);
+    DrawPixelArray(&dst, src, WIDTH, PIXEL_FORMAT_HSV8);
+    expected = copyScreen(pixels);
+
+    SetColor(COLOR_WHITE);
+    FillScreen();
+    list = NewDisplayList();
+    BeginDisplayList(list);
+    DrawPixelArray(&dst, src, WIDTH, PIXEL_FORMAT_HSV8);
+    EndDisplayList();
+    TEST_EQ(pixels[0], 0xFF);
+
+    ExecuteDisplayList(list);
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+
+    FreeDisplayList(list);
+    pfree(expected);
+    FreeGraphics();
+
+    return 0;
+}
+
+static u32 readPixel(const unsigned char *pixels, int format)
+{
+    u16 p16;
+    u32 p32;
+
+    switch (format)
+    {
+    case PIXEL_FORMAT_INDEX8:
+        return pixels[0];
+    case PIXEL_FORMAT_BGR555:
+        memcpy(&p16, pixels, sizeof(p16));
+        return p16;
+    default:
+        memcpy(&p32, pixels, sizeof(p32));
+        return p32;
+    }
+}
+
+/* Draw the first pixel with the pen, and see what it came out as. */
+static u32 penPixel(const unsigned char *pixels, int format)
+{
+    struct Rect rect;
+
+    InitRect(&rect, 0, 0, 1, 1);
+    FillRect(&rect);
+
+    return readPixel(pixels, format);
+}
+
+static int surfaceColorsMatchSetColorHSV(void)
+{
+    enum {
+        NUM_HSV = 6 * 6 * 256,
+        BRIGHT = 5 * 6 * 256 + 5 * 256 /* Saturation and value both 255 */
+    };
+    static const unsigned char levels[] = {0, 1, 80, 128, 254, 255};
+    static u8 hsv[NUM_HSV * 3];
+    static u32 out[NUM_HSV];
+    unsigned char *pixels;
+    int format;
+    int i;
+
+    for (i = 0; i < NUM_HSV; ++i)
+    {
+        hsv[i * 3] = (u8)i;
+        hsv[i * 3 + 1] = levels[(i / 256) % 6];
+        hsv[i * 3 + 2] = levels[(i / (256 * 6)) % 6];
+    }
+
+    /* The pen colors depend on the format, so go through them all. */
+    for (format = 0; format < NUM_PIXEL_FORMATS; ++format)
+    {
+        pixels = initScreen(WIDTH, HEIGHT, format);
+        clearScreen();
+        HSVToSurfaceColors(hsv, out, NUM_HSV);
+
+        for (i = 0; i < NUM_HSV; ++i)
+        {
+            SetColorHSV(hsv[i * 3], hsv[i * 3 + 1], hsv[i * 3 + 2]);
+            TEST_EQX(penPixel(pixels, format), out[i]);
+        }
+
+        /* The primaries, going around the color wheel */
+        SetColorRGB(0xFF, 0, 0);
+        TEST_EQX(penPixel(pixels, format), out[BRIGHT]);
+        SetColorHSV(0, 0xFF, 0xFF);
+        TEST_EQX(penPixel(pixels, format), out[BRIGHT]);
+        SetColorRGB(0, 0xFF, 0);
+        TEST_EQX(penPixel(pixels, format), out[BRIGHT + 86]);
+        SetColorRGB(0, 0, 0xFF);
+        TEST_EQX(penPixel(pixels, format), out[BRIGHT + 172]);
+
+        FreeGraphics();
+    }
+
+    return 0;
+}
+
+const test_fn tests[] =
+{
+    hsvMatchesSetColorHSV,
+    indexedMatchesSetColor,
+    copiesAndClips,
+    convertsBetweenRGBFormats,
+    recordsPixelArrays,
+    surfaceColorsMatchSetColorHSV,
+    0
+};
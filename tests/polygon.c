@@ -0,0 +1,334 @@
+/*
+ *  polygon.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "guikit/damage.h"
+#include "guikit/dlist.h"
+#include "guikit/graphics.h"
+#include "guikit/pmemory.h"
+#include "guikit/primrect.h"
+#include "ptest/test.h"
+#include "screen.h"
+#include <stddef.h>
+#include <string.h>
+
+enum {
+    WIDTH = 160,
+    HEIGHT = 120,
+    MAX_POINTS = 12
+};
+
+/* A pentagram, which has a hole in the middle by the even-odd rule but not
+ * by the nonzero one */
+static const int star[] = {
+    80, 5, 115, 110, 20, 40, 140, 40, 45, 110
+};
+
+/* Work out by brute force whether the center of pixel (x, y) is inside,
+ * counting the edges on or to the left of it. */
+static int isInside(const int *xy, size_t n, int rule, int x, int y)
+{
+    double px = x + 0.5;
+    double py = y + 0.5;
+    int count = 0;
+    size_t i;
+
+    for (i = 0; i < n; ++i)
+    {
+        const int *p = &xy[i * 2];
+        const int *q = &xy[(i + 1) % n * 2];
+        double cross;
+
+        if ((p[1] < py) == (q[1] < py))
+        {
+            continue;
+        }
+
+        cross = p[0] + (py - p[1]) * (q[0] - p[0]) / (q[1] - p[1]);
+        if (cross <= px)
+        {
+            count += rule == FILL_NONZERO && p[1] > q[1] ? -1 : 1;
+        }
+    }
+
+    return rule == FILL_NONZERO ? count != 0 : count & 1;
+}
+
+static int matchesBruteForce(const unsigned char *pixels, const int *xy,
+                             size_t n, int rule)
+{
+    int x;
+    int y;
+
+    for (y = 0; y < HEIGHT; ++y)
+    {
+        for (x = 0; x < WIDTH; ++x)
+        {
+            int inside = isInside(xy, n, rule, x, y);
+
+            TEST_EQ(pixels[y * screenPitch + x],
+                    inside ? COLOR_BLACK : COLOR_WHITE);
+        }
+    }
+
+    return 0;
+}
+
+static int rectPolygonMatchesFillRect(void)
+{
+    static const int corners[] = {
+        -10, 30, 100, 30, 100, 200, -10, 200
+    };
+    unsigned char *pixels;
+    unsigned char *expected;
+    struct Rect rect;
+
+    pixels = initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_INDEX8);
+    clearScreen();
+    InitRect(&rect, -10, 30, 110, 170);
+    FillRect(&rect);
+    expected = copyScreen(pixels);
+
+    clearScreen();
+    FillPolygon(corners, 4, FILL_EVEN_ODD);
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+
+    clearScreen();
+    FillPolygon(corners, 4, FILL_NONZERO);
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+
+    pfree(expected);
+    FreeGraphics();
+
+    return 0;
+}
+
+static int starFollowsRule(void)
+{
+    unsigned char *pixels;
+    int ret;
+
+    pixels = initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_INDEX8);
+
+    clearScreen();
+    FillPolygon(star, 5, FILL_EVEN_ODD);
+    ret = matchesBruteForce(pixels, star, 5, FILL_EVEN_ODD);
+    if (ret)
+    {
+        return ret;
+    }
+    TEST_EQ(pixels[60 * screenPitch + 80], COLOR_WHITE);
+
+    clearScreen();
+    FillPolygon(star, 5, FILL_NONZERO);
+    ret = matchesBruteForce(pixels, star, 5, FILL_NONZERO);
+    if (ret)
+    {
+        return ret;
+    }
+    TEST_EQ(pixels[60 * screenPitch + 80], COLOR_BLACK);
+
+    FreeGraphics();
+
+    return 0;
+}
+
+static int randomPolygonsMatchBruteForce(void)
+{
+    unsigned char *pixels;
+    int xy[MAX_POINTS * 2];
+    size_t n;
+    size_t j;
+    int ret;
+    int i;
+
+    pixels = initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_INDEX8);
+
+    /* Crossing themselves, running off the screen, and with horizontal
+     * edges and shared points */
+    for (i = 0; i < 200; ++i)
+    {
+        int rule = i % 2 ? FILL_NONZERO : FILL_EVEN_ODD;
+
+        n = (size_t)randomIn(3, MAX_POINTS);
+        for (j = 0; j < n; ++j)
+        {
+            xy[j * 2] = randomIn(-20, WIDTH + 20);
+            xy[j * 2 + 1] = randomIn(-20, HEIGHT + 20);
+            if (j && i % 5 == 0)
+            {
+                xy[j * 2 + 1] = xy[j * 2 - 1];
+            }
+        }
+
+        clearScreen();
+        FillPolygon(xy, n, rule);
+        ret = matchesBruteForce(pixels, xy, n, rule);
+        if (ret)
+        {
+            return ret;
+        }
+    }
+
+    FreeGraphics();
+
+    return 0;
+}
+
+static int farAwayPointsStayExact(void)
+{
+    /* A sliver from far above the screen to far below, and a triangle with
+     * the screen somewhere in the middle of it */
+    static const int sliver[] = {
+        -3000000, -2000000, 3000007, 2000001, 3000011, 2000003
+    };
+    static const int huge[] = {
+        -4000000, -5000000, 6000000, 700, -900, 3000000
+    };
+    unsigned char *pixels;
+    int ret;
+
+    pixels = initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_INDEX8);
+
+    clearScreen();
+    FillPolygon(sliver, 3, FILL_NONZERO);
+    ret = matchesBruteForce(pixels, sliver, 3, FILL_NONZERO);
+    if (ret)
+    {
+        return ret;
+    }
+
+    clearScreen();
+    FillPolygon(huge, 3, FILL_EVEN_ODD);
+    ret = matchesBruteForce(pixels, huge, 3, FILL_EVEN_ODD);
+    if (ret)
+    {
+        return ret;
+    }
+
+    FreeGraphics();
+
+    return 0;
+}
+
+static int emptyPolygonsDrawNothing(void)
+{
+    static const int line[] = {10, 10, 50, 50, 90, 90};
+    static const int flat[] = {10, 10, 50, 10, 90, 10};
+    unsigned char *pixels;
+    unsigned char *expected;
+    size_t num;
+
+    pixels = initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_INDEX8);
+    clearScreen();
+    ClearDamage();
+    expected = copyScreen(pixels);
+
+    FillPolygon(star, 0, FILL_EVEN_ODD);
+    FillPolygon(star, 2, FILL_EVEN_ODD);
+    FillPolygon(flat, 3, FILL_NONZERO);
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+    GetDamage(&num);
+    TEST_EQU(num, 0);
+
+    /* A polygon with no area covers no pixel centers. */
+    FillPolygon(line, 3, FILL_NONZERO);
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+
+    pfree(expected);
+    FreeGraphics();
+
+    return 0;
+}
+
+static int damageCoversPolygon(void)
+{
+    const struct Rect *damage;
+    size_t num;
+
+    initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_INDEX8);
+    clearScreen();
+    ClearDamage();
+
+    FillPolygon(star, 5, FILL_EVEN_ODD);
+    damage = GetDamage(&num);
+    TEST_EQU(num, 1);
+    TEST_EQ(damage[0].left, 20);
+    TEST_EQ(damage[0].top, 5);
+    TEST_EQ(damage[0].right, 139);
+    TEST_EQ(damage[0].bottom, 109);
+
+    FreeGraphics();
+
+    return 0;
+}
+
+static int clippedAndRecordedPolygons(void)
+{
+    struct DisplayList *list;
+    unsigned char *pixels;
+    unsigned char *expected;
+    struct Rect clip;
+    int x;
+    int y;
+
+    pixels = initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_INDEX8);
+    InitRect(&clip, 30, 20, 70, 50);
+
+    clearScreen();
+    PushClipRect(&clip);
+    FillPolygon(star, 5, FILL_NONZERO);
+    PopClipRect();
+    for (y = 0; y < HEIGHT; ++y)
+    {
+        for (x = 0; x < WIDTH; ++x)
+        {
+            int inside = x >= clip.left && x <= clip.right &&
+                         y >= clip.top && y <= clip.bottom &&
+                         isInside(star, 5, FILL_NONZERO, x, y);
+
+            TEST_EQ(pixels[y * screenPitch + x],
+                    inside ? COLOR_BLACK : COLOR_WHITE);
+        }
+    }
+    expected = copyScreen(pixels);
+
+    list = NewDisplayList();
+    BeginDisplayList(list);
+    PushClipRect(&clip);
+    FillPolygon(star, 5, FILL_NONZERO);
+    PopClipRect();
+    EndDisplayList();
+
+    clearScreen();
+    ExecuteDisplayList(list);
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+
+    clearScreen();
+    SetRenderThreads(4);
+    ExecuteDisplayList(list);
+    SetRenderThreads(1);
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+
+    FreeDisplayList(list);
+    pfree(expected);
+    FreeGraphics();
+
+    return 0;
+}
+
+const test_fn tests[] =
+{
+    rectPolygonMatchesFillRect,
+    starFollowsRule,
+    randomPolygonsMatchBruteForce,
+    farAwayPointsStayExact,
+    emptyPolygonsDrawNothing,
+    damageCoversPolygon,
+    clippedAndRecordedPolygons,
+    0
+};
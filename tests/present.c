@@ -0,0 +1,91 @@
+/*
+ *  present.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "guikit/present.h"
+#include "ptest/test.h"
+
+static int parsesPolicies(void)
+{
+    int interval;
+
+    TEST_EQ(ParsePresentPolicy("novsync"), 0);
+    TEST_EQ(GetPresentPolicy(&interval), PRESENT_NO_VSYNC);
+    TEST_EQU(interval, 1);
+
+    TEST_EQ(ParsePresentPolicy("never"), 0);
+    TEST_EQ(GetPresentPolicy(&interval), PRESENT_NEVER);
+
+    TEST_EQ(ParsePresentPolicy("vsync:3"), 0);
+    TEST_EQ(GetPresentPolicy(&interval), PRESENT_VSYNC);
+    TEST_EQU(interval, 3);
+
+    return 0;
+}
+
+static int rejectsBadPolicies(void)
+{
+    int interval;
+
+    SetPresentPolicy(PRESENT_NO_VSYNC, 2);
+
+    TEST_NE(ParsePresentPolicy(""), 0);
+    TEST_NE(ParsePresentPolicy("vsyncs"), 0);
+    TEST_NE(ParsePresentPolicy("vsy"), 0);
+    TEST_NE(ParsePresentPolicy("vsync:"), 0);
+    TEST_NE(ParsePresentPolicy("vsync:0"), 0);
+    TEST_NE(ParsePresentPolicy("vsync:2x"), 0);
+    TEST_NE(ParsePresentPolicy("sometimes:2"), 0);
+
+    /* Bad strings leave the policy alone. */
+    TEST_EQ(GetPresentPolicy(&interval), PRESENT_NO_VSYNC);
+    TEST_EQU(interval, 2);
+
+    return 0;
+}
+
+static int presentsEveryNthFrame(void)
+{
+    int presented;
+    int i;
+
+    SetPresentPolicy(PRESENT_NO_VSYNC, 4);
+
+    presented = 0;
+    for (i = 1; i <= 12; ++i)
+    {
+        int show = ShouldPresent();
+
+        TEST_EQU(!!show, i % 4 == 0);
+        presented += !!show;
+    }
+    TEST_EQU(presented, 3);
+
+    return 0;
+}
+
+static int neverPresents(void)
+{
+    int i;
+
+    SetPresentPolicy(PRESENT_NEVER, 1);
+    for (i = 0; i < 10; ++i)
+    {
+        TEST_EQU(ShouldPresent(), 0);
+    }
+
+    return 0;
+}
+
+const test_fn tests[] =
+{
+    parsesPolicies,
+    rejectsBadPolicies,
+    presentsEveryNthFrame,
+    neverPresents,
+    0
+};
@@ -8,6 +8,7 @@
 
 #include "guikit/primrect.h"
 #include "ptest/test.h"
+#include <stddef.h>
 
 static int rectangleIsClippedNW(void)
 {
@@ -591,6 +592,32 @@ int rectUnionWithEmptySecondIsSelf(void)
     return 0;
 }
 
+int rectGrowKeepsLines(void)
+{
+    struct Rect rect;
+    struct Rect line;
+
+    /* A single pixel, then a line one pixel wide, and one pixel tall */
+    InitRect(&rect, 10, 20, 1, 1);
+    InitRect(&line, 30, 5, 1, 10);
+    GrowRect(&rect, &line);
+
+    TEST_EQ(rect.left, 10);
+    TEST_EQ(rect.top, 5);
+    TEST_EQ(rect.right, 30);
+    TEST_EQ(rect.bottom, 20);
+
+    InitRect(&line, -4, 40, 8, 1);
+    GrowRect(&rect, &line);
+
+    TEST_EQ(rect.left, -4);
+    TEST_EQ(rect.top, 5);
+    TEST_EQ(rect.right, 30);
+    TEST_EQ(rect.bottom, 40);
+
+    return 0;
+}
+
 int rectIntersectOverlap(void)
 {
     struct Rect a;
@@ -725,6 +752,99 @@ int rectNormalizedForwardY(void)
     return 0;
 }
 
+static int clipStackIntersectsOnPush(void)
+{
+    struct ClipStack stack;
+    struct Rect bounds;
+    struct Rect rect;
+    const struct Rect *top;
+
+    InitRect(&bounds, 0, 0, 640, 480);
+    InitClipStack(&stack, &bounds);
+
+    InitRect(&rect, -10, 100, 200, 50);
+    top = PushClip(&stack, &rect);
+    TEST_NEP(top, NULL);
+    TEST_EQ(top->left, 0);
+    TEST_EQ(top->top, 100);
+    TEST_EQ(top->right, 189);
+    TEST_EQ(top->bottom, 149);
+
+    /* Nested rects are clipped to all those below them. */
+    InitRect(&rect, 150, 50, 100, 80);
+    top = PushClip(&stack, &rect);
+    TEST_NEP(top, NULL);
+    TEST_EQ(top->left, 150);
+    TEST_EQ(top->top, 100);
+    TEST_EQ(top->right, 189);
+    TEST_EQ(top->bottom, 129);
+
+    top = PopClip(&stack);
+    TEST_NEP(top, NULL);
+    TEST_EQ(top->left, 0);
+    TEST_EQ(top->right, 189);
+
+    top = PopClip(&stack);
+    TEST_NEP(top, NULL);
+    TEST_EQ(top->left, bounds.left);
+    TEST_EQ(top->top, bounds.top);
+    TEST_EQ(top->right, bounds.right);
+    TEST_EQ(top->bottom, bounds.bottom);
+
+    /* The bounds stay put. */
+    top = PopClip(&stack);
+    TEST_EQP(top, NULL);
+
+    return 0;
+}
+
+static int clipStackOffTopRejectsEverything(void)
+{
+    struct ClipStack stack;
+    struct Rect bounds;
+    struct Rect rect;
+    const struct Rect *top;
+    int ret;
+
+    InitRect(&bounds, 0, 0, 640, 480);
+    InitClipStack(&stack, &bounds);
+
+    InitRect(&rect, 700, 10, 20, 20);
+    top = PushClip(&stack, &rect);
+    TEST_NEP(top, NULL);
+
+    rect = bounds;
+    ret = ClipRect(&rect, top);
+    TEST_EQ(ret, CLIP_REJECTED);
+
+    /* Pushing inside an empty clip rect keeps it empty. */
+    InitRect(&rect, 0, 0, 640, 480);
+    top = PushClip(&stack, &rect);
+    TEST_NEP(top, NULL);
+    ret = ClipRect(&rect, top);
+    TEST_EQ(ret, CLIP_REJECTED);
+
+    return 0;
+}
+
+static int clipStackFills(void)
+{
+    struct ClipStack stack;
+    struct Rect bounds;
+    int i;
+
+    InitRect(&bounds, 0, 0, 640, 480);
+    InitClipStack(&stack, &bounds);
+
+    for (i = 1; i < MAX_CLIP_DEPTH; ++i)
+    {
+        TEST_NEP(PushClip(&stack, &bounds), NULL);
+    }
+    TEST_EQP(PushClip(&stack, &bounds), NULL);
+
+    return 0;
+}
+
 const test_fn tests[] =
 {
     rectangleIsClippedNW,
@@ -754,6 +874,7 @@ const test_fn tests[] =
     rectUnionWithEmptySecondIsSelf,
     rectUnionEmptyIsSelf,
     rectUnionWithEmptyFirstIsSelf,
+    rectGrowKeepsLines,
     rectIntersectOverlap,
     rectIntersectNoOverlap,
 
@@ -762,5 +883,9 @@ const test_fn tests[] =
     rectNormalizedReverseY,
     rectNormalizedForwardY,
 
+    clipStackIntersectsOnPush,
+    clipStackOffTopRejectsEverything,
+    clipStackFills,
+
     0
 };
@@ -0,0 +1,64 @@
+/*
+ *  screen.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "screen.h"
+
+#include "guikit/damage.h"
+#include "guikit/graphics.h"
+#include "guikit/pmemory.h"
+#include "guikit/prandom.h"
+#include "guikit/ptypes.h"
+#include <stddef.h>
+#include <string.h>
+
+int screenPitch;
+int screenBpp;
+size_t screenSize;
+
+unsigned char *initScreen(int width, int height, int format)
+{
+    struct GraphicsMode mode;
+    unsigned char *pixels;
+
+    mode.width = width;
+    mode.height = height;
+    mode.format = format;
+    mode.title = NULL;
+    mode.flags = 0;
+    InitGraphicsEx(&mode);
+
+    pixels = GetFrameBuffer(&screenPitch, &format);
+    screenSize = (size_t)screenPitch * height;
+    screenBpp = format == PIXEL_FORMAT_INDEX8 ? 1 :
+                format == PIXEL_FORMAT_BGR555 ? 2 : 4;
+
+    return pixels;
+}
+
+unsigned char *copyScreen(const unsigned char *pixels)
+{
+    unsigned char *copy;
+
+    copy = pmalloc(screenSize);
+    memcpy(copy, pixels, screenSize);
+
+    return copy;
+}
+
+void clearScreen(void)
+{
+    SetColor(COLOR_WHITE);
+    FillScreen();
+    ClearDamage();
+    SetColor(COLOR_BLACK);
+}
+
+int randomIn(int lo, int hi)
+{
+    return (int)RandRange(0, (u32)(hi - lo)) + lo;
+}
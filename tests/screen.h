@@ -0,0 +1,32 @@
+/*
+ *  screen.h
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#ifndef SCREEN_H
+#define SCREEN_H
+
+#include <stddef.h>
+
+/* The screen set up by the last initScreen() */
+extern int screenPitch; /* In bytes */
+extern int screenBpp; /* Bytes per pixel */
+extern size_t screenSize; /* In bytes */
+
+/* Set up a headless screen of width by height pixels in format, returning its
+ * pixels. */
+unsigned char *initScreen(int width, int height, int format);
+
+/* Copy the screen's pixels into a new buffer, for the caller to pfree(). */
+unsigned char *copyScreen(const unsigned char *pixels);
+
+/* Fill the screen with white and forget the damage, leaving the pen black. */
+void clearScreen(void);
+
+/* Return a pseudo-random number from lo to hi. */
+int randomIn(int lo, int hi);
+
+#endif
@@ -0,0 +1,248 @@
+/*
+ *  shade.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "guikit/shade.h"
+#include "guikit/dlist.h"
+#include "guikit/graphics.h"
+#include "guikit/pmemory.h"
+#include "guikit/primrect.h"
+#include "ptest/test.h"
+#include "screen.h"
+#include <stddef.h>
+#include <string.h>
+
+enum {
+    WIDTH = 90,
+    HEIGHT = 70
+};
+
+static unsigned char src[HEIGHT][WIDTH];
+
+static unsigned long hue(int x, int y, void *ctx)
+{
+    const int *t = ctx;
+
+    return (unsigned long)((x * 5 + y * 3 + *t) & 0xFF);
+}
+
+static void hueRow(int x, int y, int width, void *out, void *ctx)
+{
+    unsigned char *row = out;
+    int i;
+
+    for (i = 0; i < width; ++i)
+    {
+        row[i] = (unsigned char)hue(x + i, y, ctx);
+    }
+}
+
+/* Count pixels asked for off screen. There are none to race on. */
+static unsigned long offScreen(int x, int y, void *ctx)
+{
+    int *count = ctx;
+
+    if (x < 0 || y < 0 || x >= WIDTH || y >= HEIGHT)
+    {
+        ++*count;
+    }
+
+    return 0;
+}
+
+static void fillSource(int t)
+{
+    int x;
+    int y;
+
+    for (y = 0; y < HEIGHT; ++y)
+    {
+        for (x = 0; x < WIDTH; ++x)
+        {
+            src[y][x] = (unsigned char)hue(x, y, &t);
+        }
+    }
+}
+
+static int matchesPixelArray(int screenFormat, int threads)
+{
+    struct Rect rect;
+    unsigned char *pixels;
+    unsigned char *expected;
+    int t;
+
+    pixels = initScreen(WIDTH, HEIGHT, screenFormat);
+    clearScreen();
+    t = 17;
+    fillSource(t);
+
+    InitRect(&rect, 0, 0, WIDTH, HEIGHT);
+    TEST_EQ(DrawPixelArray(&rect, src, WIDTH, PIXEL_FORMAT_HSV8), 0);
+    expected = copyScreen(pixels);
+
+    SetRenderThreads(threads);
+
+    SetColor(COLOR_WHITE);
+    FillScreen();
+    TEST_EQ(RenderPerPixel(&rect, PIXEL_FORMAT_HSV8, hue, &t), 0);
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+
+    SetColor(COLOR_WHITE);
+    FillScreen();
+    TEST_EQ(RenderPerRow(&rect, PIXEL_FORMAT_HSV8, hueRow, &t), 0);
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+
+    SetRenderThreads(1);
+    pfree(expected);
+    FreeGraphics();
+
+    return 0;
+}
+
+static int perPixelMatchesPixelArrayIndex8(void)
+{
+    return matchesPixelArray(PIXEL_FORMAT_INDEX8, 1);
+}
+
+static int perPixelMatchesPixelArrayBGR555(void)
+{
+    return matchesPixelArray(PIXEL_FORMAT_BGR555, 1);
+}
+
+static int perPixelMatchesPixelArrayXRGB8888(void)
+{
+    return matchesPixelArray(PIXEL_FORMAT_XRGB8888, 1);
+}
+
+static int threadsMatchOneThread(void)
+{
+    /* More threads than rows in some bands, and an odd number */
+    TEST_EQ(matchesPixelArray(PIXEL_FORMAT_BGR555, 4), 0);
+    TEST_EQ(matchesPixelArray(PIXEL_FORMAT_XRGB8888, 7), 0);
+    TEST_EQ(matchesPixelArray(PIXEL_FORMAT_INDEX8, 0), 0);
+
+    return 0;
+}
+
+static int onlyPixelsOnScreenAreShaded(void)
+{
+    struct Rect rect;
+    unsigned char *pixels;
+    int count;
+    int t;
+
+    pixels = initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_INDEX8);
+    clearScreen();
+
+    count = 0;
+    InitRect(&rect, -20, -10, WIDTH + 40, HEIGHT + 20);
+    TEST_EQ(RenderPerPixel(&rect, PIXEL_FORMAT_INDEX8, offScreen, &count), 0);
+    TEST_EQ(count, 0);
+    TEST_EQ(pixels[0], COLOR_BLACK);
+
+    /* Partly off screen: the callback gets screen coordinates. */
+    SetColor(COLOR_WHITE);
+    FillScreen();
+    t = 0;
+    fillSource(t);
+    InitRect(&rect, WIDTH - 10, HEIGHT - 5, 30, 30);
+    TEST_EQ(RenderPerPixel(&rect, PIXEL_FORMAT_INDEX8, hue, &t), 0);
+    TEST_EQ(pixels[(HEIGHT - 1) * screenPitch + WIDTH - 1],
+            src[HEIGHT - 1][WIDTH - 1]);
+    TEST_EQ(pixels[(HEIGHT - 5) * screenPitch + WIDTH - 10],
+            src[HEIGHT - 5][WIDTH - 10]);
+    TEST_EQ(pixels[(HEIGHT - 6) * screenPitch + WIDTH - 10], COLOR_WHITE);
+
+    /* Entirely off screen, or inside out */
+    InitRect(&rect, WIDTH, 0, 10, 10);
+    TEST_EQ(RenderPerPixel(&rect, PIXEL_FORMAT_INDEX8, offScreen, &count), 0);
+    InitRect(&rect, 10, 10, -5, 10);
+    TEST_EQ(RenderPerPixel(&rect, PIXEL_FORMAT_INDEX8, offScreen, &count), 0);
+    TEST_EQ(count, 0);
+
+    FreeGraphics();
+
+    return 0;
+}
+
+static int replayMatchesImmediate(void)
+{
+    struct DisplayList *list;
+    struct Rect rect;
+    unsigned char *pixels;
+    unsigned char *expected;
+    int t;
+
+    pixels = initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_BGR555);
+    clearScreen();
+    t = 3;
+    InitRect(&rect, 5, 7, 60, 40);
+    RenderPerPixel(&rect, PIXEL_FORMAT_HSV8, hue, &t);
+    InitRect(&rect, 30, 20, 50, 45);
+    RenderPerRow(&rect, PIXEL_FORMAT_HSV8, hueRow, &t);
+    expected = copyScreen(pixels);
+
+    SetColor(COLOR_WHITE);
+    FillScreen();
+
+    list = NewDisplayList();
+    BeginDisplayList(list);
+    InitRect(&rect, 5, 7, 60, 40);
+    RenderPerPixel(&rect, PIXEL_FORMAT_HSV8, hue, &t);
+    InitRect(&rect, 30, 20, 50, 45);
+    RenderPerRow(&rect, PIXEL_FORMAT_HSV8, hueRow, &t);
+    EndDisplayList();
+
+    TEST_EQU(DisplayListLength(list), 2);
+    TEST_EQ(pixels[0], 0xFF);
+
+    ExecuteDisplayList(list);
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+
+    /* Tiled, the shading is drawn on its own and shares out its rows. */
+    SetColor(COLOR_WHITE);
+    FillScreen();
+    SetRenderThreads(3);
+    ExecuteDisplayList(list);
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+    SetRenderThreads(1);
+
+    FreeDisplayList(list);
+    pfree(expected);
+    FreeGraphics();
+
+    return 0;
+}
+
+static int unknownFormatIsRefused(void)
+{
+    struct Rect rect;
+    int t;
+
+    initScreen(WIDTH, HEIGHT, PIXEL_FORMAT_BGR555);
+    clearScreen();
+    t = 0;
+    InitRect(&rect, 0, 0, 10, 10);
+    TEST_NE(RenderPerPixel(&rect, PIXEL_FORMAT_HSV8 + 1, hue, &t), 0);
+    TEST_NE(RenderPerRow(&rect, -1, hueRow, &t), 0);
+
+    FreeGraphics();
+
+    return 0;
+}
+
+const test_fn tests[] =
+{
+    perPixelMatchesPixelArrayIndex8,
+    perPixelMatchesPixelArrayBGR555,
+    perPixelMatchesPixelArrayXRGB8888,
+    threadsMatchOneThread,
+    onlyPixelsOnScreenAreShaded,
+    replayMatchesImmediate,
+    unknownFormatIsRefused,
+    0
+};
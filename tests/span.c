@@ -0,0 +1,142 @@
+/*
+ *  span.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "span.h"
+#include "guikit/graphics.h"
+#include "ptest/test.h"
+#include <string.h>
+
+enum {
+    WIDTH = 40,
+    HEIGHT = 4,
+    UNTOUCHED = 0x5A
+};
+
+static u8 pixels[WIDTH * HEIGHT * 4];
+
+static void initRaster(struct Raster *r, int format)
+{
+    static const u32 colors[NUM_PIXEL_FORMATS] = {0x0C, 0x7C1F, 0xDD0806};
+
+    memset(pixels, UNTOUCHED, sizeof(pixels));
+    r->pixels = pixels;
+    r->pitch = WIDTH * bytesPerPixel(format);
+    r->format = format;
+    r->color = colors[format];
+    InitRect(&r->clip, 0, 0, WIDTH, HEIGHT);
+    r->spans = spanWriter(format);
+}
+
+static u32 getPixel(const struct Raster *r, int x, int y)
+{
+    if (r->format == PIXEL_FORMAT_INDEX8)
+    {
+        return r->pixels[y * r->pitch + x];
+    }
+    if (r->format == PIXEL_FORMAT_XRGB8888)
+    {
+        return ((const u32 *)&r->pixels[y * r->pitch])[x];
+    }
+
+    return ((const u16 *)&r->pixels[y * r->pitch])[x];
+}
+
+static u32 untouched(const struct Raster *r)
+{
+    u32 p;
+
+    p = 0;
+    memset(&p, UNTOUCHED, bytesPerPixel(r->format));
+
+    return p;
+}
+
+static int checkPattern(int format)
+{
+    struct Raster r;
+    int x;
+    int len;
+    int i;
+
+    initRaster(&r, format);
+
+    for (x = 0; x < 8; ++x)
+    {
+        for (len = 0; len <= WIDTH - 8; ++len)
+        {
+            u8 pattern = 0xA7;
+
+            memset(pixels, UNTOUCHED, sizeof(pixels));
+            r.spans->hpattern(&r, x, 1, len, pattern);
+
+            for (i = 0; i < WIDTH; ++i)
+            {
+                int inside = i >= x && i < x + len;
+                int set = pattern & (0x80 >> (i % 8));
+
+                TEST_EQ(getPixel(&r, i, 1),
+                        inside && set ? r.color : untouched(&r));
+                TEST_EQ(getPixel(&r, i, 0), untouched(&r));
+                TEST_EQ(getPixel(&r, i, 2), untouched(&r));
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int patternIsAlignedToScreen8(void)
+{
+    return checkPattern(PIXEL_FORMAT_INDEX8);
+}
+
+static int patternIsAlignedToScreen16(void)
+{
+    return checkPattern(PIXEL_FORMAT_BGR555);
+}
+
+static int patternIsAlignedToScreen32(void)
+{
+    return checkPattern(PIXEL_FORMAT_XRGB8888);
+}
+
+static int clippedSpansStayInside(void)
+{
+    struct Raster r;
+    int x;
+    int y;
+
+    initRaster(&r, PIXEL_FORMAT_INDEX8);
+    InitRect(&r.clip, 4, 1, 8, 2);
+
+    clippedSpanWriter.hline(&r, -10, 1, 100);
+    clippedSpanWriter.vline(&r, 5, -10, 100);
+    clippedSpanWriter.hpattern(&r, -3, 2, 100, 0xFF);
+    clippedSpanWriter.pixel(&r, 20, 1);
+
+    for (y = 0; y < HEIGHT; ++y)
+    {
+        for (x = 0; x < WIDTH; ++x)
+        {
+            int inside = x >= 4 && x <= 11 && y >= 1 && y <= 2;
+
+            TEST_EQ(getPixel(&r, x, y), inside ? r.color : untouched(&r));
+        }
+    }
+
+    return 0;
+}
+
+const test_fn tests[] =
+{
+    patternIsAlignedToScreen8,
+    patternIsAlignedToScreen16,
+    patternIsAlignedToScreen32,
+    clippedSpansStayInside,
+    0
+};
@@ -0,0 +1,211 @@
+/*
+ *  tiles.c
+ *  Patater GUI Kit
+ *
+ *  Created by Jaeden Amero on 2026-10-16.
+ *  Copyright 2026. SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "guikit/dlist.h"
+#include "record.h"
+#include "guikit/graphics.h"
+#include "guikit/pmemory.h"
+#include "guikit/primrect.h"
+#include "ptest/test.h"
+#include "screen.h"
+#include <stddef.h>
+#include <string.h>
+
+/* Not a multiple of the tile size, so there are partial tiles */
+enum {
+    WIDTH = 300,
+    HEIGHT = 200
+};
+
+/* A 16x2 1bpp image, with 2 glyphs 8 pixels wide */
+static const unsigned char glyphs[] = {
+    0x81, 0x3C,
+    0x7E, 0xC3
+};
+
+/* A 24x8 1bpp image, inked where bits are clear as in fonts, with a 1x8
+ * glyph in the first column, an 8x1 glyph along the top of the second byte,
+ * and an 8x8 box in the third byte */
+static const unsigned char thin[] = {
+    0x7F, 0x00, 0x00,
+    0x7F, 0xFF, 0x7E,
+    0x7F, 0xFF, 0x7E,
+    0x7F, 0xFF, 0x7E,
+    0x7F, 0xFF, 0x7E,
+    0x7F, 0xFF, 0x7E,
+    0x7F, 0xFF, 0x7E,
+    0x7F, 0xFF, 0x00
+};
+
+static const unsigned char checker[] = {
+    0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55
+};
+
+static void drawText(int y)
+{
+    struct Rect dst;
+    struct Rect src;
+    int i;
+
+    for (i = 0; i < 60; ++i)
+    {
+        InitRect(&src, (i % 2) * 8, 0, 8, 2);
+        InitRect(&dst, i * 6 - 20, y, 8, 2);
+        recordGlyph(glyphs, 16, 2, &dst, &src);
+    }
+}
+
+/* Glyphs only one pixel wide or tall, and a single pixel, crossing tile edges
+ * and mostly in tiles no wider glyph reaches, with an 8x8 glyph among them.
+ * The run starts with a thin one. */
+static void drawThinText(int y)
+{
+    static const struct Rect srcs[] = {
+        {0, 0, 0, 7}, /* 1x8 */
+        {16, 0, 23, 7}, /* 8x8 */
+        {0, 0, 0, 7},
+        {8, 0, 15, 0}, /* 8x1 */
+        {0, 0, 0, 0}, /* 1x1 */
+        {0, 0, 0, 7}
+    };
+    static const int xs[] = {60, 70, 140, 188, 270, 298};
+    static const int dys[] = {0, 0, 3, 6, 6, 2};
+    struct Rect dst;
+    size_t i;
+
+    for (i = 0; i < sizeof(xs) / sizeof(xs[0]); ++i)
+    {
+        const struct Rect *src = &srcs[i];
+
+        InitRect(&dst, xs[i], y + dys[i], src->right - src->left + 1,
+                 src->bottom - src->top + 1);
+        recordGlyph(thin, 24, 8, &dst, src);
+    }
+}
+
+/* Lots of primitives crossing tile edges, some partly off screen */
+static struct DisplayList *recordScene(void)
+{
+    struct DisplayList *list;
+    struct Rect rect;
+    struct Rect dst;
+    int i;
+
+    list = NewDisplayList();
+    BeginDisplayList(list);
+
+    SetColor(COLOR_WHITE);
+    FillScreen();
+    for (i = 0; i < 12; ++i)
+    {
+        SetColorHSV((unsigned char)(i * 20), 0xC0, 0xFF);
+        InitRect(&rect, i * 27 - 10, i * 17 - 5, 70, 45);
+        FillRect(&rect);
+        DrawLine(WIDTH - i * 31, -7, i * 29, HEIGHT + 3);
+        DrawCircle(i * 25, HEIGHT / 2, 10 + i * 3);
+    }
+
+    SetColor(COLOR_BLUE);
+    FillCircle(150, 100, 70);
+    FillRoundRect(-20, 150, 12, 100, 70);
+
+    /* More radii than are kept, some sharing a table's slot, so some get
+     * worked out while drawing tiles. */
+    for (i = 0; i < 24; ++i)
+    {
+        FillCircle(20 + i * 11, 180, i * 2 + 1);
+        FillRoundRect(i * 12, 20 + i, i, 30, 20 + i);
+    }
+    FillCircle(-390, HEIGHT / 2, 400);
+    DrawRoundRect(200, 20, 15, 90, 60);
+    DrawVertLine(64, -10, 300);
+    DrawHorizLine(-10, 127, 400);
+    DrawDiagLine(250, 0, 0, 180);
+    DrawDiagLine(10, 10, 200, 250);
+
+    /* An inside out rect can't be binned. */
+    InitRect(&rect, 50, 50, -20, 30);
+    DrawRect(&rect);
+
+    SetColor(COLOR_BLACK);
+    drawText(60);
+    drawThinText(58);
+
+    /* Blits are drawn on their own, after everything before them. */
+    InitRect(&rect, 0, 0, 16, 2);
+    InitRect(&dst, 130, 61, 16, 2);
+    BlitOp(glyphs, OP_SRC_INV, &dst, &rect, 16);
+
+    SetColor(COLOR_RED);
+    InitRect(&rect, 40, 30, 200, 100);
+    FillRectOp(checker, OP_PAT_XOR, &rect);
+    DrawRect(&rect);
+    drawText(128);
+    SetColorRGB(0x20, 0x90, 0x40);
+    drawText(190);
+    drawThinText(124);
+
+    EndDisplayList();
+
+    return list;
+}
+
+static int tiledMatchesSerial(int format)
+{
+    struct DisplayList *list;
+    unsigned char *pixels;
+    unsigned char *expected;
+
+    pixels = initScreen(WIDTH, HEIGHT, format);
+    list = recordScene();
+
+    SetRenderThreads(1);
+    ExecuteDisplayList(list);
+    expected = copyScreen(pixels);
+
+    memset(pixels, 0, screenSize);
+    SetRenderThreads(4);
+    ExecuteDisplayList(list);
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+
+    /* More threads than tiles in a row, and an odd number */
+    memset(pixels, 0, screenSize);
+    SetRenderThreads(7);
+    ExecuteDisplayList(list);
+    TEST_EQ(memcmp(pixels, expected, screenSize), 0);
+
+    SetRenderThreads(1);
+    FreeDisplayList(list);
+    pfree(expected);
+    FreeGraphics();
+
+    return 0;
+}
+
+static int tiledMatchesSerialIndex8(void)
+{
+    return tiledMatchesSerial(PIXEL_FORMAT_INDEX8);
+}
+
+static int tiledMatchesSerialBGR555(void)
+{
+    return tiledMatchesSerial(PIXEL_FORMAT_BGR555);
+}
+
+static int tiledMatchesSerialXRGB8888(void)
+{
+    return tiledMatchesSerial(PIXEL_FORMAT_XRGB8888);
+}
+
+const test_fn tests[] =
+{
+    tiledMatchesSerialIndex8,
+    tiledMatchesSerialBGR555,
+    tiledMatchesSerialXRGB8888,
+    0
+};